@@ -0,0 +1,247 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*memory-budgeted store of vertex buffers, with LRU spill to a file and compression of cold buffers*/
+/*used by provenance.c (4, 101)*/
+/*a buffer keeps its slot in the spill file while it fits, and moves to a larger slot at the end of the file otherwise*/
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include "bufstore.h"
+
+int bsInit(struct BufStore *b, int numnodes, long long budget, const char *dir)
+{
+	char path[4096];
+	int i;
+
+	memset(b,0,sizeof(struct BufStore));
+	b->fd = -1;
+	if (budget>0) {
+		snprintf(path,sizeof(path),"%s/provspill_XXXXXX",dir!=NULL ? dir : ".");
+		b->fd = mkstemp(path);
+		if (b->fd==-1) {
+			printf("ERROR: cannot create spill file in %s\n",dir!=NULL ? dir : ".");
+			return -1;
+		}
+		unlink(path); // the file is removed when it is closed
+	}
+	b->numnodes = numnodes;
+	b->budget = budget>0 ? budget : LLONG_MAX;
+	b->bytes = (long long *)calloc(numnodes,sizeof(long long));
+	b->prev = (int *)malloc(numnodes*sizeof(int));
+	b->next = (int *)malloc(numnodes*sizeof(int));
+	b->state = (char *)calloc(numnodes,sizeof(char));
+	b->stamp = (long long *)calloc(numnodes,sizeof(long long));
+	b->off = (long long *)malloc(numnodes*sizeof(long long));
+	b->slot = (long long *)calloc(numnodes,sizeof(long long));
+	b->packed = (unsigned char **)calloc(numnodes,sizeof(unsigned char *));
+	b->packedlen = (int *)calloc(numnodes,sizeof(int));
+	for(i=0;i<numnodes;i++)
+		b->off[i] = -1;
+	b->head = b->tail = -1;
+	return 0;
+}
+
+void bsGrow(struct BufStore *b, int numnodes)
+{
+	int i;
+
+	b->bytes = (long long *)realloc(b->bytes,numnodes*sizeof(long long));
+	b->prev = (int *)realloc(b->prev,numnodes*sizeof(int));
+	b->next = (int *)realloc(b->next,numnodes*sizeof(int));
+	b->state = (char *)realloc(b->state,numnodes*sizeof(char));
+	b->stamp = (long long *)realloc(b->stamp,numnodes*sizeof(long long));
+	b->off = (long long *)realloc(b->off,numnodes*sizeof(long long));
+	b->slot = (long long *)realloc(b->slot,numnodes*sizeof(long long));
+	b->packed = (unsigned char **)realloc(b->packed,numnodes*sizeof(unsigned char *));
+	b->packedlen = (int *)realloc(b->packedlen,numnodes*sizeof(int));
+	for(i=b->numnodes;i<numnodes;i++) {
+		b->bytes[i] = 0;
+		b->state[i] = BS_RESIDENT;
+		b->stamp[i] = 0;
+		b->off[i] = -1;
+		b->slot[i] = 0;
+		b->packed[i] = NULL;
+		b->packedlen[i] = 0;
+	}
+	b->numnodes = numnodes;
+}
+
+// removes vertex v from the list
+static void bsUnlink(struct BufStore *b, int v)
+{
+	if (b->prev[v]!=-1)
+		b->next[b->prev[v]] = b->next[v];
+	else
+		b->head = b->next[v];
+	if (b->next[v]!=-1)
+		b->prev[b->next[v]] = b->prev[v];
+	else
+		b->tail = b->prev[v];
+	b->used -= b->bytes[v];
+	b->bytes[v] = 0;
+}
+
+void bsTouch(struct BufStore *b, int v, long long bytes)
+{
+	if (bytes<1)
+		bytes = 1; // so that the vertices in the list have bytes
+	b->stamp[v] = b->clock;
+	if (b->bytes[v]>0) {
+		if (b->head==v) {
+			b->used += bytes-b->bytes[v];
+			b->bytes[v] = bytes;
+			return;
+		}
+		bsUnlink(b,v);
+	}
+	b->prev[v] = -1;
+	b->next[v] = b->head;
+	if (b->head!=-1)
+		b->prev[b->head] = v;
+	b->head = v;
+	if (b->tail==-1)
+		b->tail = v;
+	b->bytes[v] = bytes;
+	b->used += bytes;
+}
+
+int bsVictim(struct BufStore *b, int pin1, int pin2)
+{
+	int v;
+
+	if (b->used<=b->budget) {
+		if (b->used>b->maxused)
+			b->maxused = b->used;
+		return -1;
+	}
+	for(v=b->tail;v!=-1 && (v==pin1 || v==pin2);v=b->prev[v]);
+	return v;
+}
+
+int bsCold(struct BufStore *b, long long coldafter)
+{
+	if (b->tail==-1 || b->clock-b->stamp[b->tail]<coldafter)
+		return -1;
+	return b->tail;
+}
+
+// frees the slot of vertex v for the buffers of its class
+static void bsRelease(struct BufStore *b, int v)
+{
+	int c;
+
+	if (b->off[v]==-1)
+		return;
+	for(c=0;((long long)BS_MINSLOT<<c)<b->slot[v];c++);
+	if (b->numfree[c]==b->freecapacity[c]) {
+		b->freecapacity[c] = b->freecapacity[c]>0 ? 2*b->freecapacity[c] : 16;
+		b->freeslot[c] = (long long *)realloc(b->freeslot[c],b->freecapacity[c]*sizeof(long long));
+	}
+	b->freeslot[c][b->numfree[c]++] = b->off[v];
+	b->off[v] = -1;
+	b->slot[v] = 0;
+}
+
+int bsSpill(struct BufStore *b, int v, const void *p1, long long n1, const void *p2, long long n2)
+{
+	long long n = n1+n2;
+	int c;
+
+	if (n>b->slot[v]) {
+		for(c=0;((long long)BS_MINSLOT<<c)<n;c++);
+		if (c>=BS_NUMCLASSES) {
+			printf("ERROR: buffer of %lld bytes too large for the spill file\n",n);
+			return -1;
+		}
+		bsRelease(b,v);
+		b->slot[v] = (long long)BS_MINSLOT<<c;
+		if (b->numfree[c]>0)
+			b->off[v] = b->freeslot[c][--b->numfree[c]];
+		else {
+			b->off[v] = b->filesize;
+			b->filesize += b->slot[v];
+		}
+	}
+	if ((n1>0 && pwrite(b->fd,p1,n1,b->off[v])!=n1) || (n2>0 && pwrite(b->fd,p2,n2,b->off[v]+n1)!=n2)) {
+		printf("ERROR: cannot write to the spill file\n");
+		return -1;
+	}
+	if (b->bytes[v]>0)
+		bsUnlink(b,v);
+	b->state[v] = BS_SPILLED;
+	b->numspills++;
+	return 0;
+}
+
+int bsLoad(struct BufStore *b, int v, void *p, long long n)
+{
+	if (n>0 && pread(b->fd,p,n,b->off[v])!=n) {
+		printf("ERROR: cannot read from the spill file\n");
+		return -1;
+	}
+	bsRelease(b,v); // the buffer takes a slot again when it is next spilled
+	b->state[v] = BS_RESIDENT;
+	b->numloads++;
+	return 0;
+}
+
+unsigned char *bsScratch(struct BufStore *b, long long n)
+{
+	if (n>b->scratchsize) {
+		b->scratchsize = 2*n;
+		b->scratch = (unsigned char *)realloc(b->scratch,b->scratchsize);
+	}
+	return b->scratch;
+}
+
+void bsPack(struct BufStore *b, int v, int len, long long raw)
+{
+	b->packed[v] = NULL;
+	if (len>0) {
+		b->packed[v] = (unsigned char *)malloc(len);
+		memcpy(b->packed[v],b->scratch,len);
+	}
+	b->packedlen[v] = len;
+	b->packedbytes += len;
+	b->rawbytes += raw;
+	if (b->bytes[v]>0)
+		bsUnlink(b,v);
+	b->state[v] = BS_PACKED;
+	b->numpacks++;
+}
+
+void bsUnpack(struct BufStore *b, int v, long long raw)
+{
+	free(b->packed[v]);
+	b->packed[v] = NULL;
+	b->packedbytes -= b->packedlen[v];
+	b->rawbytes -= raw;
+	b->packedlen[v] = 0;
+	b->state[v] = BS_RESIDENT;
+	b->numunpacks++;
+}
+
+void bsFree(struct BufStore *b)
+{
+	int i;
+
+	if (b->bytes==NULL)
+		return;
+	if (b->fd!=-1)
+		close(b->fd);
+	for(i=0;i<b->numnodes;i++)
+		free(b->packed[i]);
+	free(b->bytes);
+	free(b->prev);
+	free(b->next);
+	free(b->state);
+	free(b->stamp);
+	free(b->off);
+	free(b->slot);
+	for(i=0;i<BS_NUMCLASSES;i++)
+		free(b->freeslot[i]);
+	free(b->packed);
+	free(b->packedlen);
+	free(b->scratch);
+	memset(b,0,sizeof(struct BufStore));
+}
@@ -0,0 +1,112 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __BUFSTORE
+#define __BUFSTORE
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BS_MINSLOT 64 // smallest slot of a buffer in the spill file (bytes)
+#define BS_NUMCLASSES 48 // slots of class c have BS_MINSLOT<<c bytes
+
+// where the buffer of a vertex is
+#define BS_RESIDENT 0
+#define BS_SPILLED 1 // in the spill file
+#define BS_PACKED 2 // compressed in memory
+
+// memory-budgeted store of the buffers of the vertices
+// the buffers in use are resident and kept in a list in order of last use; when they exceed the budget,
+// the least recently used ones are spilled to a file and reloaded on their next use
+// buffers that have not been used for a number of interactions can instead be kept compressed in memory
+// the store only keeps the bytes: the buffers themselves are allocated, encoded and freed by the engine (see provenance.c)
+struct BufStore {
+	int numnodes;
+	long long budget; // bytes of resident buffers (LLONG_MAX: no budget)
+	long long used; // bytes of the buffers in the list
+	long long *bytes; // bytes of the buffer of each vertex in the list, 0 if not in it
+	int *prev, *next; // list of the resident buffers, from head (most recently used) to tail; -1 ends it
+	int head, tail;
+	char *state; // where the buffer of each vertex is (BS_RESIDENT, BS_SPILLED, BS_PACKED)
+	long long clock; // number of interactions processed, advanced by the engine
+	long long *stamp; // clock at the last use of each vertex
+	int fd; // spill file, removed as soon as it is created; -1 without a budget
+	long long *off; // position of the slot of each spilled buffer in the spill file, -1 if it has none
+	long long *slot; // size of the slot
+	long long *freeslot[BS_NUMCLASSES]; // positions of the slots of each class that no vertex has
+	int numfree[BS_NUMCLASSES], freecapacity[BS_NUMCLASSES];
+	long long filesize;
+	long long numspills, numloads;
+	long long maxused; // largest number of bytes of the resident buffers after a spill
+	unsigned char **packed; // compressed buffer of each vertex in state BS_PACKED (NULL if it is empty)
+	int *packedlen;
+	long long packedbytes; // bytes of the compressed buffers
+	long long rawbytes; // bytes of the items of the same buffers, uncompressed
+	long long numpacks, numunpacks;
+	unsigned char *scratch; // space where the engine encodes a buffer (see bsScratch)
+	long long scratchsize;
+};
+
+// creates a store for numnodes vertices with a spill file in directory dir (NULL: current directory)
+// budget<=0: no budget and no spill file
+int bsInit(struct BufStore *b, int numnodes, long long budget, const char *dir);
+// adds vertices up to numnodes-1, whose buffers are resident and not in the list
+void bsGrow(struct BufStore *b, int numnodes);
+// marks the resident buffer of vertex v, of bytes bytes, as the most recently used at the current clock
+void bsTouch(struct BufStore *b, int v, long long bytes);
+// returns the least recently used vertex if it has not been used for coldafter interactions, or -1
+int bsCold(struct BufStore *b, long long coldafter);
+// returns the least recently used vertex other than pin1 and pin2 if the resident buffers exceed the budget, or -1
+int bsVictim(struct BufStore *b, int pin1, int pin2);
+// writes the buffer of vertex v, n1 bytes at p1 followed by n2 bytes at p2, to the spill file
+// and removes v from the list; returns 0 or -1
+// the buffer takes a slot of the smallest class that fits it, reusing a free slot of that class if there is one,
+// so the file never holds more than the largest total size the slots of each class have had at the same time
+int bsSpill(struct BufStore *b, int v, const void *p1, long long n1, const void *p2, long long n2);
+// reads the n bytes of the spilled buffer of vertex v into p and frees its slot; returns 0 or -1
+int bsLoad(struct BufStore *b, int v, void *p, long long n);
+// returns space for n bytes, where a buffer is encoded before bsPack
+unsigned char *bsScratch(struct BufStore *b, long long n);
+// keeps the first len bytes of the scratch space as the compressed buffer of vertex v, of raw bytes of items,
+// and removes v from the list
+void bsPack(struct BufStore *b, int v, int len, long long raw);
+// frees the compressed buffer of vertex v, once the engine has decoded it
+void bsUnpack(struct BufStore *b, int v, long long raw);
+// writes x as a varint (7 bits per byte, least significant first) at p; returns the number of bytes
+static inline int bsPutVarint(unsigned char *p, unsigned long long x)
+{
+	int n = 0;
+
+	while (x>=0x80) {
+		p[n++] = (unsigned char)(x|0x80);
+		x >>= 7;
+	}
+	p[n++] = (unsigned char)x;
+	return n;
+}
+// reads a varint at *p and moves *p past it
+static inline unsigned long long bsGetVarint(const unsigned char **p)
+{
+	unsigned long long x = 0;
+	int shift = 0;
+
+	while (**p&0x80) {
+		x |= (unsigned long long)(**p&0x7f)<<shift;
+		shift += 7;
+		(*p)++;
+	}
+	x |= (unsigned long long)**p<<shift;
+	(*p)++;
+	return x;
+}
+// zigzag mapping of signed values to varints, so that small negative values take few bytes
+static inline unsigned long long bsZigzag(long long x)
+{
+	return ((unsigned long long)x<<1)^(unsigned long long)(x>>63);
+}
+static inline long long bsUnzigzag(unsigned long long x)
+{
+	return (long long)(x>>1)^-(long long)(x&1);
+}
+void bsFree(struct BufStore *b);
+
+#endif // __BUFSTORE
@@ -0,0 +1,364 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*external merge sort of graph files by timestamp*/
+/*used by provsort.c*/
+/*runs hold the interactions in the form of the input (text lines or binary records), without a header*/
+#include <string.h>
+#include <unistd.h>
+#include "extsort.h"
+#include "threadpool.h"
+
+// interaction of a chunk: its timestamp and its bytes (offset and length) in the data of the chunk
+struct ExsItem {
+	double ts;
+	long long off;
+	int len;
+};
+
+// chunk of the input, sorted into a run by a thread
+struct ExsChunk {
+	char *data;
+	long long datalen;
+	long long datacap;
+	struct ExsItem *items;
+	int numitems;
+	int itemcap;
+	int run; // id of its run
+	int ret;
+};
+
+// state of a sort
+struct ExsSort {
+	struct ExsChunk *chunks;
+	int binary; // form of the input and of the runs
+	const char *tmpdir;
+	long long memory;
+	int numruns; // ids of the runs written so far
+	int numpasses;
+};
+
+// run being merged
+struct ExsRun {
+	FILE *f;
+	char *buf; // read buffer of f
+	char *line; // current line (text)
+	size_t len;
+	ssize_t linelen;
+	struct GraphRecord rec; // current interaction
+	int id;
+};
+
+static void exsRunName(struct ExsSort *es, int id, char *path, int size)
+{
+	snprintf(path,size,"%s/provsort_%d_%d.run",es->tmpdir,(int)getpid(),id);
+}
+
+static int cmpexsitem(const void *i1, const void *i2)
+{
+	struct ExsItem *a = (struct ExsItem *)i1;
+	struct ExsItem *b = (struct ExsItem *)i2;
+
+	if (a->ts!=b->ts)
+		return a->ts<b->ts ? -1 : 1;
+	return a->off<b->off ? -1 : (a->off>b->off); // input order
+}
+
+// sorts chunk t and writes it to its run
+static void exsRunTask(void *arg, int t)
+{
+	struct ExsSort *es = (struct ExsSort *)arg;
+	struct ExsChunk *c = &es->chunks[t];
+	char path[4096];
+	FILE *f;
+	int i;
+
+	qsort(c->items,c->numitems,sizeof(struct ExsItem),cmpexsitem);
+	exsRunName(es,c->run,path,sizeof(path));
+	f = fopen(path,"wb");
+	if (f==NULL) {
+		printf("ERROR: cannot create run %s\n",path);
+		c->ret = -1;
+		return;
+	}
+	for(i=0;i<c->numitems;i++)
+		fwrite(c->data+c->items[i].off,1,c->items[i].len,f);
+	if (fclose(f)!=0) {
+		printf("ERROR: cannot write run %s\n",path);
+		c->ret = -1;
+	}
+}
+
+// appends the bytes of the current interaction of r to chunk c
+static void exsAdd(struct ExsChunk *c, struct GraphReader *r, const struct GraphRecord *rec)
+{
+	const char *bytes = r->binary ? (const char *)rec : r->line;
+	int len = r->binary ? (int)sizeof(struct GraphRecord) : r->linelen;
+	int newline = !r->binary && (len==0 || bytes[len-1]!='\n'); // the last line may have none
+
+	if (c->datalen+len+newline > c->datacap) {
+		c->datacap = 2*(c->datalen+len+newline);
+		c->data = (char *)realloc(c->data,c->datacap);
+	}
+	if (c->numitems==c->itemcap) {
+		c->itemcap = c->itemcap>0 ? 2*c->itemcap : 1024;
+		c->items = (struct ExsItem *)realloc(c->items,c->itemcap*sizeof(struct ExsItem));
+	}
+	c->items[c->numitems].ts = rec->ts;
+	c->items[c->numitems].off = c->datalen;
+	c->items[c->numitems].len = len+newline;
+	c->numitems++;
+	memcpy(c->data+c->datalen,bytes,len);
+	c->datalen += len;
+	if (newline)
+		c->data[c->datalen++] = '\n';
+}
+
+// reads the next interaction of run r; returns 0, 1 at its end, or -1 on a malformed line
+static int exsNext(struct ExsRun *r, int binary)
+{
+	if (binary)
+		return fread(&r->rec,sizeof(struct GraphRecord),1,r->f)==1 ? 0 : 1;
+	if ((r->linelen = getline(&r->line,&r->len,r->f))==-1)
+		return 1;
+	return grParseLine(r->line,&r->rec)==-1 ? -1 : 0;
+}
+
+// returns 1 if the current interaction of run a goes before the one of run b
+static inline int exsBefore(const struct ExsRun *a, const struct ExsRun *b)
+{
+	if (a->rec.ts!=b->rec.ts)
+		return a->rec.ts<b->rec.ts;
+	return a->id<b->id;
+}
+
+// moves down heap element pos of the heap of runs
+static void exsSiftDown(struct ExsRun **heap, int n, int pos)
+{
+	struct ExsRun *tmp;
+	int c;
+
+	while ((c = 2*pos+1) < n) {
+		if (c+1<n && exsBefore(heap[c+1],heap[c]))
+			c++;
+		if (!exsBefore(heap[c],heap[pos]))
+			break;
+		tmp = heap[c];
+		heap[c] = heap[pos];
+		heap[pos] = tmp;
+		pos = c;
+	}
+}
+
+// merges the num runs of ids ids[0..num-1] (in input order) into out, in form outbinary, and removes them
+// returns the number of interactions written, or -1
+static long long exsMerge(struct ExsSort *es, const int *ids, int num, FILE *out, int outbinary)
+{
+	struct ExsRun *runs;
+	struct ExsRun **heap;
+	char path[4096];
+	long long bufsize, count = 0;
+	int i, n = 0, ret, err = 0;
+
+	bufsize = es->memory/(num+1);
+	if (bufsize<EXS_MINBUF)
+		bufsize = EXS_MINBUF;
+	if (bufsize>EXS_MAXBUF)
+		bufsize = EXS_MAXBUF;
+	runs = (struct ExsRun *)calloc(num,sizeof(struct ExsRun));
+	heap = (struct ExsRun **)malloc(num*sizeof(struct ExsRun *));
+	for(i=0;i<num && !err;i++) {
+		runs[i].id = ids[i];
+		exsRunName(es,ids[i],path,sizeof(path));
+		runs[i].f = fopen(path,"rb");
+		if (runs[i].f==NULL) {
+			printf("ERROR: cannot open run %s\n",path);
+			err = 1;
+			break;
+		}
+		runs[i].buf = (char *)malloc(bufsize);
+		setvbuf(runs[i].f,runs[i].buf,_IOFBF,bufsize);
+		ret = exsNext(&runs[i],es->binary);
+		if (ret==-1) {
+			printf("ERROR: run %d is corrupt\n",ids[i]);
+			err = 1;
+		}
+		else if (ret==0)
+			heap[n++] = &runs[i];
+	}
+	for(i=n/2-1;i>=0;i--)
+		exsSiftDown(heap,n,i);
+
+	while (n>0 && !err) {
+		if (outbinary==es->binary && !es->binary)
+			fwrite(heap[0]->line,1,heap[0]->linelen,out);
+		else
+			grWriteRecord(out,outbinary,&heap[0]->rec);
+		count++;
+		ret = exsNext(heap[0],es->binary);
+		if (ret==-1) {
+			printf("ERROR: run %d is corrupt\n",heap[0]->id);
+			err = 1;
+		}
+		else if (ret==1)
+			heap[0] = heap[--n];
+		exsSiftDown(heap,n,0);
+	}
+
+	for(i=0;i<num;i++) {
+		if (runs[i].f!=NULL)
+			fclose(runs[i].f);
+		free(runs[i].buf);
+		free(runs[i].line);
+		exsRunName(es,ids[i],path,sizeof(path));
+		remove(path);
+	}
+	free(runs);
+	free(heap);
+	return err ? -1 : count;
+}
+
+int exsSort(const char *input, const char *output, int binary, long long memory, int numthreads, const char *tmpdir)
+{
+	struct ExsSort es;
+	struct GraphReader r;
+	struct GraphRecord rec;
+	FILE *f, *out;
+	char *outbuf;
+	int *ids, *newids;
+	int i, t, k, num, numchunks, numids, ret = 0, err = 0;
+	long long chunksize, count = 0, written;
+	char path[4096];
+
+	if (numthreads<1)
+		numthreads = 1;
+	f = strcmp(input,"-") ? fopen(input,"rb") : stdin;
+	if (f==NULL) {
+		printf("ERROR: cannot open graph file %s\n",input);
+		return -1;
+	}
+	if (grOpen(&r,f)==-1) {
+		if (f!=stdin)
+			fclose(f);
+		return -1;
+	}
+	if (binary==-1)
+		binary = r.binary;
+
+	memset(&es,0,sizeof(es));
+	es.binary = r.binary;
+	es.tmpdir = tmpdir;
+	es.memory = memory;
+	es.chunks = (struct ExsChunk *)calloc(numthreads,sizeof(struct ExsChunk));
+	chunksize = memory/numthreads;
+	if (chunksize<EXS_MINCHUNK)
+		chunksize = EXS_MINCHUNK;
+	for(t=0;t<numthreads;t++) {
+		es.chunks[t].datacap = chunksize;
+		es.chunks[t].data = (char *)malloc(chunksize);
+	}
+
+	// run generation: numthreads chunks are read, then sorted and written in parallel
+	while (ret==0 && !err) {
+		numchunks = 0;
+		while (numchunks<numthreads) {
+			struct ExsChunk *c = &es.chunks[numchunks];
+			c->datalen = 0;
+			c->numitems = 0;
+			c->ret = 0;
+			while (c->datalen+(long long)(c->numitems*sizeof(struct ExsItem)) < chunksize && (ret = grNextRecord(&r,&rec))==0)
+				exsAdd(c,&r,&rec);
+			if (c->numitems>0) {
+				c->run = es.numruns++;
+				count += c->numitems;
+				numchunks++;
+			}
+			if (ret!=0)
+				break;
+		}
+		if (ret==-1)
+			err = 1;
+		if (numchunks>0 && !err) {
+			poolRun(numthreads, numchunks, exsRunTask, &es, NULL, 0);
+			for(t=0;t<numchunks;t++)
+				if (es.chunks[t].ret==-1)
+					err = 1;
+		}
+	}
+	if (!err)
+		printf("provsort: %lld interactions sorted into %d runs\n",count,es.numruns);
+	for(t=0;t<numthreads;t++) {
+		free(es.chunks[t].data);
+		free(es.chunks[t].items);
+	}
+	free(es.chunks);
+	grClose(&r);
+	if (f!=stdin)
+		fclose(f);
+	if (!err && count>0x7fffffff) {
+		printf("ERROR: graph files hold at most %d interactions\n",0x7fffffff);
+		err = 1;
+	}
+
+	// merge passes, until at most EXS_FANIN runs are left
+	numids = es.numruns;
+	ids = (int *)malloc((numids+1)*sizeof(int));
+	for(i=0;i<numids;i++)
+		ids[i] = i;
+	while (numids>EXS_FANIN && !err) {
+		newids = (int *)malloc((numids/EXS_FANIN+2)*sizeof(int));
+		num = 0;
+		for(i=0;i<numids && !err;i+=EXS_FANIN) {
+			k = numids-i<EXS_FANIN ? numids-i : EXS_FANIN;
+			newids[num] = es.numruns++;
+			exsRunName(&es,newids[num],path,sizeof(path));
+			out = fopen(path,"wb");
+			if (out==NULL) {
+				printf("ERROR: cannot create run %s\n",path);
+				err = 1;
+				break;
+			}
+			if (exsMerge(&es,ids+i,k,out,es.binary)==-1)
+				err = 1;
+			if (fclose(out)!=0)
+				err = 1;
+			num++;
+		}
+		free(ids);
+		ids = newids;
+		numids = num;
+		es.numpasses++;
+	}
+
+	// final merge, into the output file
+	if (!err) {
+		out = fopen(output,"wb");
+		if (out==NULL) {
+			printf("ERROR: cannot create graph file %s\n",output);
+			err = 1;
+		}
+		else {
+			outbuf = (char *)malloc(EXS_MAXBUF);
+			setvbuf(out,outbuf,_IOFBF,EXS_MAXBUF);
+			grWriteHeader(out,binary,r.numnodes,(int)count);
+			written = exsMerge(&es,ids,numids,out,binary);
+			if (written!=count)
+				err = 1;
+			if (fclose(out)!=0) {
+				printf("ERROR: cannot write graph file %s\n",output);
+				err = 1;
+			}
+			free(outbuf);
+			es.numpasses++;
+		}
+	}
+	if (err) // runs that are left
+		for(i=0;i<es.numruns;i++) {
+			exsRunName(&es,i,path,sizeof(path));
+			remove(path);
+		}
+	free(ids);
+	if (err)
+		return -1;
+	printf("provsort: %d merge passes\n",es.numpasses);
+	return 0;
+}
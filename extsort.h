@@ -0,0 +1,23 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __EXTSORT
+#define __EXTSORT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "graphio.h"
+
+#define EXS_MEMORY 256 // default memory budget (MB)
+#define EXS_MINCHUNK 1048576 // smallest input chunk sorted into a run (bytes)
+#define EXS_FANIN 64 // largest number of runs merged at a time
+#define EXS_MINBUF 65536 // smallest and largest read buffer of a run during a merge (bytes)
+#define EXS_MAXBUF 16777216
+
+// sorts graph file input (text or binary, see graphio.h) by timestamp into graph file output,
+// keeping about memory bytes of interactions in memory: chunks of the input are sorted by numthreads threads
+// at a time into runs, written to directory tmpdir, and the runs are merged EXS_FANIN at a time
+// the sort is stable (equal timestamps keep their order), and text lines are copied as they are to a text output
+// binary: 1 for a binary output, 0 for a text one, -1 for the form of the input; returns 0 or -1
+int exsSort(const char *input, const char *output, int binary, long long memory, int numthreads, const char *tmpdir);
+
+#endif // __EXTSORT
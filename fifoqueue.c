@@ -44,7 +44,7 @@ int fifodequeue(struct BufItem *el, struct BufItem *queue, int *num_elems, int *
     return 1;
 }
 
-void print_queue(struct BufItem *queue, int num_elems, int first, int last, int capacity) 
+void fifoprint(struct BufItem *queue, int num_elems, int first, int last, int capacity) 
 {
   int i, inext;
 
@@ -53,14 +53,14 @@ void print_queue(struct BufItem *queue, int num_elems, int first, int last, int
   	printf("<empty>\n");
   else {
   	while (num_elems) {
-  		printf("%d %.2f %.2f\n", queue[last].origin, queue[last].ts, queue[last].qty);
+  		printf("%d %.2f %.2f\n", queue[last].origin, queue[last].ts, (double)queue[last].qty);
   		last = (last+1)%capacity;
 	  	num_elems--;
   	}
   }
 }
 
-double sum_fifoelems(struct BufItem *queue, int num_elems, int last, int capacity)
+double fifosum(struct BufItem *queue, int num_elems, int last, int capacity)
 {
 	double s = 0;
 	while (num_elems) {
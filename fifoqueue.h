@@ -9,7 +9,7 @@
 
 void fifoenqueue(struct BufItem newitem, struct BufItem **queue, int *num_elems, int *first, int *last, int *capacity);
 int fifodequeue(struct BufItem *el, struct BufItem *queue, int *num_elems, int *last, int capacity);
-void print_queue(struct BufItem *queue, int num_elems, int first, int last, int capacity);
-double sum_fifoelems(struct BufItem *queue, int num_elems, int last, int capacity);
+void fifoprint(struct BufItem *queue, int num_elems, int first, int last, int capacity);
+double fifosum(struct BufItem *queue, int num_elems, int last, int capacity);
 
 #endif // __FIFOQUEUE
@@ -0,0 +1,136 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*reading and writing of graph files, in text or binary form*/
+/*used by provenance_tin.c and extsort.c*/
+#include <string.h>
+#include "graphio.h"
+
+int grOpen(struct GraphReader *r, FILE *f)
+{
+	char magic[4];
+	int version, c;
+
+	memset(r,0,sizeof(struct GraphReader));
+	r->f = f;
+	c = getc(f);
+	if (c==EOF) {
+		printf("ERROR: first line is empty. Exiting...\n");
+		return -1;
+	}
+	ungetc(c,f);
+	if (c==GRAPH_MAGIC[0]) {
+		r->binary = 1;
+		if (fread(magic,1,4,f)!=4 || memcmp(magic,GRAPH_MAGIC,4) || fread(&version,sizeof(int),1,f)!=1 || version!=GRAPH_VERSION
+			|| fread(&r->numnodes,sizeof(int),1,f)!=1 || fread(&r->numinter,sizeof(int),1,f)!=1) {
+			printf("ERROR: graph file is neither a text nor a binary graph (version %d)\n",GRAPH_VERSION);
+			return -1;
+		}
+		return 0;
+	}
+
+	/* first line should be <numnodes> */
+	if (getline(&r->line,&r->len,f)==-1) {
+		printf("ERROR: first line is empty. Exiting...\n");
+		return -1;
+	}
+	r->numnodes = atoi(r->line);
+	/* second line should be <numinter> */
+	if (getline(&r->line,&r->len,f)==-1) {
+		printf("ERROR: second line is empty. Exiting...\n");
+		return -1;
+	}
+	r->numinter = atoi(r->line);
+	r->lineno = 2;
+	return 0;
+}
+
+int grParseLine(const char *line, struct GraphRecord *rec)
+{
+	char *end;
+
+	rec->src = strtol(line,&end,10);
+	if (end==line)
+		return -1;
+	line = end;
+	rec->dest = strtol(line,&end,10);
+	if (end==line)
+		return -1;
+	line = end;
+	rec->ts = strtod(line,&end);
+	if (end==line)
+		return -1;
+	line = end;
+	rec->qty = strtod(line,&end);
+	if (end==line)
+		return -1;
+	return 0;
+}
+
+int grNextRecord(struct GraphReader *r, struct GraphRecord *rec)
+{
+	if (r->binary) {
+		if (fread(rec,sizeof(struct GraphRecord),1,r->f)!=1)
+			return 1;
+		r->lineno++;
+	}
+	else {
+		do {
+			if ((r->linelen = getline(&r->line,&r->len,r->f))==-1)
+				return 1;
+			r->lineno++;
+		} while (r->line[0]=='\n' || r->line[0]=='\r'); // empty lines are skipped
+		if (grParseLine(r->line,rec)==-1) {
+			printf("ERROR: line %lld should be <source> <dest> <timestamp> <quantity>\n",r->lineno);
+			return -1;
+		}
+	}
+	if (rec->src<0 || rec->src>=r->numnodes || rec->dest<0 || rec->dest>=r->numnodes) {
+		printf("ERROR: %s %lld: vertices should be in 0..%d\n",r->binary ? "interaction" : "line",r->lineno,r->numnodes-1);
+		return -1;
+	}
+	return 0;
+}
+
+int grNext(struct GraphReader *r, struct Interaction *x)
+{
+	struct GraphRecord rec;
+	int ret;
+
+	if ((ret = grNextRecord(r,&rec))!=0)
+		return ret;
+	x->src = rec.src;
+	x->dest = rec.dest;
+	x->ts = rec.ts;
+	x->qty = qtyround(rec.qty); // rounded with integer quantities (PROV_INTQTY)
+	return 0;
+}
+
+void grClose(struct GraphReader *r)
+{
+	free(r->line);
+	r->line = NULL;
+	r->len = 0;
+}
+
+void grWriteHeader(FILE *f, int binary, int numnodes, int numinter)
+{
+	int version = GRAPH_VERSION;
+
+	if (binary) {
+		fwrite(GRAPH_MAGIC,1,4,f);
+		fwrite(&version,sizeof(int),1,f);
+		fwrite(&numnodes,sizeof(int),1,f);
+		fwrite(&numinter,sizeof(int),1,f);
+	}
+	else
+		fprintf(f,"%d\n%d\n",numnodes,numinter);
+}
+
+// text records are written with 17 significant digits, so that they are read back exactly
+void grWriteRecord(FILE *f, int binary, const struct GraphRecord *rec)
+{
+	if (binary)
+		fwrite(rec,sizeof(struct GraphRecord),1,f);
+	else
+		fprintf(f,"%d\t%d\t%.17g\t%.17g\n",rec->src,rec->dest,rec->ts,rec->qty);
+}
@@ -0,0 +1,51 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __GRAPHIO
+#define __GRAPHIO
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include "provenance.h" // to obtain struct Interaction definition
+
+#define GRAPH_MAGIC "PTGR" // first bytes of a binary graph file
+#define GRAPH_VERSION 1
+
+// interaction of a binary graph file
+// a binary graph file is GRAPH_MAGIC, int version, int number of vertices, int number of interactions,
+// then a record per interaction; a text graph file is <numnodes>, <numinter>, then a line per interaction
+// <source> <dest> <timestamp> <quantity>, tab-separated
+struct GraphRecord {
+	int src;
+	int dest;
+	double ts;
+	double qty;
+};
+
+// reader of a graph file, in text or binary form
+struct GraphReader {
+	FILE *f;
+	int binary;
+	int numnodes;
+	int numinter; // number of interactions stated in the header
+	char *line; // last line read (text)
+	size_t len; // size of line
+	ssize_t linelen; // length of the last line read
+	long long lineno; // number of the last line (text) or record (binary) read
+};
+
+// reads the header of graph file f, whose form is recognized by its first byte; returns 0 or -1
+int grOpen(struct GraphReader *r, FILE *f);
+// reads the next interaction into *rec, checking that its vertices are in 0..numnodes-1
+// returns 0, 1 at the end of the file, or -1 on a malformed interaction
+int grNextRecord(struct GraphReader *r, struct GraphRecord *rec);
+// as grNextRecord, into an interaction (with the quantity rounded as by qtyround)
+int grNext(struct GraphReader *r, struct Interaction *x);
+// frees the line buffer of r (the file is not closed)
+void grClose(struct GraphReader *r);
+// parses line <source> <dest> <timestamp> <quantity> into *rec; returns 0, or -1 if a field is missing
+int grParseLine(const char *line, struct GraphRecord *rec);
+void grWriteHeader(FILE *f, int binary, int numnodes, int numinter);
+void grWriteRecord(FILE *f, int binary, const struct GraphRecord *rec);
+
+#endif // __GRAPHIO
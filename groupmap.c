@@ -0,0 +1,252 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*assignment of vertices to groups for the group model (111)*/
+/*used by provenance_tin.c*/
+/*a group map is loaded from a file or derived from the interaction graph by label propagation*/
+#include <string.h>
+#include "groupmap.h"
+
+// (label, vertex) pair, for renumbering the labels
+struct GmLabel {
+	int label;
+	int vertex;
+};
+
+static int cmpgmlabel(const void *i1, const void *i2)
+{
+	struct GmLabel *a = (struct GmLabel *)i1;
+	struct GmLabel *b = (struct GmLabel *)i2;
+
+	if (a->label!=b->label)
+		return a->label<b->label ? -1 : 1;
+	return a->vertex-b->vertex;
+}
+
+/*renumbers the labels of map to 0..numgroups-1, in increasing order of label; returns numgroups*/
+int gmCompact(int *map, int numnodes)
+{
+	int i, numgroups = 0;
+	struct GmLabel *l;
+
+	if (numnodes==0)
+		return 0;
+	l = (struct GmLabel *)malloc(numnodes*sizeof(struct GmLabel));
+	for(i=0;i<numnodes;i++) {
+		l[i].label = map[i];
+		l[i].vertex = i;
+	}
+	qsort(l,numnodes,sizeof(struct GmLabel),cmpgmlabel);
+	for(i=0;i<numnodes;i++) {
+		if (i>0 && l[i].label!=l[i-1].label)
+			numgroups++;
+		map[l[i].vertex] = numgroups;
+	}
+	free(l);
+	return numgroups+1;
+}
+
+/*reads a group map in binary or text form (see groupmap.h)*/
+int gmLoad(const char *filename, int numnodes, int **map, int *numgroups)
+{
+	FILE *f;
+	char magic[4];
+	char *seen;
+	int i,v,g,n,version;
+	int err = 0;
+
+	f = fopen(filename,"rb");
+	if (f==NULL) {
+		printf("ERROR: cannot open group map %s\n",filename);
+		return -1;
+	}
+	*map = (int *)malloc(numnodes*sizeof(int));
+	if (fread(magic,1,4,f)==4 && !memcmp(magic,GM_MAGIC,4)) {
+		if (fread(&version,sizeof(int),1,f)!=1 || version!=GM_VERSION || fread(&n,sizeof(int),1,f)!=1) {
+			printf("ERROR: %s is not a group map\n",filename);
+			err = 1;
+		}
+		else if (n!=numnodes) {
+			printf("ERROR: group map %s has %d vertices, the graph %d\n",filename,n,numnodes);
+			err = 1;
+		}
+		else if (fread(*map,sizeof(int),numnodes,f)!=(size_t)numnodes) {
+			printf("ERROR: group map %s is truncated\n",filename);
+			err = 1;
+		}
+	}
+	else {
+		rewind(f);
+		seen = (char *)calloc(numnodes,sizeof(char));
+		while (!err && fscanf(f,"%d %d",&v,&g)==2) {
+			if (v<0 || v>=numnodes) {
+				printf("ERROR: vertex %d of group map %s does not exist\n",v,filename);
+				err = 1;
+				break;
+			}
+			(*map)[v] = g;
+			seen[v] = 1;
+		}
+		if (!err && !feof(f)) {
+			printf("ERROR: group map %s should hold pairs <vertex> <group>\n",filename);
+			err = 1;
+		}
+		for(i=0;i<numnodes && !err;i++)
+			if (!seen[i]) {
+				printf("ERROR: vertex %d has no group in %s\n",i,filename);
+				err = 1;
+			}
+		free(seen);
+	}
+	fclose(f);
+	if (err) {
+		free(*map);
+		*map = NULL;
+		return -1;
+	}
+	*numgroups = gmCompact(*map,numnodes);
+	return 0;
+}
+
+/*merges all groups of map but the maxgroups-1 largest (by number of vertices) into one; returns the number of groups*/
+static int gmLimit(int *map, int numnodes, int numgroups, int maxgroups)
+{
+	int v,g,s,n,kept,ties;
+	int *size, *hist, *newid;
+
+	size = (int *)calloc(numgroups,sizeof(int));
+	hist = (int *)calloc(numnodes+1,sizeof(int));
+	newid = (int *)malloc(numgroups*sizeof(int));
+	for(v=0;v<numnodes;v++)
+		size[map[v]]++;
+	for(g=0;g<numgroups;g++)
+		hist[size[g]]++;
+	// groups larger than s are kept, and ties groups of size s
+	kept = 0;
+	for(s=numnodes;s>0 && kept+hist[s]<maxgroups-1;s--)
+		kept += hist[s];
+	ties = maxgroups-1-kept;
+	n = 0;
+	for(g=0;g<numgroups;g++)
+		if (size[g]>s || (size[g]==s && ties-- > 0))
+			newid[g] = n++;
+		else
+			newid[g] = -1;
+	for(g=0;g<numgroups;g++)
+		if (newid[g]==-1)
+			newid[g] = n; // the merged group
+	for(v=0;v<numnodes;v++)
+		map[v] = newid[map[v]];
+	free(size);
+	free(hist);
+	free(newid);
+	return n+1;
+}
+
+/*label propagation (see groupmap.h)*/
+/*in each round the vertices are visited in a new pseudo-random order, and each vertex takes the label*/
+/*with the largest total edge weight among its neighbors; ties keep the current label, or else take the smallest one*/
+int gmLabelPropagation(const struct Interaction *inter, int numinter, int numnodes, int *map, int maxgroups, int maxiter)
+{
+	int i,k,v,l,t,best,round,changes,numgroups,numtouched;
+	long long e;
+	long long *start, *pos;
+	int *adj, *order, *touched, *stamp;
+	double *w, *lw, bestw;
+	unsigned int seed = 12345;
+
+	// adjacency lists of the undirected graph, without self-loops; parallel edges are kept
+	start = (long long *)calloc(numnodes+1,sizeof(long long));
+	for(i=0;i<numinter;i++)
+		if (inter[i].src!=inter[i].dest) {
+			start[inter[i].src+1]++;
+			start[inter[i].dest+1]++;
+		}
+	for(v=0;v<numnodes;v++)
+		start[v+1] += start[v];
+	adj = (int *)malloc((start[numnodes]+1)*sizeof(int));
+	w = (double *)malloc((start[numnodes]+1)*sizeof(double));
+	pos = (long long *)malloc((numnodes+1)*sizeof(long long));
+	memcpy(pos,start,(numnodes+1)*sizeof(long long));
+	for(i=0;i<numinter;i++)
+		if (inter[i].src!=inter[i].dest) {
+			adj[pos[inter[i].src]] = inter[i].dest;
+			w[pos[inter[i].src]++] = inter[i].qty;
+			adj[pos[inter[i].dest]] = inter[i].src;
+			w[pos[inter[i].dest]++] = inter[i].qty;
+		}
+	free(pos);
+
+	order = (int *)malloc(numnodes*sizeof(int));
+	touched = (int *)malloc(numnodes*sizeof(int));
+	stamp = (int *)malloc(numnodes*sizeof(int));
+	lw = (double *)calloc(numnodes,sizeof(double)); // lw[l]: weight of the neighbors with label l
+	for(v=0;v<numnodes;v++) {
+		map[v] = v;
+		order[v] = v;
+		stamp[v] = -1;
+	}
+
+	for(round=0;round<maxiter;round++) {
+		// Fisher-Yates shuffle, with a fixed seed so that groups are reproducible
+		for(k=numnodes-1;k>0;k--) {
+			seed = seed*1103515245u+12345u;
+			i = (seed>>8)%(k+1);
+			t = order[k]; order[k] = order[i]; order[i] = t;
+		}
+		changes = 0;
+		for(k=0;k<numnodes;k++) {
+			v = order[k];
+			if (start[v]==start[v+1])
+				continue;
+			numtouched = 0;
+			for(e=start[v];e<start[v+1];e++) {
+				l = map[adj[e]];
+				if (stamp[l]!=v) {
+					stamp[l] = v;
+					touched[numtouched++] = l;
+				}
+				lw[l] += w[e];
+			}
+			best = map[v];
+			bestw = stamp[best]==v ? lw[best] : -1;
+			for(i=0;i<numtouched;i++) {
+				l = touched[i];
+				if (lw[l]>bestw || (lw[l]==bestw && best!=map[v] && l<best)) {
+					best = l;
+					bestw = lw[l];
+				}
+			}
+			for(i=0;i<numtouched;i++) {
+				lw[touched[i]] = 0;
+				stamp[touched[i]] = -1;
+			}
+			if (best!=map[v]) {
+				map[v] = best;
+				changes++;
+			}
+		}
+		if (!changes) {
+			round++;
+			break;
+		}
+	}
+
+	for(v=0;v<numnodes;v++)
+		if (start[v]==start[v+1])
+			map[v] = numnodes; // vertices without interactions share a label no vertex has
+	numgroups = gmCompact(map,numnodes);
+	printf("label propagation: %d groups after %d rounds\n",numgroups,round);
+	if (maxgroups>0 && numgroups>maxgroups) {
+		numgroups = gmLimit(map,numnodes,numgroups,maxgroups);
+		printf("label propagation: merged into %d groups\n",numgroups);
+	}
+
+	free(start);
+	free(adj);
+	free(w);
+	free(order);
+	free(touched);
+	free(stamp);
+	free(lw);
+	return numgroups;
+}
@@ -0,0 +1,26 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __GROUPMAP
+#define __GROUPMAP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "provenance.h" // to obtain struct Interaction definition
+
+#define GM_MAGIC "PTGM" // first bytes of a binary group map
+#define GM_VERSION 1
+#define GM_MAXITER 20 // default number of rounds of label propagation
+
+// renumbers the labels of map[0..numnodes-1] to 0..numgroups-1, in increasing order of label; returns numgroups
+int gmCompact(int *map, int numnodes);
+// reads the group of each of numnodes vertices into *map (allocated) and sets *numgroups
+// the file is either binary (GM_MAGIC, int version, int number of vertices (numnodes), then an int label per vertex)
+// or text (pairs <vertex> <label>, whitespace-separated); labels are arbitrary ints, renumbered by gmCompact
+int gmLoad(const char *filename, int numnodes, int **map, int *numgroups);
+// groups the vertices of the interaction graph by label propagation over the undirected edges, weighted by
+// the quantity of the interactions, for at most maxiter rounds; vertices without interactions form one group
+// if maxgroups>0, all but the maxgroups-1 largest groups are merged into one
+// map must have room for numnodes labels; returns the number of groups
+int gmLabelPropagation(const struct Interaction *inter, int numinter, int numnodes, int *map, int maxgroups, int maxiter);
+
+#endif // __GROUPMAP
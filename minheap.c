@@ -7,7 +7,7 @@
 #include "minheap.h"
 
 /*returns the parent of a heap position*/
-int parent(int posel)
+int heapparent(int posel)
 {
   if (posel%2) /*odd*/
         return posel/2;
@@ -18,8 +18,8 @@ int parent(int posel)
 /*enqueues element*/
 /*heap[0] is the element with the smallest value*/
 /*every element is greater than or equal to its parent*/
-void enqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int *capacity)
-//void enqueue(e_type el, int idx, elem *heap, int *num_elems)
+void heapenqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int *capacity)
+//void heapenqueue(e_type el, int idx, elem *heap, int *num_elems)
 {
     struct BufItem tmp;
     int p;
@@ -34,7 +34,7 @@ void enqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int
 
     while(posel >0)
     {
-        p=parent(posel);
+        p=heapparent(posel);
         if (newitem.ts<(*heap)[p].ts)
         {
 	  /* swap element with its parent */
@@ -42,7 +42,7 @@ void enqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int
           (*heap)[p] = newitem;
           (*heap)[posel] = tmp;
 
-          posel = parent(posel);
+          posel = heapparent(posel);
         }
         else break;
     }
@@ -50,7 +50,7 @@ void enqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int
 
 /* moves down the root element */
 /* used by dequeue (see below) */
-void movedown(struct BufItem *heap, int *num_elems)
+void heapmovedown(struct BufItem *heap, int *num_elems)
 {
     struct BufItem tmp;
     int posel = 0; //root
@@ -82,7 +82,7 @@ void movedown(struct BufItem *heap, int *num_elems)
 }
 
 /* returns the root element, puts the last element as root and moves it down */
-int dequeue(struct BufItem *el, struct BufItem *heap, int *num_elems)
+int heapdequeue(struct BufItem *el, struct BufItem *heap, int *num_elems)
 {
     if ((*num_elems)==0) /* empty queue */
         return 0;
@@ -90,19 +90,19 @@ int dequeue(struct BufItem *el, struct BufItem *heap, int *num_elems)
     *el = heap[0];
     heap[0] = heap[(*num_elems)-1];
     (*num_elems)--;
-    movedown(heap, num_elems);
+    heapmovedown(heap, num_elems);
     return 1;
 }
 
-void print_heap(struct BufItem *heap, int num_elems) {
+void heapprint(struct BufItem *heap, int num_elems) {
   int i;
 
   printf("Heap contents:\n");
   for (i=0; i<num_elems; i++)
-    printf("%d %.2f %.2f\n", heap[i].origin, heap[i].ts, heap[i].qty);
+    printf("%d %.2f %.2f\n", heap[i].origin, heap[i].ts, (double)heap[i].qty);
 }
 
-double sum_elems(struct BufItem *heap, int num_elems) {
+double heapsum(struct BufItem *heap, int num_elems) {
 	double s = 0;
 	for (int i=0; i<num_elems; i++)
 		s += heap[i].qty;
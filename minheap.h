@@ -5,19 +5,76 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+
+// quantities are doubles, or 64-bit integers (e.g. satoshis) if compiled with -DPROV_INTQTY
+#ifdef PROV_INTQTY
+typedef long long qty_t;
+#define QTY_INTEGER 1
+#else
+typedef double qty_t;
+#define QTY_INTEGER 0
+#endif
+
+// functions of the library interface (provenance.h, provout.h); the rest of the library is built with hidden visibility
+#define PROV_API __attribute__((visibility("default")))
+
+#define QTY_EPS 0.00000001 // smallest quantity born as a new item (with integer quantities, any positive one)
 
 // struct for buffered items (to track provenance)
 struct BufItem { /* heap element */
 	int origin;
 	double ts; //timestamp -> KEY!
-	double qty; //quantity
+	qty_t qty; //quantity
 };
 
-void enqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int *capacity);
-void movedown(struct BufItem *heap, int *num_elems);
-int dequeue(struct BufItem *el, struct BufItem *heap, int *num_elems);
-void print_heap(struct BufItem *heap, int num_elems);
-double sum_elems(struct BufItem *heap, int num_elems);
-int parent(int posel);
+// quantity nearest to x
+static inline qty_t qtyround(double x)
+{
+#ifdef PROV_INTQTY
+	return llround(x);
+#else
+	return x;
+#endif
+}
+
+// share of a buffered quantity part when qty out of the total quantity sum of the buffer is transferred proportionally
+// *rest is the quantity whose share is not taken yet (part included) and is reduced by part; it starts at sum
+// with integer quantities the shares are rounded down at the cumulative sums, so that, in any order,
+// the shares of all parts add up exactly to qty
+static inline qty_t propshare(qty_t qty, qty_t part, qty_t *rest, qty_t sum)
+{
+#ifdef PROV_INTQTY
+	qty_t before = (qty_t)((__int128)qty*(*rest)/sum);
+	
+	*rest -= part;
+	return before-(qty_t)((__int128)qty*(*rest)/sum);
+#else
+	(void)rest;
+	return qty*part/sum;
+#endif
+}
+
+// as propshare, for the parts given out from the last one to the first: *rest starts at sum minus all the parts
+// (and grows by part), so each share is the one propshare gives when the parts are given out from the first one
+static inline qty_t propsharerev(qty_t qty, qty_t part, qty_t *rest, qty_t sum)
+{
+#ifdef PROV_INTQTY
+	qty_t after = (qty_t)((__int128)qty*(*rest)/sum);
+	
+	*rest += part;
+	return (qty_t)((__int128)qty*(*rest)/sum)-after;
+#else
+	(void)rest;
+	return qty*part/sum;
+#endif
+}
+
+void heapenqueue(struct BufItem newitem, struct BufItem **heap, int *num_elems, int *capacity);
+void heapmovedown(struct BufItem *heap, int *num_elems);
+int heapdequeue(struct BufItem *el, struct BufItem *heap, int *num_elems);
+void heapprint(struct BufItem *heap, int num_elems);
+double heapsum(struct BufItem *heap, int num_elems);
+int heapparent(int posel);
 
 #endif // __MINHEAP
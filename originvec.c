@@ -0,0 +1,576 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*hybrid origin vectors for proportional provenance*/
+/*used by provenance.c*/
+/*a vector is stored inline, as a sorted array, as a hash table or as a dense block, depending on its population*/
+/*small vectors are merged with a merge-join; large ones are updated origin by origin in O(1) each*/
+#include <string.h>
+#include "originvec.h"
+
+#define OV_WORDS(n) (((n)+63)/64) // words of the bitmap of a dense block of n origins
+
+/*initializes an empty (inline) vector*/
+void ovInit(struct OriginVec *v)
+{
+	memset(v,0,sizeof(struct OriginVec));
+	v->kind = OV_INLINE;
+}
+
+void ovFree(struct OriginVec *v)
+{
+	if (v->kind==OV_SPARSE || v->kind==OV_HASH)
+		free(v->u.items);
+	else if (v->kind==OV_DENSE) {
+		free(v->u.dense.qty);
+		free(v->u.dense.bits);
+	}
+}
+
+/*empties the vector and releases its memory*/
+void ovClear(struct OriginVec *v)
+{
+	ovFree(v);
+	ovInit(v);
+}
+
+/*moves the contents of src to dest, leaving src empty*/
+void ovMove(struct OriginVec *dest, struct OriginVec *src)
+{
+	ovFree(dest);
+	*dest = *src;
+	ovInit(src);
+}
+
+/*returns the slot of origin in a hash table, or the empty slot where it is to be inserted*/
+/*capacity is a power of 2, at least 2*/
+static struct OvItem *ovHashSlot(struct OvItem *slots, int capacity, int origin)
+{
+	unsigned int h = ((unsigned int)origin*2654435761u) >> (32-__builtin_ctz(capacity));
+
+	while (slots[h].origin!=-1 && slots[h].origin!=origin)
+		h = (h+1)&(capacity-1);
+	return &slots[h];
+}
+
+/*copies the items of a hash table or a dense block to out; items of a dense block are sorted by origin*/
+static int ovGather(struct OriginVec *v, struct OvItem *out)
+{
+	int i,w,n = 0;
+	unsigned long long b;
+
+	if (v->kind==OV_HASH) {
+		for(i=0;i<v->capacity;i++)
+			if (v->u.items[i].origin!=-1)
+				out[n++] = v->u.items[i];
+	}
+	else {
+		for(w=0;w<OV_WORDS(v->capacity);w++)
+			for(b=v->u.dense.bits[w];b;b&=b-1) {
+				i = w*64+__builtin_ctzll(b);
+				out[n].origin = v->lo+i;
+				out[n++].qty = v->u.dense.qty[i];
+			}
+	}
+	return n;
+}
+
+#ifdef PROV_INTQTY
+/*returns the slots of the items of the hash table v in increasing order of origin (to be freed), by radix sort*/
+/*rounded shares depend on the order they are given out in, and the other kinds give them out in this order*/
+static int *ovHashOrder(struct OriginVec *v)
+{
+	int count[1<<OV_RADIXBITS];
+	int *order = (int *)malloc(2*v->size*sizeof(int));
+	int *tmp = order+v->size, *t;
+	int i,shift,n = 0,max = 0;
+
+	for(i=0;i<v->capacity;i++)
+		if (v->u.items[i].origin!=-1) {
+			order[n++] = i;
+			if (v->u.items[i].origin>max)
+				max = v->u.items[i].origin;
+		}
+	for(shift=0;shift<31 && (max>>shift);shift+=OV_RADIXBITS) {
+		memset(count,0,sizeof(count));
+		for(i=0;i<n;i++)
+			count[(v->u.items[order[i]].origin>>shift)&((1<<OV_RADIXBITS)-1)]++;
+		for(i=1;i<(1<<OV_RADIXBITS);i++)
+			count[i] += count[i-1];
+		for(i=n-1;i>=0;i--)
+			tmp[--count[(v->u.items[order[i]].origin>>shift)&((1<<OV_RADIXBITS)-1)]] = order[i];
+		t = order;
+		order = tmp;
+		tmp = t;
+	}
+	if (order>tmp) {
+		memcpy(tmp,order,n*sizeof(int));
+		order = tmp;
+	}
+	return order;
+}
+#endif
+
+/*makes v a hash table with the n items (with distinct origins)*/
+static void ovBuildHash(struct OriginVec *v, struct OvItem *items, int n)
+{
+	int i,cap = 16;
+	struct OvItem *slot;
+
+	while (cap<4*n)
+		cap *= 2;
+	ovClear(v);
+	v->kind = OV_HASH;
+	v->capacity = cap;
+	v->u.items = (struct OvItem *)malloc(cap*sizeof(struct OvItem));
+	for(i=0;i<cap;i++)
+		v->u.items[i].origin = -1;
+	for(i=0;i<n;i++) {
+		slot = ovHashSlot(v->u.items,cap,items[i].origin);
+		*slot = items[i];
+	}
+	v->size = n;
+}
+
+/*makes v a dense block of origins lo..lo+cap-1 with the n items (with distinct origins in the block)*/
+static void ovBuildDense(struct OriginVec *v, struct OvItem *items, int n, int lo, int cap)
+{
+	int i,j;
+
+	ovClear(v);
+	v->kind = OV_DENSE;
+	v->lo = lo;
+	v->capacity = cap;
+	v->u.dense.qty = (qty_t *)calloc(cap,sizeof(qty_t)); // absent origins have quantity 0
+	v->u.dense.bits = (unsigned long long *)calloc(OV_WORDS(cap),sizeof(unsigned long long));
+	for(i=0;i<n;i++) {
+		j = items[i].origin-lo;
+		v->u.dense.qty[j] = items[i].qty;
+		v->u.dense.bits[j/64] |= 1ULL<<(j%64);
+	}
+	v->size = n;
+}
+
+/*makes v a dense block if the n items fill enough of their range of origins, else a hash table*/
+static void ovBuildLarge(struct OriginVec *v, struct OvItem *items, int n)
+{
+	int i,min,max;
+
+	min = max = items[0].origin;
+	for(i=1;i<n;i++) {
+		if (items[i].origin<min)
+			min = items[i].origin;
+		if (items[i].origin>max)
+			max = items[i].origin;
+	}
+	if ((long long)max-min+1 <= (long long)OV_DENSEFILL*n)
+		ovBuildDense(v,items,n,min,max-min+1);
+	else
+		ovBuildHash(v,items,n);
+}
+
+/*returns 1 if the n sorted items are enough to be kept as a dense block*/
+static int ovFillsBlock(struct OvItem *items, int n)
+{
+	return n>OV_DENSEMIN && (long long)items[n-1].origin-items[0].origin+1 <= (long long)OV_DENSEFILL*n;
+}
+
+/*sets the contents of v to the n items, which are sorted by origin*/
+/*items must not be stored in v*/
+void ovSetSorted(struct OriginVec *v, struct OvItem *items, int n)
+{
+	if (n<=OV_INLINESIZE) {
+		ovClear(v);
+		memcpy(v->u.inl,items,n*sizeof(struct OvItem));
+		v->size = n;
+	}
+	else if (n<=OV_SPARSEMAX && !ovFillsBlock(items,n)) {
+		if (v->kind!=OV_SPARSE) {
+			ovClear(v);
+			v->kind = OV_SPARSE;
+		}
+		if (v->capacity<n) {
+			v->capacity = 2*n<OV_SPARSEMAX ? 2*n : OV_SPARSEMAX;
+			v->u.items = (struct OvItem *)realloc(v->u.items,v->capacity*sizeof(struct OvItem));
+		}
+		memcpy(v->u.items,items,n*sizeof(struct OvItem));
+		v->size = n;
+	}
+	else
+		ovBuildLarge(v,items,n);
+}
+
+/*turns a small vector into a hash table or a dense block*/
+static void ovMakeLarge(struct OriginVec *v)
+{
+	struct OvItem *tmp;
+	int n = v->size;
+
+	if (n==0) {
+		ovBuildHash(v,NULL,0);
+		return;
+	}
+	tmp = (struct OvItem *)malloc(n*sizeof(struct OvItem));
+	memcpy(tmp,v->kind==OV_INLINE ? v->u.inl : v->u.items,n*sizeof(struct OvItem));
+	ovBuildLarge(v,tmp,n);
+	free(tmp);
+}
+
+/*adds qty to origin in a hash table or dense block, growing or converting it if needed*/
+static void ovAddLarge(struct OriginVec *v, int origin, qty_t qty)
+{
+	struct OvItem *slot, *tmp;
+	int i,n,lo,hi,cap;
+
+	if (v->kind==OV_HASH) {
+		slot = ovHashSlot(v->u.items,v->capacity,origin);
+		if (slot->origin==origin) {
+			slot->qty += qty;
+			return;
+		}
+		slot->origin = origin;
+		slot->qty = qty;
+		v->size++;
+		if (2*v->size > v->capacity) {
+			// rebuild as a larger hash table, or as a dense block if the origins are dense enough
+			tmp = (struct OvItem *)malloc(v->size*sizeof(struct OvItem));
+			n = ovGather(v,tmp);
+			ovBuildLarge(v,tmp,n);
+			free(tmp);
+		}
+		return;
+	}
+
+	i = origin-v->lo;
+	if (i>=0 && i<v->capacity) {
+		if (v->u.dense.bits[i/64] & (1ULL<<(i%64)))
+			v->u.dense.qty[i] += qty;
+		else {
+			v->u.dense.bits[i/64] |= 1ULL<<(i%64);
+			v->u.dense.qty[i] = qty;
+			v->size++;
+		}
+		return;
+	}
+
+	// origin outside the block: extend the block, or switch to a hash table if it would be too sparse
+	lo = origin<v->lo ? origin : v->lo;
+	hi = origin>v->lo+v->capacity-1 ? origin : v->lo+v->capacity-1;
+	tmp = (struct OvItem *)malloc((v->size+1)*sizeof(struct OvItem));
+	n = ovGather(v,tmp);
+	tmp[n].origin = origin;
+	tmp[n++].qty = qty;
+	if ((long long)hi-lo+1 > (long long)OV_SPARSEFILL*n)
+		ovBuildHash(v,tmp,n);
+	else {
+		// double the block, towards the new origin
+		cap = hi-lo+1;
+		if (cap<2*v->capacity)
+			cap = 2*v->capacity;
+		if (origin<v->lo) {
+			lo = hi+1-cap;
+			if (lo<0)
+				lo = 0;
+		}
+		ovBuildDense(v,tmp,n,lo,cap);
+	}
+	free(tmp);
+}
+
+/*adds qty to origin*/
+void ovAdd(struct OriginVec *v, int origin, qty_t qty)
+{
+	struct OvItem tmp[OV_INLINESIZE+1];
+	struct OvItem *items;
+	int low,hi,middle,n = v->size;
+
+	if (v->kind==OV_HASH || v->kind==OV_DENSE) {
+		ovAddLarge(v,origin,qty);
+		return;
+	}
+
+	// binary search in the sorted items
+	items = v->kind==OV_INLINE ? v->u.inl : v->u.items;
+	low = 0;
+	hi = n-1;
+	while (low<=hi) {
+		middle = (low+hi)/2;
+		if (items[middle].origin==origin) {
+			items[middle].qty += qty;
+			return;
+		}
+		if (items[middle].origin<origin)
+			low = middle+1;
+		else
+			hi = middle-1;
+	}
+	// not found -> must be inserted at position low
+	if (v->kind==OV_INLINE) {
+		memcpy(tmp,items,low*sizeof(struct OvItem));
+		tmp[low].origin = origin;
+		tmp[low].qty = qty;
+		memcpy(tmp+low+1,items+low,(n-low)*sizeof(struct OvItem));
+		ovSetSorted(v,tmp,n+1);
+		return;
+	}
+	if (n==OV_SPARSEMAX) {
+		ovMakeLarge(v);
+		ovAddLarge(v,origin,qty);
+		return;
+	}
+	if (v->capacity==n) {
+		v->capacity = 2*n<OV_SPARSEMAX ? 2*n : OV_SPARSEMAX;
+		v->u.items = items = (struct OvItem *)realloc(items,v->capacity*sizeof(struct OvItem));
+	}
+	memmove(items+low+1,items+low,(n-low)*sizeof(struct OvItem));
+	items[low].origin = origin;
+	items[low].qty = qty;
+	v->size++;
+	if (ovFillsBlock(items,v->size))
+		ovMakeLarge(v);
+}
+
+/*transfers qty out of sum from each origin of the large vector src to the small vector dest*/
+/*dest takes the representation of src, so that no origin is hashed or located again*/
+static void ovCopyScaled(struct OriginVec *dest, struct OriginVec *src, qty_t qty, qty_t sum)
+{
+	struct OvItem inl[OV_INLINESIZE];
+	struct OvItem *tmp;
+#ifdef PROV_INTQTY
+	int a,*order;
+#endif
+	int i,n,words;
+	qty_t transqty, rest = sum;
+
+	// keep the previous origins of dest
+	n = dest->size;
+	if (dest->kind==OV_INLINE) {
+		memcpy(inl,dest->u.inl,n*sizeof(struct OvItem));
+		tmp = inl;
+	}
+	else {
+		tmp = dest->u.items;
+		dest->u.items = NULL;
+	}
+	ovClear(dest);
+	dest->kind = src->kind;
+	dest->size = src->size;
+	dest->capacity = src->capacity;
+	dest->lo = src->lo;
+	if (src->kind==OV_HASH) {
+		dest->u.items = (struct OvItem *)malloc(src->capacity*sizeof(struct OvItem));
+#ifdef PROV_INTQTY
+		for(i=0;i<src->capacity;i++)
+			dest->u.items[i].origin = src->u.items[i].origin;
+		order = ovHashOrder(src);
+		for(a=0;a<src->size;a++) {
+			i = order[a];
+			transqty = propshare(qty,src->u.items[i].qty,&rest,sum);
+			dest->u.items[i].qty = transqty;
+			src->u.items[i].qty -= transqty;
+		}
+		free(order);
+#else
+		for(i=0;i<src->capacity;i++) {
+			dest->u.items[i].origin = src->u.items[i].origin;
+			if (src->u.items[i].origin!=-1) {
+				transqty = propshare(qty,src->u.items[i].qty,&rest,sum);
+				dest->u.items[i].qty = transqty;
+				src->u.items[i].qty -= transqty;
+			}
+		}
+#endif
+	}
+	else {
+		words = OV_WORDS(src->capacity);
+		dest->u.dense.qty = (qty_t *)malloc(src->capacity*sizeof(qty_t));
+		dest->u.dense.bits = (unsigned long long *)malloc(words*sizeof(unsigned long long));
+		memcpy(dest->u.dense.bits,src->u.dense.bits,words*sizeof(unsigned long long));
+		// absent origins have quantity 0 in src, so they stay 0
+		for(i=0;i<src->capacity;i++) {
+			transqty = propshare(qty,src->u.dense.qty[i],&rest,sum);
+			dest->u.dense.qty[i] = transqty;
+			src->u.dense.qty[i] -= transqty;
+		}
+	}
+	for(i=0;i<n;i++)
+		ovAddLarge(dest,tmp[i].origin,tmp[i].qty);
+	if (tmp!=inl)
+		free(tmp);
+}
+
+/*merges src into dest*/
+/*if all is set, all quantity of src is added to dest and src is left unchanged (the caller empties it)*/
+/*otherwise, qty out of the sum buffered at src is transferred, proportionally from each origin of src*/
+void ovMerge(struct OriginVec *dest, struct OriginVec *src, qty_t qty, qty_t sum, int all)
+{
+	struct OvItem small[2*OV_INLINESIZE];
+	struct OvItem *tmp, *ps, *pd;
+#ifdef PROV_INTQTY
+	int *order;
+#endif
+	int a,b,n,ns,nd,i,w;
+	unsigned long long bits;
+	qty_t transqty, rest = sum;
+
+	ns = src->size;
+	nd = dest->size;
+	if (ns==0)
+		return;
+
+	if (src->kind<=OV_SPARSE && dest->kind<=OV_SPARSE) {
+		// merge-join of the two sorted vectors
+		tmp = ns+nd<=2*OV_INLINESIZE ? small : (struct OvItem *)malloc((ns+nd)*sizeof(struct OvItem));
+		ps = src->kind==OV_INLINE ? src->u.inl : src->u.items;
+		pd = dest->kind==OV_INLINE ? dest->u.inl : dest->u.items;
+		a = b = n = 0;
+		while (a<ns && b<nd) {
+			if (ps[a].origin<pd[b].origin) {
+				transqty = all ? ps[a].qty : propshare(qty,ps[a].qty,&rest,sum);
+				tmp[n].origin = ps[a].origin;
+				tmp[n++].qty = transqty;
+				if (!all)
+					ps[a].qty -= transqty;
+				a++;
+			}
+			else if (ps[a].origin>pd[b].origin)
+				tmp[n++] = pd[b++];
+			else {
+				transqty = all ? ps[a].qty : propshare(qty,ps[a].qty,&rest,sum);
+				tmp[n].origin = pd[b].origin;
+				tmp[n++].qty = transqty+pd[b].qty;
+				if (!all)
+					ps[a].qty -= transqty;
+				a++; b++;
+			}
+		}
+		for(;a<ns;a++) {
+			transqty = all ? ps[a].qty : propshare(qty,ps[a].qty,&rest,sum);
+			tmp[n].origin = ps[a].origin;
+			tmp[n++].qty = transqty;
+			if (!all)
+				ps[a].qty -= transqty;
+		}
+		for(;b<nd;b++)
+			tmp[n++] = pd[b];
+		if (tmp==small || n>OV_SPARSEMAX || ovFillsBlock(tmp,n)) {
+			ovSetSorted(dest,tmp,n);
+			if (tmp!=small)
+				free(tmp);
+		}
+		else {
+			// the merged array becomes the array of dest
+			ovFree(dest);
+			dest->kind = OV_SPARSE;
+			dest->u.items = tmp;
+			dest->capacity = ns+nd;
+			dest->size = n;
+		}
+		return;
+	}
+
+	if (all && src->kind>=OV_HASH && (dest->kind<=OV_SPARSE || nd<ns)) {
+		// add the smaller dest to src instead, and give the result to dest
+		ovMerge(src,dest,0,0,1);
+		ovMove(dest,src);
+		return;
+	}
+	if (!all && src->kind>=OV_HASH && dest->kind<=OV_SPARSE) {
+		// dest becomes a copy of the layout of src, holding the transferred quantities
+		ovCopyScaled(dest,src,qty,sum);
+		return;
+	}
+
+	// at least one of the vectors is large: add the origins of src to dest one by one
+	if (dest->kind<=OV_SPARSE)
+		ovMakeLarge(dest);
+	switch(src->kind)
+	{
+		case OV_INLINE:
+		case OV_SPARSE:
+		ps = src->kind==OV_INLINE ? src->u.inl : src->u.items;
+		for(a=0;a<ns;a++) {
+			transqty = all ? ps[a].qty : propshare(qty,ps[a].qty,&rest,sum);
+			ovAddLarge(dest,ps[a].origin,transqty);
+			if (!all)
+				ps[a].qty -= transqty;
+		}
+		break;
+
+		case OV_HASH:
+#ifdef PROV_INTQTY
+		if (!all) {
+			order = ovHashOrder(src);
+			for(a=0;a<ns;a++) {
+				ps = &src->u.items[order[a]];
+				transqty = propshare(qty,ps->qty,&rest,sum);
+				ovAddLarge(dest,ps->origin,transqty);
+				ps->qty -= transqty;
+			}
+			free(order);
+			break;
+		}
+#endif
+		for(i=0;i<src->capacity;i++)
+			if (src->u.items[i].origin!=-1) {
+				ps = &src->u.items[i];
+				transqty = all ? ps->qty : propshare(qty,ps->qty,&rest,sum);
+				ovAddLarge(dest,ps->origin,transqty);
+				if (!all)
+					ps->qty -= transqty;
+			}
+		break;
+
+		case OV_DENSE:
+		for(w=0;w<OV_WORDS(src->capacity);w++)
+			for(bits=src->u.dense.bits[w];bits;bits&=bits-1) {
+				i = w*64+__builtin_ctzll(bits);
+				transqty = all ? src->u.dense.qty[i] : propshare(qty,src->u.dense.qty[i],&rest,sum);
+				ovAddLarge(dest,src->lo+i,transqty);
+				if (!all)
+					src->u.dense.qty[i] -= transqty;
+			}
+		break;
+	}
+}
+
+static int cmpovitem(const void *i1, const void *i2)
+{
+	return ((struct OvItem *)i1)->origin - ((struct OvItem *)i2)->origin;
+}
+
+/*sets *items to the items of v, sorted by origin, and returns their number*/
+/*large vectors are copied to *scratch, which is grown as needed*/
+int ovSorted(struct OriginVec *v, struct OvItem **scratch, int *scratchcapacity, struct OvItem **items)
+{
+	if (v->kind==OV_INLINE) {
+		*items = v->u.inl;
+		return v->size;
+	}
+	if (v->kind==OV_SPARSE) {
+		*items = v->u.items;
+		return v->size;
+	}
+	if (*scratchcapacity<v->size) {
+		*scratchcapacity = v->size;
+		*scratch = (struct OvItem *)realloc(*scratch,(*scratchcapacity)*sizeof(struct OvItem));
+	}
+	ovGather(v,*scratch);
+	if (v->kind==OV_HASH)
+		qsort(*scratch,v->size,sizeof(struct OvItem),cmpovitem);
+	*items = *scratch;
+	return v->size;
+}
+
+/*bytes allocated outside the vector itself*/
+long long ovMemory(struct OriginVec *v)
+{
+	switch(v->kind)
+	{
+		case OV_SPARSE:
+		case OV_HASH:
+		return (long long)v->capacity*sizeof(struct OvItem);
+		case OV_DENSE:
+		return (long long)v->capacity*sizeof(qty_t)+OV_WORDS(v->capacity)*sizeof(unsigned long long);
+	}
+	return 0;
+}
@@ -0,0 +1,54 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __ORIGINVEC
+#define __ORIGINVEC
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "minheap.h" // to obtain qty_t
+
+// representations of an origin vector, picked by its population
+#define OV_INLINE 0 // up to OV_INLINESIZE items, sorted by origin, stored in the vector itself
+#define OV_SPARSE 1 // array of items sorted by origin
+#define OV_HASH 2 // open-addressing hash table of items
+#define OV_DENSE 3 // block of quantities of a range of origins, with a bitmap of the origins present
+
+#define OV_INLINESIZE 3 // items stored inline
+#define OV_SPARSEMAX 16384 // largest sorted array; larger vectors become hash tables or dense blocks
+#define OV_DENSEMIN 1024 // smallest dense block
+#define OV_DENSEFILL 2 // a vector is made dense if it holds at least 1/OV_DENSEFILL of the origins in its range
+#define OV_SPARSEFILL 4 // a dense vector becomes a hash table if less than 1/OV_SPARSEFILL of its range is used
+#define OV_RADIXBITS 11 // bits of origin sorted per pass of the radix sort of the origins of a hash table
+
+struct OvItem {
+	int origin; // -1 for an empty slot of a hash table
+	qty_t qty;
+};
+
+// vector of (origin, quantity) pairs of a vertex
+struct OriginVec {
+	int kind; // one of OV_INLINE, OV_SPARSE, OV_HASH, OV_DENSE
+	int size; // number of origins in the vector
+	int capacity; // number of items (OV_SPARSE), slots (OV_HASH) or origins in the block (OV_DENSE)
+	int lo; // first origin of the block (OV_DENSE)
+	union {
+		struct OvItem inl[OV_INLINESIZE];
+		struct OvItem *items; // OV_SPARSE, OV_HASH
+		struct {
+			qty_t *qty; // qty[i] is the quantity of origin lo+i
+			unsigned long long *bits; // bit i is set if origin lo+i is present
+		} dense;
+	} u;
+};
+
+void ovInit(struct OriginVec *v);
+void ovFree(struct OriginVec *v);
+void ovClear(struct OriginVec *v);
+void ovMove(struct OriginVec *dest, struct OriginVec *src);
+void ovAdd(struct OriginVec *v, int origin, qty_t qty);
+void ovMerge(struct OriginVec *dest, struct OriginVec *src, qty_t qty, qty_t sum, int all);
+int ovSorted(struct OriginVec *v, struct OvItem **scratch, int *scratchcapacity, struct OvItem **items);
+void ovSetSorted(struct OriginVec *v, struct OvItem *items, int n);
+long long ovMemory(struct OriginVec *v);
+
+#endif // __ORIGINVEC
@@ -0,0 +1,122 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*partitioning of the interactions by weakly connected components*/
+/*used by provenance.c to run the components of a trace in parallel*/
+/*components never exchange quantity, so each of them can be processed on its own*/
+#include <string.h>
+#include "partition.h"
+
+// root of the set of v, with path halving
+static int partFind(int *parent, int v)
+{
+	while (parent[v]!=v) {
+		parent[v] = parent[parent[v]];
+		v = parent[v];
+	}
+	return v;
+}
+
+// (component, number of interactions) pair, for ordering the components by size
+struct PartComp {
+	int comp;
+	int size;
+};
+
+static int cmppartcomp(const void *i1, const void *i2)
+{
+	struct PartComp *a = (struct PartComp *)i1;
+	struct PartComp *b = (struct PartComp *)i2;
+	
+	if (a->size!=b->size)
+		return a->size>b->size ? -1 : 1;
+	return a->comp-b->comp;
+}
+
+int partComponents(const struct Interaction *inter, int numinter, int numnodes, int numthreads, struct Interaction **parted, int **index, int **start, int *numcomp)
+{
+	int i,v,a,b,t,n,numtasks,minsize;
+	int *parent, *rank, *size, *task, *pos;
+	struct PartComp *comps;
+	
+	// union by rank over the src/dest pairs
+	parent = (int *)malloc(numnodes*sizeof(int));
+	rank = (int *)calloc(numnodes,sizeof(int));
+	for(v=0;v<numnodes;v++)
+		parent[v] = v;
+	for(i=0;i<numinter;i++) {
+		a = partFind(parent,inter[i].src);
+		b = partFind(parent,inter[i].dest);
+		if (a==b)
+			continue;
+		if (rank[a]<rank[b]) {
+			parent[a] = b;
+		}
+		else {
+			parent[b] = a;
+			if (rank[a]==rank[b])
+				rank[a]++;
+		}
+	}
+	free(rank);
+	
+	// number of interactions of each component, identified by its root
+	size = (int *)calloc(numnodes,sizeof(int));
+	for(i=0;i<numinter;i++)
+		size[partFind(parent,inter[i].src)]++;
+	n = 0;
+	for(v=0;v<numnodes;v++)
+		if (size[v]>0)
+			n++;
+	comps = (struct PartComp *)malloc((n+1)*sizeof(struct PartComp));
+	n = 0;
+	for(v=0;v<numnodes;v++)
+		if (size[v]>0) {
+			comps[n].comp = v;
+			comps[n++].size = size[v];
+		}
+	qsort(comps,n,sizeof(struct PartComp),cmppartcomp);
+	*numcomp = n;
+	
+	// tasks: large components alone, the others packed in order of decreasing size
+	if (numthreads<1)
+		numthreads = 1;
+	minsize = numinter/(numthreads*PART_TASKSPERTHREAD);
+	if (minsize<1)
+		minsize = 1;
+	task = size; // task of each root; the sizes are in comps
+	*start = (int *)malloc((n+1)*sizeof(int));
+	numtasks = 0;
+	t = 0; // interactions in the current task
+	for(i=0;i<n;i++) {
+		if (t==0)
+			(*start)[numtasks++] = 0;
+		task[comps[i].comp] = numtasks-1;
+		(*start)[numtasks-1] += comps[i].size;
+		t += comps[i].size;
+		if (t>=minsize)
+			t = 0;
+	}
+	free(comps);
+	// sizes to offsets
+	for(a=0,t=0;t<numtasks;t++) {
+		b = (*start)[t];
+		(*start)[t] = a;
+		a += b;
+	}
+	(*start)[numtasks] = a;
+	
+	// interactions of each task, in time order
+	pos = (int *)malloc((numtasks+1)*sizeof(int));
+	memcpy(pos,*start,(numtasks+1)*sizeof(int));
+	*parted = (struct Interaction *)malloc((numinter+1)*sizeof(struct Interaction));
+	*index = (int *)malloc((numinter+1)*sizeof(int));
+	for(i=0;i<numinter;i++) {
+		t = pos[task[partFind(parent,inter[i].src)]]++;
+		(*parted)[t] = inter[i];
+		(*index)[t] = i;
+	}
+	free(pos);
+	free(size);
+	free(parent);
+	return numtasks;
+}
@@ -0,0 +1,20 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __PARTITION
+#define __PARTITION
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "provenance.h" // to obtain struct Interaction definition
+
+#define PART_TASKSPERTHREAD 8 // small components are packed into about this many tasks per thread
+
+// splits inter into tasks of whole weakly connected components of the interaction graph, for numthreads threads:
+// components with at least numinter/(numthreads*PART_TASKSPERTHREAD) interactions form a task each,
+// smaller ones are packed together; tasks are in (about) decreasing number of interactions
+// *parted (allocated) holds the interactions of task t in (*start)[t]..(*start)[t+1]-1, in time order, and
+// *index (allocated) the position in inter of each of them
+// returns the number of tasks, and sets *numcomp to the number of components with interactions
+int partComponents(const struct Interaction *inter, int numinter, int numnodes, int numthreads, struct Interaction **parted, int **index, int **start, int *numcomp);
+
+#endif // __PARTITION
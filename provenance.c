@@ -0,0 +1,4387 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*provenance models in temporal interaction networks*/
+/*library part of provenance_tin; the interface is in provenance.h*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "minheap.h"
+#include "fifoqueue.h"
+#include "originvec.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "provout.h"
+#include "provenance.h"
+#include "threadpool.h"
+#include "partition.h"
+#include "bufstore.h"
+
+#define CHKPT_MAGIC "PTIN" // first bytes of a checkpoint file
+#define CHKPT_VERSION 7
+#define SNAP_INDEX "index.txt" // time index of a snapshot directory
+#define GALLOP_RATIO 16 // a buffer this many times smaller than the other is intersected by galloping
+#define DUST_MINMARK 16 // buffers are not pruned of dust before they reach this size (see prunenode)
+#define PACK_MAXITEM 32 // largest number of bytes of an item of a compressed buffer (see packnode)
+#define PACK_MAXTS 4e15 // integral timestamps below this are delta-encoded in compressed buffers
+
+// struct for buffered items (for proportional tracking - no timestamp needed)
+struct BufItemProp { 
+	int origin;
+	qty_t qty; //quantity
+};
+
+// struct for paths of bufitems
+// used in how-provenance
+struct BufItemPath { 
+	int pathlen;
+	int pathcapacity;
+	int *path; //quantity
+};
+
+// state of a provenance model after processing a prefix of the interactions
+// kept outside of the model functions, so that a run can be checkpointed
+// and later resumed with new interactions (see saveProvState, loadProvState)
+// each model uses only the arrays it needs; the rest are NULL
+struct ProvState {
+	int method; // provenance model (see main)
+	int numnodes; // number of vertices
+	int numprocessed; // number of interactions processed so far
+	double lastts; // timestamp of the last processed interaction
+
+	// model parameters
+	int W; // window size (120)
+	double T; // length of the time window (123), decay time constant (124)
+	int numepochs; // number of epochs per time window (123)
+	int budget; // buffer budget (121)
+	int reducedsize; // size of a buffer after shrinking (121)
+	int numselected; // number of selected vertices (110)
+	int *selectednodes; // selected vertices (110)
+	int *selmap; // selmap[i] is position of node i in selectednodes, -1 if not selected (110)
+	int numgroups; // number of groups (100, 111), of the finest level (112)
+	int *map; // map[i] = group id whereto vertex i is mapped (100, 111), at the finest level (112)
+	int numlevels; // number of levels of groups (112)
+	int *levelgroups; // number of groups of each level (112)
+	int **rollup; // rollup[l][g] = group of level l>0 that contains group g of the finest level (112)
+	int *levelpos; // scratch space for rolling up the items of a vertex, one entry per group (112)
+	double dustabs, dustrel; // dust thresholds, absolute and relative to the quantity of a node (101, 120)
+
+	// counters reported by the models
+	int numtransfers;
+	int numrelays;
+	long long numpruned; // number of items folded into origin -1 as dust (101, 120)
+	qty_t prunedqty; // total quantity of these items
+
+	// buffers of the time-ordered models (1, 2, 3, 4, 31) and of the sparse proportional models (101, 120, 121)
+	struct BufItem **buffer; // array of buffers, one for each node of the Graph
+	struct BufItemProp **propbuffer; // array of sparse buffers, one for each node of the Graph
+	int *bufcapacity; // capacity of each buffer
+	int *bufsize; // number of items in each buffer
+	int *buffirst; // position to 1st item in buffer[i] (4)
+	int *buflast; // position to last item in buffer[i] (4)
+	struct BufItemPath **bufferpath; // paths of buffered items (31)
+
+	// total quantity buffered at each node (0 and proportional models)
+	qty_t *sumbuffered;
+
+	struct BufItemProp **oddbuffer; // buffers of odd windows (120)
+	int *oddbufcapacity;
+	int *oddbufsize;
+	int evenreset, oddreset; // stream positions of the last resets of the even and odd buffers (120), -1 if none
+	int *evenstamp, *oddstamp; // last resets applied to the buffers of each node (120)
+	int *dustmark; // size of the buffers of each node at which they are next pruned of dust (101, 120), NULL if no pruning
+
+	int *lastbufshrink; // last time provenance info is shrunk at each node (121)
+	int *batchpos; // position in the batch of each interaction fed to the model (see partTask), NULL if they are the batch
+	int *numbufshrinks; // number of times provenance info is shrunk at each node (121, 122, 125)
+	struct BufItemProp *newbuffer; // buffer used for merging (121, 122, 125)
+	qty_t *shrinkqty; // scratch space for shrinking newbuffer (121, 122, 125)
+	double *sketcherr; // error bound of the quantities of the sketch of each node (122, 125)
+
+	double *oldest; // start of the oldest epoch with quantity of known origin at each node (123)
+	double *tlast; // time each node was last decayed (124)
+	struct BufItem *mergebuffer; // buffer used for merging (123)
+	int mergecapacity;
+	int newbufcapacity; // capacity of newbuffer (124)
+
+	struct OriginVec *ovec; // hybrid origin vectors, one for each node of the Graph (102)
+	struct OvItem *ovscratch; // scratch space for sorting large origin vectors (102)
+	int ovscratchcapacity;
+
+	qty_t **densebuffer; // dense buffers, one entry per group or selected vertex (100, 110, 111)
+	qty_t *nonselectedqty; // quantity originating from non-selected nodes (110)
+
+	struct BufItem *items; // items of the last queried vertex (see getProvVertex)
+	int itemcapacity;
+
+	// out-of-core buffers (4, 101)
+	long long memlimit; // bytes of resident buffers, 0 if all buffers are resident
+	char *spilldir; // directory of the spill file, NULL for the current directory
+	int coldafter; // buffers not used for this number of interactions are compressed, 0 if none are
+	double quantum; // quantities of the compressed buffers are rounded to multiples of it, 0 if they are kept exactly
+	struct BufStore *store; // LRU list and spill file of the buffers (see bufstore.h), NULL if all are resident
+};
+
+// header of a checkpoint file
+struct ProvCheckpointHeader {
+	char magic[4];
+	int version;
+	int method;
+	int numnodes;
+	int numprocessed;
+	double lastts;
+	int W;
+	int budget;
+	int reducedsize;
+	int numselected;
+	int numgroups;
+	int numtransfers;
+	int numrelays;
+	double T;
+	int numepochs;
+	int numlevels;
+	int intqty; // set if quantities are integers (PROV_INTQTY)
+	double dustabs;
+	double dustrel;
+	long long numpruned;
+	double prunedqty;
+};
+
+
+// interactions are read from memory
+static int noProvFromMem(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j;
+
+    qty_t *buffer = s->sumbuffered; // array of buffers, one for each node of the Graph
+    
+	qty_t relayqty;
+		    
+	for(i=0;i<numinter;i++)
+	{
+		relayqty = buffer[inter[i].src]<inter[i].qty ? buffer[inter[i].src]:inter[i].qty; // min(buffer[src],qty)
+		buffer[inter[i].src] -= relayqty;
+		buffer[inter[i].dest] += inter[i].qty;
+		//for(j=0;j<numnodes;j++) printf("%d\t%f\n",j,buffer[j]);
+	}
+	
+    return 0;
+}
+
+
+// comparison function for ints (ascending order)
+static int cmpint(const void *a, const void *b)
+{
+	return *(int *)a - *(int *)b;
+}
+
+// same as noProvFromMem, but 
+// records in array topk the k vertices with the largest contribution or buffer as origins 
+static int noProvFromMem2(struct Interaction *inter, int numinter, int numnodes, int *topk, int k, int contr)
+{
+    int i,j;
+    int numelems, posel, p, tmp, swap; // for heap
+
+    qty_t *buffer; // array of buffers, one for each node of the Graph
+    qty_t *contributions; // contribution of each node (as origin)
+    
+    qty_t *comp; // top-k based on comp: either contribution (if contr=1) or sumbuffered (if contr=0)
+    
+	qty_t relayqty;
+		    
+    buffer = (qty_t *)malloc(numnodes*sizeof(qty_t));
+    contributions = (qty_t *)malloc(numnodes*sizeof(qty_t));
+    for(i=0;i<numnodes;i++) {
+        buffer[i]=0.0; // initially, all buffers are 0
+        contributions[i]=0.0; // initially, all contributions are 0
+    }
+    
+	for(i=0;i<numinter;i++)
+	{
+		relayqty = buffer[inter[i].src]<inter[i].qty ? buffer[inter[i].src]:inter[i].qty; // min(buffer[src],qty)
+		if (inter[i].qty>buffer[inter[i].src]) // vertex bears new qty
+			contributions[inter[i].src] += inter[i].qty-buffer[inter[i].src];
+		buffer[inter[i].src] -= relayqty;
+		buffer[inter[i].dest] += inter[i].qty;
+	}
+    
+    if (contr)
+    	comp = contributions;
+    else
+    	comp = buffer;
+
+	// now find top-k based on comp array
+    //initialize minheap
+    if (k>=numnodes) {
+    	//trivial case
+    	for(i=0;i<numnodes;i++)
+    		topk[i]=i;
+    }
+    else {    
+		//add first k elements
+		numelems = 0;		
+		for(i=0;i<k;i++) {
+			//enqueue vertex i
+			posel = numelems; //last position
+			topk[numelems++] = i;
+			//newitem = i;
+
+			while(posel >0)
+			{
+				p=heapparent(posel);
+				if (comp[i]<comp[topk[p]])
+				{
+			  		/* swap element with its parent */
+				  topk[posel] = topk[p];
+				  topk[p] = i;
+
+				  posel = heapparent(posel);
+				}
+				else break;
+			}
+		}
+		
+		//examine remaining elements
+		for(;i<numnodes;i++) {
+			if (comp[i]>comp[topk[0]]) // i must be added to heap
+			{
+				topk[0] = i; //place i at the top of the min-heap
+				//correct heap (movedown)
+				posel = 0;
+				while (posel*2+1 < k) /*there exists a left son*/
+				{
+					if (posel*2+2< k) /*there exists a right son*/
+					{
+						if(comp[topk[posel*2+1]]<comp[topk[posel*2+2]])
+							swap = posel*2+1;
+						else
+							swap = posel*2+2;
+					}
+					else
+						swap = posel*2+1;
+
+					if (comp[topk[posel]] > comp[topk[swap]]) /*larger than smallest son*/
+					{
+						/*swap elements*/	
+						tmp = topk[swap];
+						topk[swap] = topk[posel];
+						topk[posel] = tmp;
+			
+						posel = swap;
+					}
+					else break;
+				}
+			}
+		}
+	}
+	
+	free(buffer);
+	free(contributions);
+	
+    return 0;
+}
+
+// updates the totals buffered at src and dest after an interaction of quantity qty, as in the model without
+// provenance (0), so that the item models (1, 2, 3, 31, 4) know the total of a buffer without summing its items
+// a self-loop keeps the buffered quantity at src, and only the part of qty that was not buffered is born there
+static inline void movesum(qty_t *sumbuffered, int src, int dest, qty_t qty)
+{
+	if (src==dest) {
+		if (qty>sumbuffered[src])
+			sumbuffered[src] = qty;
+		return;
+	}
+	sumbuffered[src] = qty<sumbuffered[src] ? sumbuffered[src]-qty : 0;
+	sumbuffered[dest] += qty;
+}
+
+// provenance oldest birth first model
+// Least Recently Born in paper
+static int ProvOldestFirst(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    struct BufItem **buffer = s->buffer; // array of buffers, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+    qty_t *sumbuffered = s->sumbuffered; // total quantity of each buffer (see movesum)
+    
+	qty_t relayqty;
+	qty_t residueqty;
+	int src;
+	int dest;
+	struct BufItem newentry;
+	
+	int numtransfers = 0;
+	int numrelays = 0;
+	
+	qty_t cumqty = 0.0; //cumulative quantity
+	
+	for(i=0;i<numinter;i++)
+	{
+		cumqty += inter[i].qty;
+		residueqty=inter[i].qty; // remaining quantity to be transferred
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (src==dest) // self-loop: the buffered quantity stays at src (see movesum)
+			residueqty -= sumbuffered[src];
+		while (src!=dest && residueqty>0 && bufsize[src])
+		{
+			numtransfers++;
+			if (buffer[src][0].qty>residueqty) { // buffer[src][0] is quantity with oldest birth
+				newentry.origin = buffer[src][0].origin;
+				newentry.ts = buffer[src][0].ts;
+				newentry.qty = residueqty;
+				heapenqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
+				buffer[src][0].qty-=residueqty;
+				residueqty = 0;
+			}
+			else { //entire entry must be relayed from src to dest
+				numrelays++;
+				heapdequeue(&newentry,buffer[src],&bufsize[src]);
+				heapenqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
+				residueqty-=newentry.qty;
+			}
+		}
+		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
+		{	
+			numtransfers++;
+			newentry.origin = src;
+			newentry.ts = inter[i].ts;
+			newentry.qty = residueqty;
+			heapenqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
+		}
+		movesum(sumbuffered,src,dest,inter[i].qty);
+	}
+	
+	s->numtransfers += numtransfers;
+	s->numrelays += numrelays;
+	
+    return 0;
+}
+
+// provenance newest birth first model
+// same as oldest first, but all timestamps are made negative
+// in order to prioritize newest ones (smallest negative ones)
+static int ProvNewestFirst(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    struct BufItem **buffer = s->buffer; // array of buffers, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+    qty_t *sumbuffered = s->sumbuffered; // total quantity of each buffer (see movesum)
+    
+	qty_t relayqty;
+	qty_t residueqty;
+	int src;
+	int dest;
+	struct BufItem newentry;
+	
+	for(i=0;i<numinter;i++)
+	{
+		residueqty=inter[i].qty; // remaining quantity to be transferred
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (src==dest) // self-loop: the buffered quantity stays at src (see movesum)
+			residueqty -= sumbuffered[src];
+		while (src!=dest && residueqty>0 && bufsize[src])
+		{
+			if (buffer[src][0].qty>residueqty) { // buffer[src][0] is quantity with oldest birth
+				newentry.origin = buffer[src][0].origin;
+				newentry.ts = buffer[src][0].ts;
+				newentry.qty = residueqty;
+				heapenqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
+				buffer[src][0].qty-=residueqty;
+				residueqty = 0;
+			}
+			else { //entire entry must be relayed from src to dest
+				heapdequeue(&newentry,buffer[src],&bufsize[src]);
+				heapenqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
+				residueqty-=newentry.qty;
+			}
+		}
+		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
+		{
+			newentry.origin = src;
+			newentry.ts = -inter[i].ts;
+			newentry.qty = residueqty;
+			heapenqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
+		}
+		movesum(sumbuffered,src,dest,inter[i].qty);
+	}
+	
+    return 0;
+}
+
+// provenance LIFO model
+// last-in first out when propagating quantities
+// each node's buffer is managed as a stack 
+static int ProvLIFO(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    struct BufItem **buffer = s->buffer; // array of buffers, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+    qty_t *sumbuffered = s->sumbuffered; // total quantity of each buffer (see movesum)
+    
+	qty_t relayqty;
+	qty_t residueqty;
+	int src;
+	int dest;
+	struct BufItem newentry;
+	
+	int numtransfers = 0;
+	
+	for(i=0;i<numinter;i++)
+	{
+		residueqty=inter[i].qty; // remaining quantity to be transferred
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (src==dest) // self-loop: the buffered quantity stays at src (see movesum)
+			residueqty -= sumbuffered[src];
+		while (src!=dest && residueqty>0 && bufsize[src])
+		{
+			numtransfers++;
+			if (buffer[src][bufsize[src]-1].qty>residueqty) { // buffer[src][-1] is most recently added quantity (stack's top)
+				newentry.origin = buffer[src][bufsize[src]-1].origin;
+				newentry.ts = buffer[src][bufsize[src]-1].ts; //not used
+				newentry.qty = residueqty;
+				if (bufcapacity[dest] <= bufsize[dest]) {
+					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
+					bufcapacity[dest] *= 2;
+				}
+				buffer[dest][bufsize[dest]++] = newentry;
+				
+				buffer[src][bufsize[src]-1].qty-=residueqty;
+				residueqty = 0;
+			}
+			else { //entire entry must be relayed from src to dest
+				if (bufcapacity[dest] <= bufsize[dest]) {
+					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
+					bufcapacity[dest] *= 2;
+				}
+				buffer[dest][bufsize[dest]++] = buffer[src][bufsize[src]-1];
+				residueqty-=buffer[src][bufsize[src]-1].qty;
+				
+				bufsize[src]--; // implicitly removes top element (no need to implement this explicitly)
+			}
+		}
+		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
+		{	
+			numtransfers++;
+			newentry.origin = src;
+			newentry.ts = inter[i].ts; // not used
+			newentry.qty = residueqty;
+			
+			if (bufcapacity[dest] <= bufsize[dest]) {
+				buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
+				bufcapacity[dest] *= 2;
+			}
+			buffer[dest][bufsize[dest]++] = newentry;
+		}
+		movesum(sumbuffered,src,dest,inter[i].qty);
+	}
+
+	s->numtransfers += numtransfers;
+	
+    return 0;
+}
+
+// provenance LIFO model
+// last-in first out when propagating quantities
+// each node's buffer is managed as a stack
+// tracks paths of buffered quantities 
+static int ProvLIFOPaths(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    struct BufItem **buffer = s->buffer; // array of buffers, one for each node of the Graph
+    struct BufItemPath **bufferpath = s->bufferpath; // array of buffer paths, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+    qty_t *sumbuffered = s->sumbuffered; // total quantity of each buffer (see movesum)
+    
+	qty_t relayqty;
+	qty_t residueqty;
+	int src;
+	int dest;
+	struct BufItem newentry;
+	struct BufItemPath newpathentry;
+	
+	int numtransfers = 0;
+	
+	for(i=0;i<numinter;i++)
+	{
+		residueqty=inter[i].qty; // remaining quantity to be transferred
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (src==dest) // self-loop: the buffered quantity stays at src (see movesum)
+			residueqty -= sumbuffered[src];
+		while (src!=dest && residueqty>0 && bufsize[src])
+		{
+			numtransfers++;
+			if (buffer[src][bufsize[src]-1].qty>residueqty) { // buffer[src][-1] is most recently added quantity (stack's top)
+				newentry.origin = buffer[src][bufsize[src]-1].origin;
+				newentry.ts = buffer[src][bufsize[src]-1].ts; //not used
+				newentry.qty = residueqty;
+				newpathentry.pathlen = bufferpath[src][bufsize[src]-1].pathlen+1;
+				newpathentry.pathcapacity = bufferpath[src][bufsize[src]-1].pathlen+1;
+				newpathentry.path = (int *)malloc(newpathentry.pathcapacity*sizeof(int));
+				for(j=0;j<bufferpath[src][bufsize[src]-1].pathlen;j++) // copy existing path from source
+					newpathentry.path[j] = bufferpath[src][bufsize[src]-1].path[j];
+				newpathentry.path[bufferpath[src][bufsize[src]-1].pathlen]=src; // add source node to path
+				if (bufcapacity[dest] <= bufsize[dest]) {
+					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
+					bufferpath[dest] = (struct BufItemPath *)realloc(bufferpath[dest], bufcapacity[dest]*2*sizeof(struct BufItemPath));
+					bufcapacity[dest] *= 2;
+				}
+				buffer[dest][bufsize[dest]] = newentry;
+				bufferpath[dest][bufsize[dest]++] = newpathentry;
+				buffer[src][bufsize[src]-1].qty-=residueqty;
+				residueqty = 0;
+			}
+			else { //entire entry must be relayed from src to dest
+				if (bufcapacity[dest] <= bufsize[dest]) {
+					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
+					bufferpath[dest] = (struct BufItemPath *)realloc(bufferpath[dest], bufcapacity[dest]*2*sizeof(struct BufItemPath));
+					bufcapacity[dest] *= 2;
+				}
+				buffer[dest][bufsize[dest]] = buffer[src][bufsize[src]-1];
+				bufferpath[dest][bufsize[dest]] = bufferpath[src][bufsize[src]-1];
+				if (bufferpath[dest][bufsize[dest]].pathcapacity <=  bufferpath[dest][bufsize[dest]].pathlen) {
+					bufferpath[dest][bufsize[dest]].path = (int *)realloc(bufferpath[dest][bufsize[dest]].path,bufferpath[dest][bufsize[dest]].pathcapacity*2*sizeof(int));
+					bufferpath[dest][bufsize[dest]].pathcapacity *= 2;
+				}
+				bufferpath[dest][bufsize[dest]].path[bufferpath[dest][bufsize[dest]].pathlen++]=src;
+				bufsize[dest]++;
+				
+				residueqty-=buffer[src][bufsize[src]-1].qty;				
+				bufsize[src]--; // implicitly removes top element (no need to implement this explicitly - MEMORY LEAK)
+			}
+		}
+		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
+		{	
+			numtransfers++;
+			newentry.origin = src;
+			newentry.ts = inter[i].ts; // not used
+			newentry.qty = residueqty;
+			newpathentry.pathlen = 0; // new path (origin always defines first node of path)
+			newpathentry.pathcapacity = 3;
+			newpathentry.path = (int *)malloc(newpathentry.pathcapacity*sizeof(int));
+			if (bufcapacity[dest] <= bufsize[dest]) {
+				buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
+				bufferpath[dest] = (struct BufItemPath *)realloc(bufferpath[dest], bufcapacity[dest]*2*sizeof(struct BufItemPath));
+				bufcapacity[dest] *= 2;
+			}
+			buffer[dest][bufsize[dest]] = newentry;
+			bufferpath[dest][bufsize[dest]++] = newpathentry;
+		}
+		movesum(sumbuffered,src,dest,inter[i].qty);
+	}
+
+	s->numtransfers += numtransfers;
+	
+    return 0;
+}
+
+
+// bytes of the buffer of vertex v (4, 101)
+static inline long long nodebytes(struct ProvState *s, int v)
+{
+	return (long long)s->bufcapacity[v]*(s->method==4 ? sizeof(struct BufItem) : sizeof(struct BufItemProp));
+}
+
+// encodes quantity q of a compressed buffer at p; returns the number of bytes
+// quantities are varints with a quantum (lossy) or integer quantities (PROV_INTQTY), and raw doubles otherwise
+static inline int packqty(struct ProvState *s, unsigned char *p, qty_t q)
+{
+	double x = q;
+	
+	if (s->quantum>0)
+		return bsPutVarint(p,bsZigzag(llround(q/s->quantum)));
+	if (QTY_INTEGER)
+		return bsPutVarint(p,bsZigzag((long long)q));
+	memcpy(p,&x,sizeof(double));
+	return sizeof(double);
+}
+
+static inline qty_t unpackqty(struct ProvState *s, const unsigned char **p)
+{
+	double x;
+	
+	if (s->quantum>0)
+		return qtyround(bsUnzigzag(bsGetVarint(p))*s->quantum);
+	if (QTY_INTEGER)
+		return (qty_t)bsUnzigzag(bsGetVarint(p));
+	memcpy(&x,*p,sizeof(double));
+	*p += sizeof(double);
+	return x;
+}
+
+// compresses the buffer of vertex v into the store and frees it (4, 101 with compression of cold buffers)
+// origins are delta-encoded against the previous item: sorted (101), they mostly take a byte each
+// the items of a queue (4) keep their order; integral timestamps are delta-encoded against the previous
+// integral one, others are kept raw after a marker
+static void packnode(struct ProvState *s, int v)
+{
+	unsigned char *p = bsScratch(s->store,(long long)s->bufsize[v]*PACK_MAXITEM);
+	int j,k,len = 0;
+	int prev = 0;
+	double prevts = 0;
+	struct BufItem *item;
+	
+	if (s->method==4) {
+		for(j=0,k=s->buflast[v];j<s->bufsize[v];j++,k=(k+1)%s->bufcapacity[v]) {
+			item = &s->buffer[v][k];
+			len += bsPutVarint(p+len,bsZigzag((long long)item->origin-prev));
+			prev = item->origin;
+			if (fabs(item->ts)<PACK_MAXTS && item->ts==(double)(long long)item->ts) {
+				len += bsPutVarint(p+len,bsZigzag((long long)item->ts-(long long)prevts)<<1);
+				prevts = item->ts;
+			}
+			else {
+				len += bsPutVarint(p+len,1);
+				memcpy(p+len,&item->ts,sizeof(double));
+				len += sizeof(double);
+			}
+			len += packqty(s,p+len,item->qty);
+		}
+		free(s->buffer[v]);
+		s->buffer[v] = NULL;
+		bsPack(s->store,v,len,(long long)s->bufsize[v]*sizeof(struct BufItem));
+	}
+	else {
+		for(j=0;j<s->bufsize[v];j++) {
+			len += bsPutVarint(p+len,bsZigzag((long long)s->propbuffer[v][j].origin-prev));
+			prev = s->propbuffer[v][j].origin;
+			len += packqty(s,p+len,s->propbuffer[v][j].qty);
+		}
+		free(s->propbuffer[v]);
+		s->propbuffer[v] = NULL;
+		bsPack(s->store,v,len,(long long)s->bufsize[v]*sizeof(struct BufItemProp));
+	}
+}
+
+// decodes the compressed buffer of vertex v into buf, which has room for its items (see packnode)
+static void unpacknode(struct ProvState *s, int v, void *buf)
+{
+	const unsigned char *p = s->store->packed[v];
+	struct BufItem *items = (struct BufItem *)buf;
+	struct BufItemProp *propitems = (struct BufItemProp *)buf;
+	unsigned long long code;
+	int j;
+	int prev = 0;
+	double prevts = 0;
+	
+	for(j=0;j<s->bufsize[v];j++) {
+		prev += bsUnzigzag(bsGetVarint(&p));
+		if (s->method==4) {
+			items[j].origin = prev;
+			code = bsGetVarint(&p);
+			if (code&1) {
+				memcpy(&items[j].ts,p,sizeof(double));
+				p += sizeof(double);
+			}
+			else {
+				prevts = (double)((long long)prevts+bsUnzigzag(code>>1));
+				items[j].ts = prevts;
+			}
+			items[j].qty = unpackqty(s,&p);
+		}
+		else {
+			propitems[j].origin = prev;
+			propitems[j].qty = unpackqty(s,&p);
+		}
+	}
+	bsUnpack(s->store,v,(long long)s->bufsize[v]*(s->method==4 ? sizeof(struct BufItem) : sizeof(struct BufItemProp)));
+}
+
+// makes the buffer of vertex v resident, reloading it from the spill file or decompressing it,
+// and marks it as the most recently used (4, 101 with a store); the items of a reloaded queue (4) start at position 0
+// if the buffer cannot be read back, it is left empty and -1 is returned
+static int loadnode(struct ProvState *s, int v)
+{
+	size_t itemsize = s->method==4 ? sizeof(struct BufItem) : sizeof(struct BufItemProp);
+	void *buf;
+	int ret = 0;
+	
+	if (s->store->state[v]!=BS_RESIDENT) {
+		buf = malloc(s->bufcapacity[v]*itemsize);
+		if (s->store->state[v]==BS_PACKED)
+			unpacknode(s,v,buf);
+		else if (bsLoad(s->store,v,buf,(long long)s->bufsize[v]*itemsize)==-1) {
+			s->store->state[v] = BS_RESIDENT;
+			s->bufsize[v] = 0;
+			ret = -1;
+		}
+		if (s->method==4) {
+			s->buffer[v] = (struct BufItem *)buf;
+			s->buflast[v] = 0;
+			s->buffirst[v] = s->bufsize[v]%s->bufcapacity[v];
+		}
+		else
+			s->propbuffer[v] = (struct BufItemProp *)buf;
+	}
+	bsTouch(s->store,v,nodebytes(s,v));
+	return ret;
+}
+
+// compresses the buffers that have not been used for s->coldafter interactions, then spills the least recently
+// used buffers to the spill file until the resident ones fit in the memory budget (4, 101)
+// the buffers of pin1 and pin2 (-1: none) are marked as the most recently used first, and kept
+static int spillnodes(struct ProvState *s, int pin1, int pin2)
+{
+	int v,n1;
+	int ret = 0;
+	
+	if (pin1>=0)
+		bsTouch(s->store,pin1,nodebytes(s,pin1));
+	if (pin2>=0)
+		bsTouch(s->store,pin2,nodebytes(s,pin2));
+	if (s->coldafter>0)
+		while ((v = bsCold(s->store,s->coldafter))!=-1)
+			packnode(s,v);
+	while (ret==0 && (v = bsVictim(s->store,pin1,pin2))!=-1) {
+		if (s->method==4) {
+			// queue items in queue order, starting from buflast
+			n1 = s->bufcapacity[v]-s->buflast[v];
+			if (n1>s->bufsize[v])
+				n1 = s->bufsize[v];
+			ret = bsSpill(s->store,v,s->buffer[v]+s->buflast[v],n1*sizeof(struct BufItem),
+				s->buffer[v],(s->bufsize[v]-n1)*sizeof(struct BufItem));
+			free(s->buffer[v]);
+			s->buffer[v] = NULL;
+		}
+		else {
+			ret = bsSpill(s->store,v,s->propbuffer[v],s->bufsize[v]*sizeof(struct BufItemProp),NULL,0);
+			free(s->propbuffer[v]);
+			s->propbuffer[v] = NULL;
+		}
+	}
+	return ret;
+}
+
+// provenance FIFO model
+// first-in first out when propagating quantities
+// each node's buffer is managed as a FIFO queue 
+static int ProvFIFO(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    struct BufItem **buffer = s->buffer; // array of buffers, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+    qty_t *sumbuffered = s->sumbuffered; // total quantity of each buffer (see movesum)
+
+	int *buffirst = s->buffirst; // position to 1st item in buffer[i], initially 0
+	int *buflast = s->buflast; // position to last item in buffer[i], initially 0
+    
+	qty_t relayqty;
+	qty_t residueqty;
+	int src;
+	int dest;
+	struct BufItem newentry;
+	
+	int numtransfers = 0;
+	
+	for(i=0;i<numinter;i++)
+	{
+		residueqty=inter[i].qty; // remaining quantity to be transferred
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (s->store!=NULL && (loadnode(s,src)==-1 || loadnode(s,dest)==-1))
+			return -1;
+		if (src==dest) // self-loop: the buffered quantity stays at src (see movesum)
+			residueqty -= sumbuffered[src];
+		while (src!=dest && residueqty>0 && bufsize[src])
+		{
+			numtransfers++;
+			if (buffer[src][buflast[src]].qty>residueqty) { // buffer[src][buffirst[src]] is least recently added quantity (fifo queue first)
+				//printf("---------------\n");
+				//fifoprint(buffer[src],bufsize[src],buffirst[src],buflast[src],bufcapacity[src]);
+				newentry.origin = buffer[src][buflast[src]].origin;
+				newentry.ts = buffer[src][buflast[src]].ts; //not used
+				newentry.qty = residueqty;
+				//printf("new: %d, %f, %f\n",newentry.origin,newentry.ts,newentry.qty);
+				fifoenqueue(newentry,&buffer[dest],&bufsize[dest],&buffirst[dest],&buflast[dest],&bufcapacity[dest]);
+				buffer[src][buflast[src]].qty-=residueqty;
+				residueqty = 0;
+			}
+			else { //entire entry must be relayed from src to dest
+				fifodequeue(&newentry,buffer[src],&bufsize[src],&buflast[src],bufcapacity[src]);
+				fifoenqueue(newentry,&buffer[dest],&bufsize[dest],&buffirst[dest],&buflast[dest],&bufcapacity[dest]);
+				residueqty-=newentry.qty;
+			}
+		}
+		if (residueqty>0.0000001) // src did not have enough buffered quantity to relay; give birth to new flow item
+		{	
+			numtransfers++;
+			newentry.origin = src;
+			newentry.ts = inter[i].ts;
+			newentry.qty = residueqty;
+			fifoenqueue(newentry,&buffer[dest],&bufsize[dest],&buffirst[dest],&buflast[dest],&bufcapacity[dest]);
+		}
+		if (s->store!=NULL) {
+			s->store->clock++;
+			if (spillnodes(s,src,dest)==-1)
+				return -1;
+		}
+		movesum(sumbuffered,src,dest,inter[i].qty);
+	}
+
+	s->numtransfers += numtransfers;
+	
+    return 0;
+}
+
+
+// add new item to buffer
+// if item with same origin exists, update quantity
+// fix order of buffer items (based on origin) using an insertion-sort order
+static int addnewitem(struct BufItemProp *buffer, int *bufsize, struct BufItemProp newentry)
+{
+	int low=0, hi = (*bufsize)-1;
+	int key = newentry.origin;
+	int pos;
+	
+	// binary search for newentry
+	while (low <= hi){
+      int middle = (low + hi)/2;
+      if (buffer[middle].origin == key) {
+      	buffer[middle].qty+=newentry.qty;
+      	return 0;
+      }
+      if (buffer[middle].origin < key)
+         low = middle + 1;
+      else
+         hi = middle - 1;
+   	}
+   	
+	// not found -> must be inserted
+	(*bufsize)++;
+	pos = (*bufsize)-2;
+	while (pos>=0 && buffer[pos].origin>key) {
+		buffer[pos+1]=buffer[pos];
+		pos--;
+	}
+	buffer[pos+1] = newentry;
+	
+	return 1;
+}
+
+// first position p>=lo of buf[0..n-1] with buf[p].origin>=key (n if none)
+// exponential search from lo, then binary search, so skipping r smaller origins costs O(log r)
+static int gallop(struct BufItemProp *buf, int lo, int n, int key)
+{
+	int middle, step = 1, hi = lo;
+	
+	while (hi<n && buf[hi].origin<key) {
+		lo = hi+1;
+		hi += step;
+		step *= 2;
+	}
+	if (hi>n)
+		hi = n;
+	// all origins before lo are smaller than key, buf[hi] (if any) is not
+	while (lo<hi) {
+		middle = (lo+hi)/2;
+		if (buf[middle].origin<key)
+			lo = middle+1;
+		else
+			hi = middle;
+	}
+	return lo;
+}
+
+// number of origins found in both sorted buffers a and b
+// if one buffer is much smaller, its origins are looked up in the other by galloping;
+// otherwise blocks of 4 origins of each buffer are compared all against all with SSE2
+static int countcommon(struct BufItemProp *a, int na, struct BufItemProp *b, int nb)
+{
+	int i = 0, j = 0, count = 0;
+	int amax, bmax;
+	struct BufItemProp *t;
+	
+	if (na>nb) {
+		t = a; a = b; b = t;
+		j = na; na = nb; nb = j;
+		j = 0;
+	}
+	if (na==0)
+		return 0;
+	if (GALLOP_RATIO*na<nb) {
+		for(i=0;i<na && j<nb;i++) {
+			j = gallop(b,j,nb,a[i].origin);
+			if (j<nb && b[j].origin==a[i].origin) {
+				count++;
+				j++;
+			}
+		}
+		return count;
+	}
+#ifdef __SSE2__
+	while (i+4<=na && j+4<=nb) {
+		// the origin is the first 32 bits of an item: gather the origins of 4 items into a vector
+		__m128i va = _mm_unpacklo_epi64(
+			_mm_unpacklo_epi32(_mm_loadu_si128((__m128i *)&a[i]),_mm_loadu_si128((__m128i *)&a[i+1])),
+			_mm_unpacklo_epi32(_mm_loadu_si128((__m128i *)&a[i+2]),_mm_loadu_si128((__m128i *)&a[i+3])));
+		__m128i vb = _mm_unpacklo_epi64(
+			_mm_unpacklo_epi32(_mm_loadu_si128((__m128i *)&b[j]),_mm_loadu_si128((__m128i *)&b[j+1])),
+			_mm_unpacklo_epi32(_mm_loadu_si128((__m128i *)&b[j+2]),_mm_loadu_si128((__m128i *)&b[j+3])));
+		__m128i m = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi32(va,vb),_mm_cmpeq_epi32(va,_mm_shuffle_epi32(vb,_MM_SHUFFLE(0,3,2,1)))),
+			_mm_or_si128(_mm_cmpeq_epi32(va,_mm_shuffle_epi32(vb,_MM_SHUFFLE(1,0,3,2))),_mm_cmpeq_epi32(va,_mm_shuffle_epi32(vb,_MM_SHUFFLE(2,1,0,3)))));
+		count += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(m)));
+		// a block whose last origin is not larger than the other's has no more matches
+		amax = a[i+3].origin;
+		bmax = b[j+3].origin;
+		if (amax<=bmax)
+			i += 4;
+		if (bmax<=amax)
+			j += 4;
+	}
+#endif
+	while (i<na && j<nb) {
+		if (a[i].origin<b[j].origin)
+			i++;
+		else if (a[i].origin>b[j].origin)
+			j++;
+		else {
+			count++;
+			i++; j++;
+		}
+	}
+	return count;
+}
+
+// merge-join of the sorted buffers src and dest into out, which must have room for the result; returns its size
+// if all is set, all quantity of src is added to dest; otherwise qty out of the sum buffered at src is
+// transferred, proportionally from each origin of src, and the items of src are reduced accordingly
+// if src is much smaller than dest, the runs of dest between consecutive origins of src are found by
+// galloping and copied with memcpy, so the merge takes O(|src| log |dest|) comparisons
+static int mergeprop(struct BufItemProp *src, int ns, struct BufItemProp *dest, int nd, struct BufItemProp *out, qty_t qty, qty_t sum, int all)
+{
+	int a = 0, b = 0, p, n = 0;
+	qty_t transqty, rest = sum;
+	
+	if (GALLOP_RATIO*ns<nd) {
+		for(a=0;a<ns;a++) {
+			p = gallop(dest,b,nd,src[a].origin);
+			memcpy(out+n,dest+b,(p-b)*sizeof(struct BufItemProp));
+			n += p-b;
+			b = p;
+			transqty = all ? src[a].qty : propshare(qty,src[a].qty,&rest,sum);
+			out[n].origin = src[a].origin;
+			if (b<nd && dest[b].origin==src[a].origin)
+				out[n++].qty = transqty+dest[b++].qty;
+			else
+				out[n++].qty = transqty;
+			if (!all)
+				src[a].qty -= transqty;
+		}
+	}
+	else {
+		while (a<ns && b<nd) {
+			if (src[a].origin>dest[b].origin) {
+				out[n++] = dest[b++];
+				continue;
+			}
+			transqty = all ? src[a].qty : propshare(qty,src[a].qty,&rest,sum);
+			out[n].origin = src[a].origin;
+			if (src[a].origin==dest[b].origin)
+				out[n++].qty = transqty+dest[b++].qty;
+			else
+				out[n++].qty = transqty;
+			if (!all)
+				src[a].qty -= transqty;
+			a++;
+		}
+		for(;a<ns;a++) {
+			transqty = all ? src[a].qty : propshare(qty,src[a].qty,&rest,sum);
+			out[n].origin = src[a].origin;
+			out[n++].qty = transqty;
+			if (!all)
+				src[a].qty -= transqty;
+		}
+	}
+	memcpy(out+n,dest+b,(nd-b)*sizeof(struct BufItemProp));
+	return n+nd-b;
+}
+
+// exchanges buffer a (with its size and capacity) with buffer b
+static void swapbuffers(struct BufItemProp **a, int *asize, int *acapacity, struct BufItemProp **b, int *bsize, int *bcapacity)
+{
+	struct BufItemProp *t = *a;
+	int n;
+	
+	*a = *b;
+	*b = t;
+	n = *asize; *asize = *bsize; *bsize = n;
+	n = *acapacity; *acapacity = *bcapacity; *bcapacity = n;
+}
+
+// self-loop of quantity qty at a node with buffer *buf: the buffered quantity stays at the node, and only
+// the part of qty that was not buffered is born, with the given origin (as in 102 and model 0)
+// leaves room for one more item in the buffer, as mergeinto
+static void selfloop(struct BufItemProp **buf, int *size, int *capacity, qty_t *sumbuffered, int origin, qty_t qty)
+{
+	struct BufItemProp newentry;
+	
+	if (qty-*sumbuffered<=QTY_EPS)
+		return;
+	if (*capacity < *size+2) {
+		*capacity *= 2;
+		if (*capacity < *size+2)
+			*capacity = *size+2;
+		*buf = (struct BufItemProp *)realloc(*buf, (*capacity)*sizeof(struct BufItemProp));
+	}
+	newentry.origin = origin;
+	newentry.qty = qty-*sumbuffered;
+	addnewitem(*buf, size, newentry);
+	*sumbuffered = qty;
+}
+
+// merges the sorted buffer src into the sorted buffer *dest of size *nd and capacity *capacity in place,
+// with the quantities of mergeprop; the capacity is doubled when the new origins do not fit, and always
+// leaves room for one more item
+// origins already in dest only have their quantities updated; new origins are merged from the back into
+// the spare space, so only the items of dest larger than the smallest new origin are moved
+static void mergeinto(struct BufItemProp *src, int ns, struct BufItemProp **dest, int *nd, int *capacity, qty_t qty, qty_t sum, int all)
+{
+	struct BufItemProp *buf;
+	int a, b, j, p, w, numnew, found;
+	qty_t transqty, rest = sum, restrev = sum;
+	
+	// the shares of the new origins are given out from the back (see propsharerev)
+	if (QTY_INTEGER && !all)
+		for(a=0;a<ns;a++)
+			restrev -= src[a].qty;
+	numnew = ns-countcommon(src,ns,*dest,*nd);
+	if (*capacity < *nd+numnew+1) {
+		*capacity *= 2;
+		if (*capacity < *nd+numnew+1)
+			*capacity = *nd+numnew+1;
+		*dest = (struct BufItemProp *)realloc(*dest, (*capacity)*sizeof(struct BufItemProp));
+	}
+	buf = *dest;
+	
+	// from the back, while new origins remain: buf[0..j] are the items not moved yet, buf[w+1..] the merged tail
+	j = *nd-1;
+	w = *nd+numnew-1;
+	for(a=ns-1;w>j;a--) {
+		// first item of buf[0..j] whose origin is not smaller than the one of src[a]
+		if (GALLOP_RATIO*ns<*nd)
+			p = gallop(buf,0,j+1,src[a].origin);
+		else
+			for(p=j+1;p>0 && buf[p-1].origin>=src[a].origin;p--);
+		transqty = all ? src[a].qty : propsharerev(qty,src[a].qty,&restrev,sum);
+		if (!all)
+			src[a].qty -= transqty;
+		found = (p<=j && buf[p].origin==src[a].origin);
+		if (found)
+			buf[p].qty += transqty;
+		memmove(buf+w-(j-p),buf+p,(j-p+1)*sizeof(struct BufItemProp));
+		w -= j-p+1;
+		j = p-1;
+		if (!found) {
+			buf[w].origin = src[a].origin;
+			buf[w--].qty = transqty;
+		}
+	}
+	// the remaining origins of src are all in buf[0..j]: only their quantities change
+	for(p=0,b=0;p<=a;p++) {
+		b = gallop(buf,b,j+1,src[p].origin);
+		transqty = all ? src[p].qty : propshare(qty,src[p].qty,&rest,sum);
+		if (!all)
+			src[p].qty -= transqty;
+		buf[b++].qty += transqty;
+	}
+	*nd += numnew;
+}
+
+// folds the items of a sparse proportional buffer with quantity below the dust threshold of s into origin -1
+// sum is the total quantity of the buffer; the threshold is the larger of s->dustabs and s->dustrel*sum
+// buffer must be sorted by origin; it remains sorted; returns the new size of the buffer
+static int prunedust(struct ProvState *s, struct BufItemProp *buffer, int bufsize, qty_t sum)
+{
+	int i, n = 0;
+	double min = s->dustrel*sum;
+	qty_t dust = 0;
+	
+	if (min<s->dustabs)
+		min = s->dustabs;
+	for(i=0;i<bufsize;i++) {
+		if (buffer[i].origin!=-1 && buffer[i].qty<min) {
+			dust += buffer[i].qty;
+			continue;
+		}
+		buffer[n++] = buffer[i];
+	}
+	if (n==bufsize)
+		return n;
+	s->numpruned += bufsize-n;
+	s->prunedqty += dust;
+	if (n>0 && buffer[0].origin==-1) // -1 is the smallest origin
+		buffer[0].qty += dust;
+	else if (dust>0) {
+		memmove(buffer+1,buffer,n*sizeof(struct BufItemProp));
+		buffer[0].origin = -1;
+		buffer[0].qty = dust;
+		n++;
+	}
+	return n;
+}
+
+// prunes the buffers of node v of dust (see prunedust) if force is set or they have doubled in size
+// since they were last pruned, so that pruning takes amortized constant time per buffered item
+static void prunenode(struct ProvState *s, int v, int force)
+{
+	int size = s->bufsize[v] + (s->oddbuffer!=NULL ? s->oddbufsize[v] : 0);
+	
+	if (!force && size<s->dustmark[v])
+		return;
+	s->bufsize[v] = prunedust(s,s->propbuffer[v],s->bufsize[v],s->sumbuffered[v]);
+	size = s->bufsize[v];
+	if (s->oddbuffer!=NULL) {
+		s->oddbufsize[v] = prunedust(s,s->oddbuffer[v],s->oddbufsize[v],s->sumbuffered[v]);
+		size += s->oddbufsize[v];
+	}
+	s->dustmark[v] = 2*size>DUST_MINMARK ? 2*size : DUST_MINMARK;
+}
+
+// provenance proportional origin model
+// if transferred quantity is lower than buffered quantity 
+// then origins are picked proportionally
+// creation timestamps are ignored
+// Prov Sparse in paper
+// with groups (112), the origins are the finest groups (s->map) of the vertices, instead of the vertices
+static int ProvProportional(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i;
+
+    struct BufItemProp **buffer = s->propbuffer; // array of buffers, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i  
+	qty_t qty;
+
+	//double relayqty;
+	//double bufferedqty;
+	int src;
+	int dest;
+	struct BufItemProp newentry;
+	
+	for(i=0;i<numinter;i++)
+	{
+		if (s->store!=NULL && (loadnode(s,inter[i].src)==-1 || loadnode(s,inter[i].dest)==-1))
+			return -1;
+
+		if (inter[i].src==inter[i].dest)
+			selfloop(&buffer[inter[i].src],&bufsize[inter[i].src],&bufcapacity[inter[i].src],&sumbuffered[inter[i].src],s->map!=NULL ? s->map[inter[i].src] : inter[i].src,inter[i].qty);
+		else if (inter[i].qty>=sumbuffered[inter[i].src]) {
+			// case 1: just transfer everything to dest
+			// src is emptied, so if its buffer is the larger one the two buffers are swapped first
+			if (bufsize[inter[i].src]>bufsize[inter[i].dest])
+				swapbuffers(&buffer[inter[i].src],&bufsize[inter[i].src],&bufcapacity[inter[i].src],&buffer[inter[i].dest],&bufsize[inter[i].dest],&bufcapacity[inter[i].dest]);
+			// merge buffer[inter[i].src] into buffer[inter[i].dest]
+			mergeinto(buffer[inter[i].src],bufsize[inter[i].src],&buffer[inter[i].dest],&bufsize[inter[i].dest],&bufcapacity[inter[i].dest],0,0,1);
+				
+			bufsize[inter[i].src]=0;
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>QTY_EPS) {
+					// src did not have enough buffered quantity to relay; give birth to new flow item
+					newentry.origin = s->map!=NULL ? s->map[inter[i].src] : inter[i].src;
+					newentry.qty = qty;
+					//printf("newentry.qty=%.2f\n",newentry.qty);
+					if (bufsize[inter[i].dest]==0)
+						buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
+					else
+						addnewitem(buffer[inter[i].dest], &bufsize[inter[i].dest], newentry);
+					//buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
+			}
+			sumbuffered[inter[i].src] = 0;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		else {
+			// proportional case			
+			mergeinto(buffer[inter[i].src],bufsize[inter[i].src],&buffer[inter[i].dest],&bufsize[inter[i].dest],&bufcapacity[inter[i].dest],inter[i].qty,sumbuffered[inter[i].src],0);
+
+			sumbuffered[inter[i].src] -= inter[i].qty;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		if (s->dustmark!=NULL) {
+			// the items of src shrank, so src is pruned at once; dest only when it has grown enough
+			prunenode(s,inter[i].src,1);
+			prunenode(s,inter[i].dest,0);
+		}
+		if (s->store!=NULL) {
+			s->store->clock++;
+			if (spillnodes(s,inter[i].src,inter[i].dest)==-1)
+				return -1;
+		}
+				
+	}
+
+
+    return 0;
+}
+
+// same as ProvProportional, but the origins of each node are kept in a hybrid origin vector
+// (see originvec.c), whose representation follows its population: small inline arrays and sorted
+// arrays for the many nodes with few origins, hash tables or dense blocks for hubs
+static int ProvProportionalHybrid(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+	int i;
+	int src,dest;
+	struct OriginVec *vec = s->ovec;
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i
+	qty_t qty;
+	
+	for(i=0;i<numinter;i++)
+	{
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (src==dest) {
+			// quantity stays at the node; only the part that was not buffered is born
+			if (inter[i].qty-sumbuffered[src]>QTY_EPS) {
+				ovAdd(&vec[src], src, inter[i].qty-sumbuffered[src]);
+				sumbuffered[src] = inter[i].qty;
+			}
+			continue;
+		}
+		if (inter[i].qty>=sumbuffered[src]) {
+			// case 1: just transfer everything to dest
+			if (vec[dest].size==0)
+				ovMove(&vec[dest], &vec[src]);
+			else {
+				ovMerge(&vec[dest], &vec[src], 0, 0, 1);
+				ovClear(&vec[src]);
+			}
+			qty = inter[i].qty-sumbuffered[src];
+			if (qty>QTY_EPS) {
+				// src did not have enough buffered quantity to relay; give birth to new flow item
+				ovAdd(&vec[dest], src, qty);
+			}
+			sumbuffered[src] = 0;
+			sumbuffered[dest] += inter[i].qty;
+		}
+		else {
+			// proportional case
+			ovMerge(&vec[dest], &vec[src], inter[i].qty, sumbuffered[src], 0);
+			sumbuffered[src] -= inter[i].qty;
+			sumbuffered[dest] += inter[i].qty;
+		}
+	}
+	
+	return 0;
+}
+
+// applies to the buffers of node v the window resets since v was last touched (120)
+// v was not touched after the resets, so its buffered quantity is still the one at the time of the reset
+static void resetwindow(struct ProvState *s, int v)
+{
+	if (s->evenstamp[v]<s->evenreset) {
+		if (s->sumbuffered[v]>0) {
+			s->propbuffer[v][0].origin = -1;
+			s->propbuffer[v][0].qty = s->sumbuffered[v];
+			s->bufsize[v]=1;
+		}
+		s->evenstamp[v] = s->evenreset;
+	}
+	if (s->oddstamp[v]<s->oddreset) {
+		if (s->sumbuffered[v]>0) {
+			s->oddbuffer[v][0].origin = -1;
+			s->oddbuffer[v][0].qty = s->sumbuffered[v];
+			s->oddbufsize[v]=1;
+		}
+		s->oddstamp[v] = s->oddreset;
+	}
+}
+
+// Sameas ProvProportional but
+// keeps a window of provenance info up to 2*W interactions back
+// next window is initiated every W interactions
+static int ProvProportionalWindow(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,k;
+
+    int W = s->W; // window size
+    struct BufItemProp **buffer = s->propbuffer; // array of buffers, one for each node of the Graph
+    int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i  
+	qty_t qty;
+
+	// this is for odd windows
+    struct BufItemProp **oddbuffer = s->oddbuffer; // array of buffers, one for each node of the Graph
+    int *oddbufcapacity = s->oddbufcapacity; // capacity of each buffer, initially 3
+    int *oddbufsize = s->oddbufsize; // number of items in each buffer, initially 0
+
+	//double relayqty;
+	//double bufferedqty;
+	int src;
+	int dest;
+	struct BufItemProp newentry;
+	
+	for(i=0;i<numinter;i++)
+	{		
+		k = s->numprocessed+i; // position of interaction in the whole stream
+		if(!(k%W)) {
+			// the buffers of each node are reset when the node is next touched (see resetwindow)
+			if (!(k%(W*2)))
+				s->evenreset = k;
+			else
+				s->oddreset = k;
+		}
+		resetwindow(s, inter[i].src);
+		resetwindow(s, inter[i].dest);
+
+		//printf("buffqty:%.2f\n",bufferedqty);
+		if (inter[i].src==inter[i].dest) {
+			qty = sumbuffered[inter[i].src];
+			selfloop(&buffer[inter[i].src],&bufsize[inter[i].src],&bufcapacity[inter[i].src],&qty,inter[i].src,inter[i].qty);
+			selfloop(&oddbuffer[inter[i].src],&oddbufsize[inter[i].src],&oddbufcapacity[inter[i].src],&sumbuffered[inter[i].src],inter[i].src,inter[i].qty);
+		}
+		else if (inter[i].qty>=sumbuffered[inter[i].src]) {
+			// case 1: just transfer everything to dest
+			// src is emptied, so if its buffer is the larger one the two buffers are swapped first
+			if (bufsize[inter[i].src]>bufsize[inter[i].dest])
+				swapbuffers(&buffer[inter[i].src],&bufsize[inter[i].src],&bufcapacity[inter[i].src],&buffer[inter[i].dest],&bufsize[inter[i].dest],&bufcapacity[inter[i].dest]);
+			// merge buffer[inter[i].src] into buffer[inter[i].dest]
+			mergeinto(buffer[inter[i].src],bufsize[inter[i].src],&buffer[inter[i].dest],&bufsize[inter[i].dest],&bufcapacity[inter[i].dest],0,0,1);
+			
+			// repeat for oddbuffers
+			
+			// src is emptied, so if its buffer is the larger one the two buffers are swapped first
+			if (oddbufsize[inter[i].src]>oddbufsize[inter[i].dest])
+				swapbuffers(&oddbuffer[inter[i].src],&oddbufsize[inter[i].src],&oddbufcapacity[inter[i].src],&oddbuffer[inter[i].dest],&oddbufsize[inter[i].dest],&oddbufcapacity[inter[i].dest]);
+			// merge oddbuffer[inter[i].src] into oddbuffer[inter[i].dest]
+			mergeinto(oddbuffer[inter[i].src],oddbufsize[inter[i].src],&oddbuffer[inter[i].dest],&oddbufsize[inter[i].dest],&oddbufcapacity[inter[i].dest],0,0,1);
+				
+			bufsize[inter[i].src]=0;
+			oddbufsize[inter[i].src]=0;
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>QTY_EPS) {
+					// src did not have enough buffered quantity to relay; give birth to new flow item
+					newentry.origin = inter[i].src;
+					newentry.qty = qty;
+					if (bufsize[inter[i].dest]==0)
+						buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
+					else
+						addnewitem(buffer[inter[i].dest], &bufsize[inter[i].dest], newentry);
+	
+					// src did not have enough buffered quantity to relay; give birth to new flow item
+					if (oddbufsize[inter[i].dest]==0)
+						oddbuffer[inter[i].dest][oddbufsize[inter[i].dest]++] = newentry;
+					else
+						addnewitem(oddbuffer[inter[i].dest], &oddbufsize[inter[i].dest], newentry);
+			}
+
+			sumbuffered[inter[i].src] = 0;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		else {
+			// proportional case			
+
+			mergeinto(buffer[inter[i].src],bufsize[inter[i].src],&buffer[inter[i].dest],&bufsize[inter[i].dest],&bufcapacity[inter[i].dest],inter[i].qty,sumbuffered[inter[i].src],0);
+			
+
+			// proportional case	
+			// repeat for odd buffers		
+
+			mergeinto(oddbuffer[inter[i].src],oddbufsize[inter[i].src],&oddbuffer[inter[i].dest],&oddbufsize[inter[i].dest],&oddbufcapacity[inter[i].dest],inter[i].qty,sumbuffered[inter[i].src],0);
+
+
+			sumbuffered[inter[i].src] -= inter[i].qty;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		if (s->dustmark!=NULL) {
+			prunenode(s,inter[i].src,1);
+			prunenode(s,inter[i].dest,0);
+		}
+
+		
+	}
+
+    return 0;
+}
+
+// returns the k-th largest (k>=1) of the n values of qty, by quickselect; reorders qty
+static qty_t selectqty(qty_t *qty, int n, int k)
+{
+	int lo = 0, hi = n-1, mid, i, j;
+	qty_t pivot, tmp;
+	
+	k--; // position of the value in decreasing order
+	while (lo<hi) {
+		// median of three as pivot
+		mid = lo+(hi-lo)/2;
+		if (qty[mid]>qty[lo]) { tmp = qty[mid]; qty[mid] = qty[lo]; qty[lo] = tmp; }
+		if (qty[hi]>qty[lo]) { tmp = qty[hi]; qty[hi] = qty[lo]; qty[lo] = tmp; }
+		if (qty[hi]>qty[mid]) { tmp = qty[hi]; qty[hi] = qty[mid]; qty[mid] = tmp; }
+		pivot = qty[mid];
+		// qty[lo..j] >= pivot, qty[i..hi] <= pivot, qty[j+1..i-1] == pivot
+		i = lo; j = hi;
+		while (i<=j) {
+			while (qty[i]>pivot) i++;
+			while (qty[j]<pivot) j--;
+			if (i<=j) {
+				tmp = qty[i]; qty[i] = qty[j]; qty[j] = tmp;
+				i++; j--;
+			}
+		}
+		if (k<=j)
+			hi = j;
+		else if (k>=i)
+			lo = i;
+		else
+			return qty[k];
+	}
+	return qty[k];
+}
+
+// keeps the top-reducedsize items of buffer (sorted by origin), in origin order, and returns the sum of the others
+// among items with equal quantities, the ones with smaller origins are kept
+// qty is scratch space for bufsize values
+static qty_t keeptopqty(struct BufItemProp *buffer, int bufsize, int reducedsize, qty_t *qty)
+{
+	int i,j,numties;
+	qty_t threshold, residueqty = 0.0;
+	
+	for(i=0;i<bufsize;i++)
+		qty[i] = buffer[i].qty;
+	threshold = selectqty(qty,bufsize,reducedsize);
+	numties = reducedsize; // number of kept items with quantity equal to threshold
+	for(i=0;i<bufsize;i++)
+		if (buffer[i].qty>threshold)
+			numties--;
+	for(i=j=0;i<bufsize;i++)
+		if (buffer[i].qty>threshold || (buffer[i].qty==threshold && numties-- > 0))
+			buffer[j++] = buffer[i];
+		else
+			residueqty += buffer[i].qty;
+	return residueqty;
+}
+
+// shrink a sparse proportional buffer to keep only the top-reducedsize elements 
+// puts total deleted qty in -1 (artificial) vertex
+// buffer must be sorted by origin; it remains sorted, so only linear-time selection is needed
+static int shrinkbuffer(struct BufItemProp *buffer, int bufsize, int reducedsize, qty_t *qty)
+{
+	qty_t residueqty;
+	
+	if (bufsize<=reducedsize)
+		return bufsize;
+	residueqty = keeptopqty(buffer,bufsize,reducedsize,qty);
+	if (buffer[0].origin == -1) // -1 is the smallest origin
+		buffer[0].qty += residueqty;
+	else {
+		memmove(buffer+1,buffer,reducedsize*sizeof(struct BufItemProp));
+		buffer[0].origin = -1;
+		buffer[0].qty = residueqty;
+		reducedsize++;
+	}
+	return reducedsize;
+}
+
+// same as ProvProportional, but takes as input a budget B for the buffer vector of each node
+// if the budget is reached then (budget-reduced) of the buffer entries with the smallest quantities are
+// assumed to originate from the vertex itself, in order to make room 
+static int ProvProportionalBudget(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    int budget = s->budget; // budget for the buffer vector of each node
+    int reducedsize = s->reducedsize; // size of buffer vector after shrinking
+    struct BufItemProp **buffer = s->propbuffer; // array of buffers, one for each node of the Graph
+    int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i  
+	qty_t qty;
+
+	int *lastbufshrink = s->lastbufshrink; // marks last time each provenance info is shrunk at each node   
+	int *numbufshrinks = s->numbufshrinks; // marks number of times provenance info is shrunk at each node   
+
+	// for merging    
+	int numelem;
+	struct BufItemProp *newbuffer = s->newbuffer;
+
+	//double relayqty;
+	//double bufferedqty;
+	int src;
+	int dest;
+	struct BufItemProp newentry;
+	
+	for(i=0;i<numinter;i++)
+	{
+		k = s->numprocessed+(s->batchpos!=NULL ? s->batchpos[i] : i); // position of interaction in the whole stream
+		if (inter[i].src==inter[i].dest) {
+			// self-loop: the buffered quantity stays, and only the part that was not buffered is born (see selfloop)
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>QTY_EPS) {
+				newentry.origin = inter[i].src;
+				newentry.qty = qty;
+				numelem = mergeprop(&newentry,1,buffer[inter[i].dest],bufsize[inter[i].dest],newbuffer,0,0,1);
+				if (numelem>budget)
+				{
+					numelem = shrinkbuffer(newbuffer,numelem,reducedsize,s->shrinkqty);
+					lastbufshrink[inter[i].dest]=k; // mark time of buffer shrinking (i.e., info loss)
+					numbufshrinks[inter[i].dest]++; 
+				}
+				for(j=0;j<numelem;j++)
+					buffer[inter[i].dest][j] = newbuffer[j];
+				bufsize[inter[i].dest] = numelem;
+				sumbuffered[inter[i].dest] = inter[i].qty;
+			}
+			continue;
+		}
+		if (inter[i].qty>=sumbuffered[inter[i].src]) {
+			// case 1: just transfer everything to dest
+			if (bufsize[inter[i].dest]==0) {
+				if (bufsize[inter[i].src]+1 > budget) {
+					// copy to new buffer
+					for(j=0;j<bufsize[inter[i].src];j++)
+						newbuffer[j] = buffer[inter[i].src][j];
+					
+					// shrink newbuffer by keeping top-reducedsize quantities and put total residue to inter[i].dest 
+					numelem = shrinkbuffer(newbuffer,bufsize[inter[i].src],reducedsize,s->shrinkqty);
+					lastbufshrink[inter[i].dest]=k; // mark time of buffer shrinking (i.e., info loss)
+					numbufshrinks[inter[i].dest]++; 
+					
+					for(j=0;j<numelem;j++)
+						buffer[inter[i].dest][j] = newbuffer[j];
+					bufsize[inter[i].dest] = numelem;
+				}
+				else {
+					//just copy all to dest
+					for(j=0;j<bufsize[inter[i].src];j++)
+						buffer[inter[i].dest][j] = buffer[inter[i].src][j];
+					bufsize[inter[i].dest] = bufsize[inter[i].src];
+				}
+			}
+			else
+			{
+				// merge buffer[inter[i].src] into buffer[inter[i].dest]
+				numelem = mergeprop(buffer[inter[i].src],bufsize[inter[i].src],buffer[inter[i].dest],bufsize[inter[i].dest],newbuffer,0,0,1);
+				
+				if (numelem>budget-1)
+				{
+					numelem = shrinkbuffer(newbuffer,numelem,reducedsize,s->shrinkqty);
+					lastbufshrink[inter[i].dest]=k; // mark time of buffer shrinking (i.e., info loss)
+					numbufshrinks[inter[i].dest]++; 	
+				}
+				
+				for(j=0;j<numelem;j++)
+					buffer[inter[i].dest][j] = newbuffer[j];
+				bufsize[inter[i].dest] = numelem;
+			}	
+				
+			bufsize[inter[i].src]=0;
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>QTY_EPS) {
+					// src did not have enough buffered quantity to relay; give birth to new flow item
+					newentry.origin = inter[i].src;
+					newentry.qty = qty;
+					if (bufsize[inter[i].dest]==0)
+						buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
+					else
+						addnewitem(buffer[inter[i].dest], &bufsize[inter[i].dest], newentry);
+			}
+			sumbuffered[inter[i].src] = 0;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		else {
+			// proportional case			
+			// merge into dest buffer
+			numelem = mergeprop(buffer[inter[i].src],bufsize[inter[i].src],buffer[inter[i].dest],bufsize[inter[i].dest],newbuffer,inter[i].qty,sumbuffered[inter[i].src],0);
+			
+			if (numelem>budget)
+			{
+				// shrink newbuffer by keeping top-reducedsize quantities and put total residue to inter[i].dest 
+				numelem = shrinkbuffer(newbuffer,numelem,reducedsize,s->shrinkqty);
+				lastbufshrink[inter[i].dest]=k; // mark time of buffer shrinking (i.e., info loss)
+				numbufshrinks[inter[i].dest]++; 
+			}
+			
+			for(j=0;j<numelem;j++)
+				buffer[inter[i].dest][j] = newbuffer[j];
+			bufsize[inter[i].dest] = numelem;
+			
+			sumbuffered[inter[i].src] -= inter[i].qty;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		
+	}
+
+
+    return 0;
+}
+
+
+// reduces a sketch buffer (sorted by origin, with at most one entry of origin -1) to at most k counters,
+// as a mergeable Misra-Gries summary: the (k+1)-th largest counter c is subtracted from all counters,
+// counters that become non-positive are dropped, and all subtracted quantity is moved to the -1 entry
+// returns the new size of buffer; *err is increased by c
+// qty is scratch space for bufsize values
+static int reducesketch(struct BufItemProp *buffer, int bufsize, int k, double *err, qty_t *qty)
+{
+	int i,j,first,numcounters;
+	qty_t c, removed = 0.0;
+	
+	first = (bufsize>0 && buffer[0].origin==-1); // the -1 entry is not a counter
+	numcounters = bufsize-first;
+	if (numcounters<=k)
+		return bufsize;
+	for(i=first;i<bufsize;i++)
+		qty[i-first] = buffer[i].qty;
+	c = selectqty(qty,numcounters,k+1);
+	for(i=j=first;i<bufsize;i++)
+		if (buffer[i].qty>c) {
+			buffer[j] = buffer[i];
+			buffer[j++].qty -= c;
+			removed += c;
+		}
+		else
+			removed += buffer[i].qty;
+	*err += c;
+	if (first)
+		buffer[0].qty += removed;
+	else {
+		memmove(buffer+1,buffer,j*sizeof(struct BufItemProp));
+		buffer[0].origin = -1;
+		buffer[0].qty = removed;
+		j++;
+	}
+	return j;
+}
+
+// keeps the k counters of buffer (sorted by origin) with the largest quantities and folds the others into the -1 entry (125)
+// unlike reducesketch, the kept counters lose nothing; a dropped origin loses at most the largest dropped quantity,
+// which is added to *err
+// qty is scratch space for bufsize values
+static int truncatesketch(struct BufItemProp *buffer, int bufsize, int k, double *err, qty_t *qty)
+{
+	int i,first,numcounters;
+	qty_t residueqty;
+	
+	first = (bufsize>0 && buffer[0].origin==-1); // the -1 entry is not a counter
+	numcounters = bufsize-first;
+	if (numcounters<=k)
+		return bufsize;
+	for(i=first;i<bufsize;i++)
+		qty[i-first] = buffer[i].qty;
+	*err += selectqty(qty,numcounters,k+1); // largest dropped quantity
+	residueqty = keeptopqty(buffer+first,numcounters,k,qty);
+	if (first)
+		buffer[0].qty += residueqty;
+	else {
+		memmove(buffer+1,buffer,k*sizeof(struct BufItemProp));
+		buffer[0].origin = -1;
+		buffer[0].qty = residueqty;
+	}
+	return k+1;
+}
+
+// proportional provenance with a fixed-size heavy-hitter sketch per node
+// the buffer of each node keeps at most k=budget origins (counters) and an entry of origin -1 with the quantity
+// not attributed to any origin, so the total quantity is conserved
+// sketches are merged on each transfer (the relayed part of the src sketch is scaled proportionally) and reduced
+// back to k counters by reducesketch
+// the quantity q of a kept origin is an underestimate: the true quantity is in [q, q+sketcherr[node]];
+// origins not kept have quantity at most sketcherr[node]
+// the same engine keeps the top-k origins of each node (125), truncating merged sketches with truncatesketch:
+// the quantities of the heaviest origins are then more accurate, but the error bounds are not limited
+// by the total quantity over k+1 as for reducesketch
+static int ProvProportionalSketch(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+	int i,a,b,numelem;
+	int src,dest;
+	int k = s->budget; // number of counters per node
+	struct BufItemProp **buffer = s->propbuffer; // array of buffers, one for each node of the Graph
+	int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i
+	double *err = s->sketcherr; // error bound of each buffer
+	int *numbufshrinks = s->numbufshrinks; // number of reductions of each buffer
+	struct BufItemProp *newbuffer = s->newbuffer;
+	struct BufItemProp newentry;
+	qty_t transqty, qty, rest;
+	double transerr;
+	int all; // set if src relays all its buffered quantity
+	
+	for(i=0;i<numinter;i++)
+	{
+		src = inter[i].src;
+		dest = inter[i].dest;
+		if (src==dest) {
+			// self-loop: the buffered quantity stays, and only the part that was not buffered is born (see selfloop)
+			qty = inter[i].qty-sumbuffered[src];
+			if (qty>QTY_EPS) {
+				memcpy(newbuffer,buffer[src],bufsize[src]*sizeof(struct BufItemProp));
+				numelem = bufsize[src];
+				newentry.origin = src;
+				newentry.qty = qty;
+				addnewitem(newbuffer, &numelem, newentry);
+				if (numelem-(newbuffer[0].origin==-1) > k) {
+					if (s->method==125)
+						numelem = truncatesketch(newbuffer,numelem,k,&err[src],s->shrinkqty);
+					else
+						numelem = reducesketch(newbuffer,numelem,k,&err[src],s->shrinkqty);
+					numbufshrinks[src]++;
+				}
+				memcpy(buffer[src],newbuffer,numelem*sizeof(struct BufItemProp));
+				bufsize[src] = numelem;
+				sumbuffered[src] = inter[i].qty;
+			}
+			continue;
+		}
+		all = (inter[i].qty>=sumbuffered[src]);
+		rest = sumbuffered[src];
+		
+		// merge the relayed part of buffer[src] with buffer[dest] into newbuffer
+		numelem = 0;
+		a = b = 0;
+		while (a<bufsize[src] || b<bufsize[dest]) {
+			if (b==bufsize[dest] || (a<bufsize[src] && buffer[src][a].origin<buffer[dest][b].origin)) {
+				transqty = all ? buffer[src][a].qty : propshare(inter[i].qty,buffer[src][a].qty,&rest,sumbuffered[src]);
+				newbuffer[numelem].origin = buffer[src][a].origin;
+				newbuffer[numelem++].qty = transqty;
+				buffer[src][a++].qty -= transqty;
+			}
+			else if (a==bufsize[src] || buffer[src][a].origin>buffer[dest][b].origin)
+				newbuffer[numelem++] = buffer[dest][b++];
+			else {
+				transqty = all ? buffer[src][a].qty : propshare(inter[i].qty,buffer[src][a].qty,&rest,sumbuffered[src]);
+				newbuffer[numelem].origin = buffer[dest][b].origin;
+				newbuffer[numelem++].qty = transqty+buffer[dest][b++].qty;
+				buffer[src][a++].qty -= transqty;
+			}
+		}
+		
+		if (all) {
+			err[dest] += err[src];
+			err[src] = 0;
+			bufsize[src] = 0;
+			qty = inter[i].qty-sumbuffered[src];
+			if (qty>QTY_EPS) {
+				// src did not have enough buffered quantity to relay; give birth to new flow item
+				newentry.origin = src;
+				newentry.qty = qty;
+				addnewitem(newbuffer, &numelem, newentry);
+			}
+			sumbuffered[src] = 0;
+		}
+		else {
+			transerr = inter[i].qty*err[src]/sumbuffered[src];
+			err[dest] += transerr;
+			err[src] -= transerr;
+			sumbuffered[src] -= inter[i].qty;
+		}
+		sumbuffered[dest] += inter[i].qty;
+		
+		if (numelem-(numelem>0 && newbuffer[0].origin==-1) > k) { // more than k counters
+			if (s->method==125)
+				numelem = truncatesketch(newbuffer,numelem,k,&err[dest],s->shrinkqty);
+			else
+				numelem = reducesketch(newbuffer,numelem,k,&err[dest],s->shrinkqty);
+			numbufshrinks[dest]++;
+		}
+		memcpy(buffer[dest],newbuffer,numelem*sizeof(struct BufItemProp));
+		bufsize[dest] = numelem;
+	}
+	
+	return 0;
+}
+
+// moves the quantity of vertex v born before the time window of now to the -1 entry (123)
+// the quantity of an epoch expires when the whole epoch is out of the window
+// quantity is expired lazily, when v is touched, so only vertices with expired epochs are scanned
+static void expirewindow(struct ProvState *s, int v, double now)
+{
+	int i,j,first;
+	double E = s->T/s->numepochs; // epoch length
+	double limit = now-s->T; // epochs ending at or before limit expire
+	qty_t expired = 0.0;
+	double oldest = INFINITY;
+	struct BufItem *buf = s->buffer[v];
+	
+	if (s->oldest[v]+E > limit)
+		return;
+	first = (s->bufsize[v]>0 && buf[0].origin==-1);
+	for(i=j=first;i<s->bufsize[v];i++)
+		if (buf[i].ts+E <= limit)
+			expired += buf[i].qty;
+		else {
+			if (buf[i].ts<oldest)
+				oldest = buf[i].ts;
+			buf[j++] = buf[i];
+		}
+	s->oldest[v] = oldest;
+	if (first)
+		buf[0].qty += expired;
+	else if (j>0 || expired>0) {
+		if (s->bufcapacity[v] < j+1) {
+			s->bufcapacity[v] = j+1;
+			s->buffer[v] = buf = (struct BufItem *)realloc(buf, s->bufcapacity[v]*sizeof(struct BufItem));
+		}
+		memmove(buf+1,buf,j*sizeof(struct BufItem));
+		buf[0].origin = -1;
+		buf[0].ts = 0;
+		buf[0].qty = expired;
+		j++;
+	}
+	s->bufsize[v] = j;
+}
+
+// adds newentry to buffer, sorted by origin and epoch (ts)
+static int addnewepochitem(struct BufItem *buffer, int *bufsize, struct BufItem newentry)
+{
+	int pos = (*bufsize)-1;
+	
+	while (pos>=0 && (buffer[pos].origin>newentry.origin || (buffer[pos].origin==newentry.origin && buffer[pos].ts>newentry.ts)))
+		pos--;
+	if (pos>=0 && buffer[pos].origin==newentry.origin && buffer[pos].ts==newentry.ts) {
+		buffer[pos].qty += newentry.qty;
+		return 0;
+	}
+	memmove(buffer+pos+2,buffer+pos+1,((*bufsize)-pos-1)*sizeof(struct BufItem));
+	buffer[pos+1] = newentry;
+	(*bufsize)++;
+	return 1;
+}
+
+// proportional provenance within a sliding time window of length T
+// the buffer of each node has an entry per origin and epoch (of length T/numepochs) when the quantity was born,
+// sorted by origin and epoch; quantity born before the window is moved to origin -1, so the total quantity is conserved
+// (see expirewindow)
+static int ProvProportionalSlidingWindow(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+	int i,a,b,numelem;
+	int src,dest;
+	double E = s->T/s->numepochs; // epoch length
+	struct BufItem **buffer = s->buffer; // array of buffers, one for each node of the Graph
+	int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+	int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i
+	double *oldest = s->oldest;
+	struct BufItem *newbuffer;
+	struct BufItem newentry;
+	qty_t transqty, qty, rest;
+	int all; // set if src relays all its buffered quantity
+	
+	for(i=0;i<numinter;i++)
+	{
+		src = inter[i].src;
+		dest = inter[i].dest;
+		expirewindow(s, src, inter[i].ts);
+		expirewindow(s, dest, inter[i].ts);
+		if (src==dest) {
+			// self-loop: the buffered quantity stays, and only the part that was not buffered is born (see selfloop)
+			qty = inter[i].qty-sumbuffered[src];
+			if (qty>QTY_EPS) {
+				if (bufcapacity[src] < bufsize[src]+1) {
+					bufcapacity[src] = 2*(bufsize[src]+1);
+					buffer[src] = (struct BufItem *)realloc(buffer[src], bufcapacity[src]*sizeof(struct BufItem));
+				}
+				newentry.origin = src;
+				newentry.ts = floor(inter[i].ts/E)*E;
+				newentry.qty = qty;
+				addnewepochitem(buffer[src], &bufsize[src], newentry);
+				if (newentry.ts<oldest[src])
+					oldest[src] = newentry.ts;
+				sumbuffered[src] = inter[i].qty;
+			}
+			continue;
+		}
+		all = (inter[i].qty>=sumbuffered[src]);
+		rest = sumbuffered[src];
+		
+		if (s->mergecapacity < bufsize[src]+bufsize[dest]+1) {
+			s->mergecapacity = 2*(bufsize[src]+bufsize[dest]+1);
+			s->mergebuffer = (struct BufItem *)realloc(s->mergebuffer, s->mergecapacity*sizeof(struct BufItem));
+		}
+		newbuffer = s->mergebuffer;
+		
+		// merge the relayed part of buffer[src] with buffer[dest], by (origin, epoch)
+		numelem = 0;
+		a = b = 0;
+		while (a<bufsize[src] || b<bufsize[dest]) {
+			if (b==bufsize[dest] || (a<bufsize[src] && (buffer[src][a].origin<buffer[dest][b].origin 
+				|| (buffer[src][a].origin==buffer[dest][b].origin && buffer[src][a].ts<buffer[dest][b].ts)))) {
+				transqty = all ? buffer[src][a].qty : propshare(inter[i].qty,buffer[src][a].qty,&rest,sumbuffered[src]);
+				newbuffer[numelem] = buffer[src][a];
+				newbuffer[numelem++].qty = transqty;
+				buffer[src][a++].qty -= transqty;
+			}
+			else if (a==bufsize[src] || buffer[src][a].origin>buffer[dest][b].origin || buffer[src][a].ts>buffer[dest][b].ts)
+				newbuffer[numelem++] = buffer[dest][b++];
+			else {
+				transqty = all ? buffer[src][a].qty : propshare(inter[i].qty,buffer[src][a].qty,&rest,sumbuffered[src]);
+				newbuffer[numelem] = buffer[dest][b++];
+				newbuffer[numelem++].qty += transqty;
+				buffer[src][a++].qty -= transqty;
+			}
+		}
+		
+		qty = all ? inter[i].qty-sumbuffered[src] : 0;
+		if (qty>QTY_EPS) {
+			// src did not have enough buffered quantity to relay; give birth to new flow item, in the current epoch
+			newentry.origin = src;
+			newentry.ts = floor(inter[i].ts/E)*E;
+			newentry.qty = qty;
+			addnewepochitem(newbuffer, &numelem, newentry);
+			if (newentry.ts<oldest[dest])
+				oldest[dest] = newentry.ts;
+		}
+		
+		if (oldest[src]<oldest[dest])
+			oldest[dest] = oldest[src];
+		if (all) {
+			bufsize[src] = 0;
+			oldest[src] = INFINITY;
+			sumbuffered[src] = 0;
+		}
+		else
+			sumbuffered[src] -= inter[i].qty;
+		sumbuffered[dest] += inter[i].qty;
+		
+		if (bufcapacity[dest] < numelem) {
+			bufcapacity[dest] = numelem;
+			buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*sizeof(struct BufItem));
+		}
+		memcpy(buffer[dest],newbuffer,numelem*sizeof(struct BufItem));
+		bufsize[dest] = numelem;
+	}
+	
+	return 0;
+}
+
+// decays the quantities of known origin at vertex v from the last time it was decayed to now, by exp(-dt/T) (124)
+// the decayed quantity is moved to the -1 entry
+static void decaybuffer(struct ProvState *s, int v, double now)
+{
+	int i,first;
+	double f;
+	qty_t d, decayed = 0;
+	struct BufItemProp *buf = s->propbuffer[v];
+	
+	if (s->tlast[v]>=now) 
+		return;
+	if (s->bufsize[v]>0) {
+		f = exp(-(now-s->tlast[v])/s->T);
+		first = (buf[0].origin==-1);
+		for(i=first;i<s->bufsize[v];i++) {
+			d = qtyround(buf[i].qty*(1-f));
+			buf[i].qty -= d;
+			decayed += d;
+		}
+		if (first)
+			buf[0].qty += decayed;
+		else if (decayed>0) {
+			if (s->bufcapacity[v] < s->bufsize[v]+1) {
+				s->bufcapacity[v] = s->bufsize[v]+1;
+				s->propbuffer[v] = buf = (struct BufItemProp *)realloc(buf, s->bufcapacity[v]*sizeof(struct BufItemProp));
+			}
+			memmove(buf+1,buf,s->bufsize[v]*sizeof(struct BufItemProp));
+			buf[0].origin = -1;
+			buf[0].qty = decayed;
+			s->bufsize[v]++;
+		}
+	}
+	s->tlast[v] = now;
+}
+
+// proportional provenance with exponential time decay
+// the quantity of each origin at a node decays by exp(-dt/T) over time dt; the decayed quantity is moved to
+// origin -1, so the total quantity is conserved
+// decay is applied lazily, when a node is touched (see decaybuffer)
+static int ProvProportionalDecay(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+	int i,a,b,numelem;
+	int src,dest;
+	struct BufItemProp **buffer = s->propbuffer; // array of buffers, one for each node of the Graph
+	int *bufcapacity = s->bufcapacity; // capacity of each buffer, initially 3
+	int *bufsize = s->bufsize; // number of items in each buffer, initially 0
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i
+	struct BufItemProp *newbuffer;
+	struct BufItemProp newentry;
+	qty_t transqty, qty, rest;
+	int all; // set if src relays all its buffered quantity
+	
+	for(i=0;i<numinter;i++)
+	{
+		src = inter[i].src;
+		dest = inter[i].dest;
+		decaybuffer(s, src, inter[i].ts);
+		decaybuffer(s, dest, inter[i].ts);
+		if (src==dest) {
+			// self-loop: the buffered quantity stays, and only the part that was not buffered is born (see selfloop)
+			qty = inter[i].qty-sumbuffered[src];
+			if (qty>QTY_EPS) {
+				if (bufcapacity[src] < bufsize[src]+1) {
+					bufcapacity[src] = 2*(bufsize[src]+1);
+					buffer[src] = (struct BufItemProp *)realloc(buffer[src], bufcapacity[src]*sizeof(struct BufItemProp));
+				}
+				newentry.origin = src;
+				newentry.qty = qty;
+				addnewitem(buffer[src], &bufsize[src], newentry);
+				sumbuffered[src] = inter[i].qty;
+			}
+			continue;
+		}
+		all = (inter[i].qty>=sumbuffered[src]);
+		rest = sumbuffered[src];
+		
+		if (s->newbufcapacity < bufsize[src]+bufsize[dest]+1) {
+			s->newbufcapacity = 2*(bufsize[src]+bufsize[dest]+1);
+			s->newbuffer = (struct BufItemProp *)realloc(s->newbuffer, s->newbufcapacity*sizeof(struct BufItemProp));
+		}
+		newbuffer = s->newbuffer;
+		
+		// merge the relayed part of buffer[src] with buffer[dest]
+		numelem = 0;
+		a = b = 0;
+		while (a<bufsize[src] || b<bufsize[dest]) {
+			if (b==bufsize[dest] || (a<bufsize[src] && buffer[src][a].origin<buffer[dest][b].origin)) {
+				transqty = all ? buffer[src][a].qty : propshare(inter[i].qty,buffer[src][a].qty,&rest,sumbuffered[src]);
+				newbuffer[numelem].origin = buffer[src][a].origin;
+				newbuffer[numelem++].qty = transqty;
+				buffer[src][a++].qty -= transqty;
+			}
+			else if (a==bufsize[src] || buffer[src][a].origin>buffer[dest][b].origin)
+				newbuffer[numelem++] = buffer[dest][b++];
+			else {
+				transqty = all ? buffer[src][a].qty : propshare(inter[i].qty,buffer[src][a].qty,&rest,sumbuffered[src]);
+				newbuffer[numelem].origin = buffer[dest][b].origin;
+				newbuffer[numelem++].qty = transqty+buffer[dest][b++].qty;
+				buffer[src][a++].qty -= transqty;
+			}
+		}
+		
+		if (all) {
+			bufsize[src] = 0;
+			qty = inter[i].qty-sumbuffered[src];
+			if (qty>QTY_EPS) {
+				// src did not have enough buffered quantity to relay; give birth to new flow item
+				newentry.origin = src;
+				newentry.qty = qty;
+				addnewitem(newbuffer, &numelem, newentry);
+			}
+			sumbuffered[src] = 0;
+		}
+		else
+			sumbuffered[src] -= inter[i].qty;
+		sumbuffered[dest] += inter[i].qty;
+		
+		if (bufcapacity[dest] < numelem) {
+			bufcapacity[dest] = numelem;
+			buffer[dest] = (struct BufItemProp *)realloc(buffer[dest], bufcapacity[dest]*sizeof(struct BufItemProp));
+		}
+		memcpy(buffer[dest],newbuffer,numelem*sizeof(struct BufItemProp));
+		bufsize[dest] = numelem;
+	}
+	
+	return 0;
+}
+
+// provenance proportional origin model
+// Proportional Dense model
+// works for selected origins only
+// to use for all vertices, select all of them in array
+// if transferred quantity is lower than buffered quantity 
+// then origins are picked proportionally
+// creation timestamps are ignored
+static int ProvProportionalSel(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    int numselected = s->numselected; // number of selected vertices
+    qty_t **buffer = s->densebuffer; // array of buffers, one for each node of the Graph
+	qty_t *nonselectedqty = s->nonselectedqty; // quantity originating from non-selected nodes  
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i  
+	int *map = s->selmap; // map[i] is position of node i in selectednodes (-1 if it is not there)
+	
+	qty_t qty, rest; 
+	    
+	for(i=0;i<numinter;i++)
+	{
+		if (inter[i].src==inter[i].dest) {
+			// self-loop: the buffered quantity stays, and only the part that was not buffered is born (see selfloop)
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>0) {
+				if (map[inter[i].src]!=-1) // inter[i].src in selected
+					buffer[inter[i].src][map[inter[i].src]] += qty;
+				else
+					nonselectedqty[inter[i].src] += qty;
+				sumbuffered[inter[i].src] = inter[i].qty;
+			}
+			continue;
+		}
+		if (inter[i].qty>=sumbuffered[inter[i].src]) {
+			// case 1: just transfer everything to dest
+			for(j=0;j<numselected;j++) {
+				buffer[inter[i].dest][j] += buffer[inter[i].src][j];
+				buffer[inter[i].src][j] = 0.0;
+			}
+			nonselectedqty[inter[i].dest] += nonselectedqty[inter[i].src];
+			nonselectedqty[inter[i].src] = 0.0;
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>0) {
+				if (map[inter[i].src]!=-1) // inter[i].src in selected
+					buffer[inter[i].dest][map[inter[i].src]] += qty;
+				else
+					nonselectedqty[inter[i].dest] += qty;
+			}
+			sumbuffered[inter[i].src] = 0;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		else { //inter[i].qty < sumbuffered[inter[i].src]
+			rest = sumbuffered[inter[i].src];
+			for(j=0;j<numselected;j++)
+			{
+				qty = propshare(inter[i].qty,buffer[inter[i].src][j],&rest,sumbuffered[inter[i].src]);
+				buffer[inter[i].dest][j] += qty;
+				buffer[inter[i].src][j] -= qty;
+			}
+			qty = propshare(inter[i].qty,nonselectedqty[inter[i].src],&rest,sumbuffered[inter[i].src]);
+			nonselectedqty[inter[i].dest] += qty;
+			nonselectedqty[inter[i].src] -= qty;
+			
+			sumbuffered[inter[i].src] -= inter[i].qty;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+	}
+
+    return 0;
+}
+
+
+// provenance proportional origin model
+// if transferred quantity is lower than buffered quantity 
+// then origins are picked proportionally
+// creation timestamps are ignored
+// assumes that vertices are partitioned to groups (clusters?)
+// measures provenance from each group 
+// map[i] = group id whereto vertex i is mapped
+static int ProvProportionalGroup(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+    int i,j,k;
+
+    int numgroups = s->numgroups; // number of groups
+    int *map = s->map; // map[i] = group id whereto vertex i is mapped
+    qty_t **buffer = s->densebuffer; // array of buffers, one for each group
+	qty_t *sumbuffered = s->sumbuffered; // total quantity buffered at node i  
+	
+	qty_t qty, rest; 
+	    
+	for(i=0;i<numinter;i++)
+	{
+		if (inter[i].src==inter[i].dest) {
+			// self-loop: the buffered quantity stays, and only the part that was not buffered is born (see selfloop)
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>0) {
+				buffer[inter[i].src][map[inter[i].src]] += qty;
+				sumbuffered[inter[i].src] = inter[i].qty;
+			}
+			continue;
+		}
+		if (inter[i].qty>=sumbuffered[inter[i].src]) {
+			// case 1: just transfer everything to dest
+			for(j=0;j<numgroups;j++) {
+				buffer[inter[i].dest][j] += buffer[inter[i].src][j];
+				buffer[inter[i].src][j] = 0.0;
+			}
+			qty = inter[i].qty-sumbuffered[inter[i].src];
+			if (qty>0)
+				buffer[inter[i].dest][map[inter[i].src]] += qty;
+			sumbuffered[inter[i].src] = 0;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+		else { //inter[i].qty < sumbuffered[inter[i].src]
+			//proportional transfer case
+			rest = sumbuffered[inter[i].src];
+			for(j=0;j<numgroups;j++)
+			{
+				qty = propshare(inter[i].qty,buffer[inter[i].src][j],&rest,sumbuffered[inter[i].src]);
+				buffer[inter[i].dest][j] += qty;
+				buffer[inter[i].src][j] -= qty;
+			}
+			
+			sumbuffered[inter[i].src] -= inter[i].qty;
+			sumbuffered[inter[i].dest] += inter[i].qty;
+		}
+	}
+
+    return 0;
+}
+
+// allocates the buffers of model s->method for s->numnodes vertices
+// model parameters (W, budget, selectednodes, map, ...) must be set before
+static int initProvState(struct ProvState *s)
+{
+	int i,j;
+	int numnodes = s->numnodes;
+	int cap;
+	
+	s->numprocessed = 0;
+	s->lastts = 0.0;
+	s->numtransfers = 0;
+	s->numrelays = 0;
+	s->numpruned = 0;
+	s->prunedqty = 0;
+	
+	if ((s->dustabs>0 || s->dustrel>0) && s->method!=101 && s->method!=112 && s->method!=120) {
+		printf("ERROR: pruning of dust is supported by methods 101, 112 and 120 only\n");
+		return -1;
+	}
+	
+	switch(s->method)
+	{
+		case 0:
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t)); // initially, all buffers are 0
+		break;
+		
+		case 1:
+		case 2:
+		case 3:
+		case 4:
+		case 31:
+		case 123:
+		s->buffer = (struct BufItem **)malloc(numnodes*sizeof(struct BufItem *));
+		s->bufcapacity = (int *)malloc(numnodes*sizeof(int));
+		s->bufsize = (int *)malloc(numnodes*sizeof(int));
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		for(i=0;i<numnodes;i++) {
+			s->bufsize[i]=0;
+			s->bufcapacity[i]=3; //initial capacity per buffer
+			s->buffer[i] = (struct BufItem *)malloc(s->bufcapacity[i]*sizeof(struct BufItem));
+		}
+		if (s->method==4) {
+			s->buffirst = (int *)calloc(numnodes,sizeof(int));
+			s->buflast = (int *)calloc(numnodes,sizeof(int));
+		}
+		if (s->method==31) {
+			s->bufferpath = (struct BufItemPath **)malloc(numnodes*sizeof(struct BufItemPath *));
+			for(i=0;i<numnodes;i++)
+				s->bufferpath[i] = (struct BufItemPath *)malloc(s->bufcapacity[i]*sizeof(struct BufItemPath));
+		}
+		if (s->method==123) {
+			if (s->T<=0 || s->numepochs<1) {
+				printf("ERROR: time window should be positive, with at least one epoch\n");
+				return -1;
+			}
+			s->oldest = (double *)malloc(numnodes*sizeof(double));
+			for(i=0;i<numnodes;i++)
+				s->oldest[i] = INFINITY; // no quantity of known origin
+		}
+		break;
+		
+		case 102:
+		s->ovec = (struct OriginVec *)malloc(numnodes*sizeof(struct OriginVec));
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		for(i=0;i<numnodes;i++)
+			ovInit(&s->ovec[i]);
+		break;
+		
+		case 101:
+		case 112:
+		case 120:
+		case 124:
+		if (s->method==120 && s->W<1) {
+			printf("ERROR: window size should be at least 1\n");
+			return -1;
+		}
+		s->propbuffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
+		s->bufcapacity = (int *)malloc(numnodes*sizeof(int));
+		s->bufsize = (int *)malloc(numnodes*sizeof(int));
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		for(i=0;i<numnodes;i++) {
+			s->bufsize[i]=0;
+			s->bufcapacity[i]=3;
+			s->propbuffer[i] = (struct BufItemProp *)malloc(s->bufcapacity[i]*sizeof(struct BufItemProp));
+		}
+		if (s->method==112) {
+			for(j=i=0;i<s->numlevels;i++)
+				if (s->levelgroups[i]>j)
+					j = s->levelgroups[i];
+			s->levelpos = (int *)malloc(j*sizeof(int));
+			for(i=0;i<j;i++)
+				s->levelpos[i] = -1;
+		}
+		if ((s->method==101 || s->method==112 || s->method==120) && (s->dustabs>0 || s->dustrel>0)) {
+			s->dustmark = (int *)malloc(numnodes*sizeof(int));
+			for(i=0;i<numnodes;i++)
+				s->dustmark[i] = DUST_MINMARK;
+		}
+		if (s->method==120) {
+			s->oddbuffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
+			s->oddbufcapacity = (int *)malloc(numnodes*sizeof(int));
+			s->oddbufsize = (int *)malloc(numnodes*sizeof(int));
+			for(i=0;i<numnodes;i++) {
+				s->oddbufsize[i]=0;
+				s->oddbufcapacity[i]=3;
+				s->oddbuffer[i] = (struct BufItemProp *)malloc(s->oddbufcapacity[i]*sizeof(struct BufItemProp));
+			}
+			s->evenreset = s->oddreset = -1;
+			s->evenstamp = (int *)malloc(numnodes*sizeof(int));
+			s->oddstamp = (int *)malloc(numnodes*sizeof(int));
+			for(i=0;i<numnodes;i++)
+				s->evenstamp[i] = s->oddstamp[i] = -1;
+		}
+		if (s->method==124) {
+			if (s->T<=0) {
+				printf("ERROR: decay time constant should be positive\n");
+				return -1;
+			}
+			s->tlast = (double *)calloc(numnodes,sizeof(double));
+		}
+		break;
+		
+		case 121:
+		// a shrunk buffer (reducedsize entries plus the residue entry) may receive one new entry
+		// so each buffer needs room for reducedsize+2 entries, even if this exceeds the budget
+		cap = s->budget>s->reducedsize+2 ? s->budget : s->reducedsize+2;
+		s->propbuffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
+		s->bufsize = (int *)malloc(numnodes*sizeof(int));
+		s->lastbufshrink = (int *)calloc(numnodes,sizeof(int)); // reset to 0 for all nodes
+		s->numbufshrinks = (int *)calloc(numnodes,sizeof(int)); // reset to 0 for all nodes
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		for(i=0;i<numnodes;i++) {
+			s->bufsize[i]=0;
+			s->propbuffer[i] = (struct BufItemProp *)malloc(cap*sizeof(struct BufItemProp));
+		}
+		s->newbuffer = (struct BufItemProp *)malloc((2*cap+1)*sizeof(struct BufItemProp));
+		s->shrinkqty = (qty_t *)malloc((2*cap+1)*sizeof(qty_t));
+		break;
+		
+		case 122:
+		case 125:
+		// k counters and the -1 entry per node
+		if (s->budget<1) {
+			printf("ERROR: sketch size should be at least 1\n");
+			return -1;
+		}
+		cap = s->budget+1;
+		s->propbuffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
+		s->bufsize = (int *)calloc(numnodes,sizeof(int));
+		s->numbufshrinks = (int *)calloc(numnodes,sizeof(int));
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		s->sketcherr = (double *)calloc(numnodes,sizeof(double));
+		for(i=0;i<numnodes;i++)
+			s->propbuffer[i] = (struct BufItemProp *)malloc(cap*sizeof(struct BufItemProp));
+		s->newbuffer = (struct BufItemProp *)malloc((2*cap+1)*sizeof(struct BufItemProp));
+		s->shrinkqty = (qty_t *)malloc((2*cap+1)*sizeof(qty_t));
+		break;
+		
+		case 110:
+		for(i=0;i<s->numselected;i++)
+			if (s->selectednodes[i]<0 || s->selectednodes[i]>=numnodes) {
+				printf("ERROR: selected vertex %d does not exist\n",s->selectednodes[i]);
+				return -1;
+			}
+		s->densebuffer = (qty_t **)malloc(numnodes*sizeof(qty_t *));
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		s->nonselectedqty = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		s->selmap = (int *)malloc(numnodes*sizeof(int));
+		for(i=0;i<numnodes;i++) {
+			s->selmap[i]=-1;
+			// each buffer has exactly numselected entries plus one quantity originating from non-selected nodes   
+			s->densebuffer[i] = (qty_t *)calloc(s->numselected,sizeof(qty_t));
+		}
+		// map each node-id to a position in selectednodes or to -1 if it does not exist there
+		for(i=0;i<s->numselected;i++) {
+			if (s->selmap[s->selectednodes[i]]!=-1) {
+				printf("ERROR: vertex %d is selected twice\n",s->selectednodes[i]);
+				return -1;
+			}
+			s->selmap[s->selectednodes[i]]=i;
+		}
+		break;
+		
+		case 100:
+		case 111:
+		//densebuffer[i][j] is the buffered qty at node i originating from group j	
+		s->densebuffer = (qty_t **)malloc(numnodes*sizeof(qty_t *));
+		s->sumbuffered = (qty_t *)calloc(numnodes,sizeof(qty_t));
+		for(i=0;i<numnodes;i++)
+			s->densebuffer[i] = (qty_t *)calloc(s->numgroups,sizeof(qty_t)); // each buffer has exactly numgroups entries 
+		break;
+		
+		default:
+		printf("ERROR: unknown provenance model %d\n",s->method);
+		return -1;
+	}
+	
+	if (s->memlimit>0 || s->coldafter>0) {
+		if (s->method!=4 && s->method!=101) {
+			printf("ERROR: a memory budget and compression of the buffers are supported by methods 4 and 101 only\n");
+			return -1;
+		}
+		s->store = (struct BufStore *)malloc(sizeof(struct BufStore));
+		if (bsInit(s->store,numnodes,s->memlimit,s->spilldir)==-1) {
+			free(s->store);
+			s->store = NULL;
+			return -1;
+		}
+	}
+	
+	return 0;
+}
+
+// reallocates array p of old items of itemsize bytes to n items; the new items are zeroed
+static void *growArray(void *p, size_t itemsize, int old, int n)
+{
+	p = realloc(p,n*itemsize);
+	memset((char *)p+old*itemsize,0,(n-old)*itemsize);
+	return p;
+}
+
+// adds vertices s->numnodes..numnodes-1 to s, with empty buffers, e.g. for a graph that continues a checkpoint
+// not supported by the models with groups (100, 111, 112), whose map does not cover the new vertices
+static int growProvState(struct ProvState *s, int numnodes)
+{
+	int i;
+	int old = s->numnodes;
+	int cap;
+	
+	if (numnodes<=old)
+		return 0;
+	if (s->map!=NULL) {
+		printf("ERROR: the groups of vertices %d..%d are unknown\n",old,numnodes-1);
+		return -1;
+	}
+	if (s->sumbuffered!=NULL)
+		s->sumbuffered = (qty_t *)growArray(s->sumbuffered,sizeof(qty_t),old,numnodes);
+	if (s->bufsize!=NULL)
+		s->bufsize = (int *)growArray(s->bufsize,sizeof(int),old,numnodes);
+	if (s->bufcapacity!=NULL) {
+		s->bufcapacity = (int *)growArray(s->bufcapacity,sizeof(int),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->bufcapacity[i] = 3;
+	}
+	if (s->buffer!=NULL) {
+		s->buffer = (struct BufItem **)growArray(s->buffer,sizeof(struct BufItem *),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->buffer[i] = (struct BufItem *)malloc(s->bufcapacity[i]*sizeof(struct BufItem));
+	}
+	if (s->buffirst!=NULL) {
+		s->buffirst = (int *)growArray(s->buffirst,sizeof(int),old,numnodes);
+		s->buflast = (int *)growArray(s->buflast,sizeof(int),old,numnodes);
+	}
+	if (s->bufferpath!=NULL) {
+		s->bufferpath = (struct BufItemPath **)growArray(s->bufferpath,sizeof(struct BufItemPath *),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->bufferpath[i] = (struct BufItemPath *)malloc(s->bufcapacity[i]*sizeof(struct BufItemPath));
+	}
+	if (s->oldest!=NULL) {
+		s->oldest = (double *)growArray(s->oldest,sizeof(double),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->oldest[i] = INFINITY;
+	}
+	if (s->ovec!=NULL) {
+		s->ovec = (struct OriginVec *)growArray(s->ovec,sizeof(struct OriginVec),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			ovInit(&s->ovec[i]);
+	}
+	if (s->propbuffer!=NULL) {
+		// fixed capacity of the models without bufcapacity (121, 122, 125)
+		if (s->method==121)
+			cap = s->budget>s->reducedsize+2 ? s->budget : s->reducedsize+2;
+		else
+			cap = s->budget+1;
+		s->propbuffer = (struct BufItemProp **)growArray(s->propbuffer,sizeof(struct BufItemProp *),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->propbuffer[i] = (struct BufItemProp *)malloc((s->bufcapacity!=NULL ? s->bufcapacity[i] : cap)*sizeof(struct BufItemProp));
+	}
+	if (s->dustmark!=NULL) {
+		s->dustmark = (int *)growArray(s->dustmark,sizeof(int),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->dustmark[i] = DUST_MINMARK;
+	}
+	if (s->oddbuffer!=NULL) {
+		s->oddbufsize = (int *)growArray(s->oddbufsize,sizeof(int),old,numnodes);
+		s->oddbufcapacity = (int *)growArray(s->oddbufcapacity,sizeof(int),old,numnodes);
+		s->oddbuffer = (struct BufItemProp **)growArray(s->oddbuffer,sizeof(struct BufItemProp *),old,numnodes);
+		s->evenstamp = (int *)growArray(s->evenstamp,sizeof(int),old,numnodes);
+		s->oddstamp = (int *)growArray(s->oddstamp,sizeof(int),old,numnodes);
+		for(i=old;i<numnodes;i++) {
+			s->oddbufcapacity[i] = 3;
+			s->oddbuffer[i] = (struct BufItemProp *)malloc(s->oddbufcapacity[i]*sizeof(struct BufItemProp));
+			s->evenstamp[i] = s->evenreset; // the empty buffers are as of the last resets
+			s->oddstamp[i] = s->oddreset;
+		}
+	}
+	if (s->tlast!=NULL)
+		s->tlast = (double *)growArray(s->tlast,sizeof(double),old,numnodes);
+	if (s->lastbufshrink!=NULL)
+		s->lastbufshrink = (int *)growArray(s->lastbufshrink,sizeof(int),old,numnodes);
+	if (s->numbufshrinks!=NULL)
+		s->numbufshrinks = (int *)growArray(s->numbufshrinks,sizeof(int),old,numnodes);
+	if (s->sketcherr!=NULL)
+		s->sketcherr = (double *)growArray(s->sketcherr,sizeof(double),old,numnodes);
+	if (s->densebuffer!=NULL) {
+		s->densebuffer = (qty_t **)growArray(s->densebuffer,sizeof(qty_t *),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->densebuffer[i] = (qty_t *)calloc(s->numselected,sizeof(qty_t)); // 110: the other models have groups
+	}
+	if (s->nonselectedqty!=NULL)
+		s->nonselectedqty = (qty_t *)growArray(s->nonselectedqty,sizeof(qty_t),old,numnodes);
+	if (s->selmap!=NULL) {
+		s->selmap = (int *)growArray(s->selmap,sizeof(int),old,numnodes);
+		for(i=old;i<numnodes;i++)
+			s->selmap[i] = -1;
+	}
+	if (s->store!=NULL)
+		bsGrow(s->store,numnodes);
+	s->numnodes = numnodes;
+	return 0;
+}
+
+// processes a batch of interactions with the model of s
+// the batch continues the stream after the s->numprocessed interactions processed so far
+static int runProvState(struct ProvState *s, struct Interaction *inter, int numinter)
+{
+	int ret;
+	
+	switch(s->method)
+	{
+		case 0: ret = noProvFromMem(s, inter, numinter); break;
+		case 1: ret = ProvOldestFirst(s, inter, numinter); break;
+		case 2: ret = ProvNewestFirst(s, inter, numinter); break;
+		case 3: ret = ProvLIFO(s, inter, numinter); break;
+		case 4: ret = ProvFIFO(s, inter, numinter); break;
+		case 31: ret = ProvLIFOPaths(s, inter, numinter); break;
+		case 100: ret = ProvProportionalGroup(s, inter, numinter); break;
+		case 101:
+		case 112: ret = ProvProportional(s, inter, numinter); break;
+		case 102: ret = ProvProportionalHybrid(s, inter, numinter); break;
+		case 110: ret = ProvProportionalSel(s, inter, numinter); break;
+		case 111: ret = ProvProportionalGroup(s, inter, numinter); break;
+		case 120: ret = ProvProportionalWindow(s, inter, numinter); break;
+		case 121: ret = ProvProportionalBudget(s, inter, numinter); break;
+		case 122:
+		case 125: ret = ProvProportionalSketch(s, inter, numinter); break;
+		case 123: ret = ProvProportionalSlidingWindow(s, inter, numinter); break;
+		case 124: ret = ProvProportionalDecay(s, inter, numinter); break;
+		default: return -1;
+	}
+	s->numprocessed += numinter;
+	if (numinter>0)
+		s->lastts = inter[numinter-1].ts;
+	
+	return ret;
+}
+
+// applies the changes to the buffer of vertex i that are pending until it is touched (123, 124)
+// i.e., brings the buffer up to the time of the last processed interaction
+// with a memory budget (4, 101), makes the buffer of vertex i resident; returns 0 or -1
+static int settleProvVertex(struct ProvState *s, int i)
+{
+	if (s->store!=NULL)
+		return loadnode(s,i)==-1 || spillnodes(s,i,-1)==-1 ? -1 : 0;
+	if (s->method==120)
+		resetwindow(s, i);
+	else if (s->method==123)
+		expirewindow(s, i, s->lastts);
+	else if (s->method==124)
+		decaybuffer(s, i, s->lastts);
+	return 0;
+}
+
+static void settleProvState(struct ProvState *s)
+{
+	int i;
+	
+	if (s->store!=NULL) // buffers of a memory budget are made resident one at a time, when they are used
+		return;
+	for(i=0;i<s->numnodes;i++)
+		settleProvVertex(s,i);
+}
+
+// sets *items to the buffered items of vertex i and returns their number
+// buffers not stored as struct BufItem arrays are converted into s->items
+static int getProvVertex(struct ProvState *s, int i, struct BufItem **items)
+{
+	int j,pos,n;
+	struct OvItem *ovitems;
+	
+	if (settleProvVertex(s,i)==-1) {
+		*items = NULL;
+		return 0;
+	}
+	switch(s->method)
+	{
+		case 0: n = 1; break;
+		case 1:
+		case 2:
+		case 3:
+		case 31:
+		case 123:
+		*items = s->buffer[i];
+		return s->bufsize[i];
+		case 110: n = s->numselected; break;
+		case 100:
+		case 111: n = s->numgroups; break;
+		case 102: n = s->ovec[i].size; break;
+		default: n = s->bufsize[i];
+	}
+	if (s->itemcapacity<n) {
+		s->itemcapacity = n;
+		s->items = (struct BufItem *)realloc(s->items,s->itemcapacity*sizeof(struct BufItem));
+	}
+	*items = s->items;
+	
+	switch(s->method)
+	{
+		case 0:
+		s->items[0].origin = i;
+		s->items[0].ts = 0;
+		s->items[0].qty = s->sumbuffered[i];
+		break;
+		
+		case 4:
+		// items in queue order, starting from buflast
+		pos = s->buflast[i];
+		for(j=0;j<n;j++) {
+			s->items[j] = s->buffer[i][pos];
+			pos = (pos+1)%s->bufcapacity[i];
+		}
+		break;
+		
+		case 101:
+		case 112:
+		case 120:
+		case 121:
+		case 122:
+		case 124:
+		case 125:
+		for(j=0;j<n;j++) {
+			s->items[j].origin = s->propbuffer[i][j].origin;
+			// error bound of the quantity (122, 125)
+			s->items[j].ts = s->sketcherr!=NULL && s->items[j].origin!=-1 ? s->sketcherr[i] : 0;
+			s->items[j].qty = s->propbuffer[i][j].qty;
+		}
+		break;
+		
+		case 102:
+		ovSorted(&s->ovec[i],&s->ovscratch,&s->ovscratchcapacity,&ovitems);
+		for(j=0;j<n;j++) {
+			s->items[j].origin = ovitems[j].origin;
+			s->items[j].ts = 0;
+			s->items[j].qty = ovitems[j].qty;
+		}
+		break;
+		
+		case 100:
+		case 110:
+		case 111:
+		for(j=0;j<n;j++) {
+			s->items[j].origin = s->method==110 ? s->selectednodes[j] : j;
+			s->items[j].ts = 0;
+			s->items[j].qty = s->densebuffer[i][j];
+		}
+		break;
+	}
+	return n;
+}
+
+static int cmpitembyorigin(const void *i1, const void *i2)
+{
+	struct BufItem *a = (struct BufItem *)i1;
+	struct BufItem *b = (struct BufItem *)i2;
+	
+	return a->origin - b->origin;
+}
+
+// as getProvVertex, with the origins (groups of the finest level) rolled up to the groups of level level (112)
+// the items of each group are summed in place in s->items, using s->levelpos, and sorted by group
+static int getProvVertexLevel(struct ProvState *s, int i, int level, struct BufItem **items)
+{
+	int j,g,m,n;
+	int *rollup, *levelpos = s->levelpos;
+	
+	n = getProvVertex(s,i,items);
+	if (level==0)
+		return n;
+	rollup = s->rollup[level];
+	m = 0;
+	for(j=0;j<n;j++) {
+		if (s->items[j].origin==-1) { // quantity of no origin (dust) is not rolled up
+			s->items[m++] = s->items[j];
+			continue;
+		}
+		g = rollup[s->items[j].origin];
+		if (levelpos[g]==-1) {
+			levelpos[g] = m;
+			s->items[m] = s->items[j];
+			s->items[m++].origin = g;
+		}
+		else
+			s->items[levelpos[g]].qty += s->items[j].qty;
+	}
+	for(j=0;j<m;j++)
+		if (s->items[j].origin!=-1)
+			levelpos[s->items[j].origin] = -1;
+	qsort(s->items,m,sizeof(struct BufItem),cmpitembyorigin);
+	return m;
+}
+
+// writes the buffers of all vertices at each level of groups, from the finest to the coarsest (112)
+// in text mode each level starts with a line "Level <l> (<number of groups> groups)";
+// in binary mode the records of the levels follow each other, in the same order
+static void writeHierBuffers(struct ProvState *s, struct OutWriter *w)
+{
+	int i,l,n;
+	long long numitems;
+	struct BufItem *items;
+	char line[64];
+	
+	for(l=0;l<s->numlevels;l++) {
+		numitems = 0;
+		for(i=0;i<s->numnodes;i++)
+			numitems += getProvVertexLevel(s,i,l,&items);
+		printf("items at level %d (%d groups)=%lld\n",l,s->levelgroups[l],numitems);
+	}
+	fflush(stdout);
+	for(l=0;l<s->numlevels;l++) {
+		if (w->mode==OUT_TEXT) {
+			snprintf(line,sizeof(line),"Level %d (%d groups)\n",l,s->levelgroups[l]);
+			outText(w,line);
+		}
+		for(i=0;i<s->numnodes;i++) {
+			n = getProvVertexLevel(s,i,l,&items);
+			outVertex(w,i,items,n,OUTSTYLE_NODE);
+		}
+	}
+}
+
+// writes the buffer of vertex i with writer w, in the output format of the model of s
+static void writeProvVertex(struct ProvState *s, struct OutWriter *w, int i)
+{
+	int j,k,n;
+	int style;
+	struct BufItem *items;
+	
+	if (s->method==31 && w->mode==OUT_TEXT && w->topn==0) {
+		// paths are written in text mode only
+		if (outSkip(w,i,s->bufsize[i]))
+			return;
+		w->numvertices++;
+		w->numitems += s->bufsize[i];
+		outText(w,"Buffer of vertex ");
+		outInt(w,i);
+		outText(w,":\n");
+		for(j=0;j<s->bufsize[i];j++) {
+			outText(w,"(o=");
+			outInt(w,s->buffer[i][j].origin);
+			outText(w,",qty=");
+			outAmount(w,s->buffer[i][j].qty);
+			outText(w,") path: ");
+			outInt(w,s->buffer[i][j].origin);
+			outText(w,"->");
+			for(k=0;k<s->bufferpath[i][j].pathlen;k++) {
+				outInt(w,s->bufferpath[i][j].path[k]);
+				outText(w,"->");
+			}
+			outInt(w,i);
+			outText(w,"\n");
+		}
+		return;
+	}
+	
+	switch(s->method)
+	{
+		case 0: style = OUTSTYLE_SCALAR; break;
+		case 1:
+		case 2:
+		case 123: style = OUTSTYLE_TS; break;
+		case 3:
+		case 4:
+		case 31: style = OUTSTYLE_BUF; break;
+		case 110: style = OUTSTYLE_DENSE; break;
+		case 122:
+		case 125: style = OUTSTYLE_SKETCH; break;
+		case 100:
+		case 111: style = OUTSTYLE_GROUP; break;
+		default: style = OUTSTYLE_NODE;
+	}
+	n = getProvVertex(s,i,&items);
+	outVertex(w,i,items,n,style);
+}
+
+// prints statistics and the buffers of the time-ordered models (1, 2, 3, 4)
+// prints the statistics of the spill file and of the compressed buffers (4, 101 with a store)
+static void printStoreStats(struct ProvState *s)
+{
+	if (s->memlimit>0) {
+		printf("buffer spills=%lld\n",s->store->numspills);
+		printf("buffer reloads=%lld\n",s->store->numloads);
+		printf("spill file size=%.2f MB\n",s->store->filesize/1048576.0);
+		printf("largest resident buffers=%.2f MB (budget %.2f MB)\n",s->store->maxused/1048576.0,s->memlimit/1048576.0);
+	}
+	if (s->coldafter>0) {
+		printf("buffer compressions=%lld\n",s->store->numpacks);
+		printf("buffer decompressions=%lld\n",s->store->numunpacks);
+		printf("compressed buffers=%.2f MB (%.2f MB of items)\n",s->store->packedbytes/1048576.0,s->store->rawbytes/1048576.0);
+	}
+}
+
+static void printBuffers(struct ProvState *s, struct OutWriter *w)
+{
+	int i,j;
+	int numnodes = s->numnodes;
+	struct BufItem **buffer = s->buffer;
+	int *bufsize = s->bufsize;
+	int *bufcapacity = s->bufcapacity;
+	
+	int sumsize =0;
+	for(i=0;i<numnodes;i++)
+       sumsize+=bufsize[i];
+    printf("sumsize=%d\n",sumsize);
+
+	int sumcap =0;
+	for(i=0;i<numnodes;i++)
+       sumcap+=bufcapacity[i];
+    printf("sumcapacity=%d\n",sumcap);
+    if (s->store!=NULL) // before the buffers are made resident below
+    	printStoreStats(s);
+    
+    double sumqty =0;
+    if (s->method==4) {
+		for(i=0;i<numnodes;i++) {
+			if (s->store!=NULL)
+				settleProvVertex(s,i);
+			sumqty+=fifosum(buffer[i], bufsize[i], s->buflast[i], bufcapacity[i]);
+		}
+	}
+	else {
+		for(i=0;i<numnodes;i++)
+			for(j=0;j<bufsize[i];j++)
+		   		sumqty+=buffer[i][j].qty;
+	}
+    printf("sumqty=%.2f\n",sumqty);
+    if (s->method==123) {
+    	double unattributed = 0;
+    	for(i=0;i<numnodes;i++)
+    		if (bufsize[i]>0 && buffer[i][0].origin==-1)
+    			unattributed += buffer[i][0].qty;
+    	printf("unattributed qty=%.2f\n",unattributed);
+    }
+    else if (s->method!=2)
+    	printf("numtransfers=%d\n",s->numtransfers);
+    if (s->method==1)
+    	printf("numrelays=%d\n",s->numrelays);
+
+    for(i=0;i<numnodes;i++)
+    	writeProvVertex(s,w,i);
+    outEnd(w);
+}
+
+// prints statistics and the buffers of LIFO with path tracking (31)
+static void printPathBuffers(struct ProvState *s, struct OutWriter *w)
+{
+	int i,j,k;
+	int numnodes = s->numnodes;
+	struct BufItem **buffer = s->buffer;
+	struct BufItemPath **bufferpath = s->bufferpath;
+	int *bufsize = s->bufsize;
+	
+	int sumsize =0;
+	for(i=0;i<numnodes;i++)
+       sumsize+=bufsize[i];
+    printf("sumsize=%d\n",sumsize);
+
+	int sumcap =0;
+	for(i=0;i<numnodes;i++)
+       sumcap+=s->bufcapacity[i];
+    printf("sumcapacity=%d\n",sumcap);
+    
+    double sumqty =0;
+	for(i=0;i<numnodes;i++)
+		for(j=0;j<bufsize[i];j++)
+       		sumqty+=buffer[i][j].qty;
+    printf("sumqty=%.2f\n",sumqty);
+    printf("numtransfers=%d\n",s->numtransfers);
+
+	// print paths
+    for(i=0;i<numnodes;i++)
+    	writeProvVertex(s,w,i);
+    outEnd(w);
+
+	// count path info
+	int totalpathinfo = 0; //total length of all paths
+    for(i=0;i<numnodes;i++){
+		for(j=0;j<bufsize[i];j++) {
+			totalpathinfo += bufferpath[i][j].pathlen;
+		}
+	}
+    printf("total number of path nodeids held=%d\n",totalpathinfo);	
+}
+
+// prints statistics and the buffers of the sparse proportional models (101, 120, 121)
+static void printPropBuffers(struct ProvState *s, struct OutWriter *w)
+{
+	int i,j;
+	int numnodes = s->numnodes;
+	struct BufItemProp **buffer = s->propbuffer;
+	int *bufsize = s->bufsize;
+	
+	int sumsize =0;
+	for(i=0;i<numnodes;i++)
+       sumsize+=bufsize[i];
+    printf("sumsize=%d\n",sumsize);
+
+	if (s->bufcapacity!=NULL) {
+		int sumcap =0;
+		for(i=0;i<numnodes;i++)
+		   sumcap+=s->bufcapacity[i];
+		printf("sumcapacity=%d\n",sumcap);
+	}
+	if (s->store!=NULL) // before the buffers are made resident below
+		printStoreStats(s);
+    
+	double sumqty =0;
+	for(i=0;i<numnodes;i++) {
+		if (s->store!=NULL)
+			settleProvVertex(s,i);
+		for(j=0;j<bufsize[i];j++)
+       		sumqty+=buffer[i][j].qty;
+	}
+    printf("sumqty=%.2f\n",sumqty);
+    
+    if (s->method==121) {
+		int nonemptybufs = 0;
+		int totshrinking = 0;
+		int numshrunk = 0;
+		for(i=0;i<numnodes;i++) {
+		   	if(bufsize[i]>0) {
+		   		nonemptybufs++;
+		   		totshrinking += s->numbufshrinks[i];
+		   		if (s->numbufshrinks[i]) numshrunk++;
+		   	}
+		}
+		printf("number of non-empty buffers=%d\n",nonemptybufs);
+		printf("number of nodes whose buffer was shrunk at least once=%d\n",numshrunk);
+		printf("average number of shrinks at non-empty buffers=%.2f\n",(double)totshrinking/nonemptybufs);
+	}
+	
+	if (s->dustmark!=NULL) {
+		printf("dust items pruned=%lld\n",s->numpruned);
+		printf("dust qty pruned=%.2f\n",(double)s->prunedqty);
+	}
+	
+	if (s->method==122 || s->method==124 || s->method==125) {
+		double unattributed = 0;
+		for(i=0;i<numnodes;i++)
+			if (bufsize[i]>0 && buffer[i][0].origin==-1)
+				unattributed += buffer[i][0].qty;
+		printf("unattributed qty=%.2f\n",unattributed);
+	}
+	if (s->method==122 || s->method==125) {
+		double maxerr = 0;
+		int numreduced = 0;
+		for(i=0;i<numnodes;i++) {
+			if (s->sketcherr[i]>maxerr)
+				maxerr = s->sketcherr[i];
+			if (s->numbufshrinks[i])
+				numreduced++;
+		}
+		printf("number of nodes whose sketch was reduced at least once=%d\n",numreduced);
+		printf("maximum error bound=%.2f\n",maxerr);
+	}
+    
+	if (s->method==112)
+		writeHierBuffers(s,w);
+	else
+		for(i=0;i<numnodes;i++)
+			writeProvVertex(s,w,i);
+	outEnd(w);
+}
+
+// prints statistics and the buffers of the hybrid proportional model (102)
+static void printHybridBuffers(struct ProvState *s, struct OutWriter *w)
+{
+	int i,j,n;
+	int numnodes = s->numnodes;
+	int numkind[4] = {0,0,0,0};
+	long long sumsize = 0, memory = 0;
+	double sumqty = 0;
+	struct OvItem *items;
+	
+	for(i=0;i<numnodes;i++) {
+		sumsize += s->ovec[i].size;
+		memory += ovMemory(&s->ovec[i]);
+		if (s->ovec[i].size>0)
+			numkind[s->ovec[i].kind]++;
+		n = ovSorted(&s->ovec[i],&s->ovscratch,&s->ovscratchcapacity,&items);
+		for(j=0;j<n;j++)
+			sumqty += items[j].qty;
+	}
+	printf("sumsize=%lld\n",sumsize);
+	printf("memory of origin vectors=%lld bytes\n",memory+(long long)numnodes*sizeof(struct OriginVec));
+	printf("nonempty vectors: inline=%d sorted=%d hash=%d dense=%d\n",numkind[OV_INLINE],numkind[OV_SPARSE],numkind[OV_HASH],numkind[OV_DENSE]);
+	printf("sumqty=%.2f\n",sumqty);
+	
+	for(i=0;i<numnodes;i++)
+		writeProvVertex(s,w,i);
+	outEnd(w);
+}
+
+// prints statistics and the buffers of the dense proportional models (100, 110, 111)
+static void printDenseBuffers(struct ProvState *s, struct OutWriter *w)
+{
+	int i,j;
+	int numnodes = s->numnodes;
+	qty_t **buffer = s->densebuffer;
+	int numentries = s->method==110 ? s->numselected : s->numgroups; // entries per buffer
+	
+	// correctness check to compare with noProv and see whether the final total quantities 
+	// at the buffers are the same
+	double sumqty =0;
+	for(i=0;i<numnodes;i++) {
+		for(j=0;j<numentries;j++)
+       		sumqty+=buffer[i][j];
+       	if (s->method==110)
+       		sumqty+=s->nonselectedqty[i];
+    }   	
+    printf("sumqty=%.2f\n",sumqty);
+
+	for(i=0;i<numnodes;i++)
+		if (s->method==110 || s->sumbuffered[i]>0) // group models print non-empty buffers only
+			writeProvVertex(s,w,i);
+	outEnd(w);
+}
+
+// prints statistics of the model of s and writes its buffers with writer w
+static void printProvState(struct ProvState *s, struct OutWriter *w)
+{
+	int i;
+	double sumqty;
+	
+	settleProvState(s);
+	switch(s->method)
+	{
+		case 0:
+		sumqty =0.0;
+		for(i=0;i<s->numnodes;i++)
+		   sumqty+=s->sumbuffered[i];
+		printf("sumqty=%.2f\n",sumqty);
+		outEnd(w);
+		break;
+		case 1:
+		case 2:
+		case 3:
+		case 4:
+		case 123:
+		printBuffers(s,w);
+		break;
+		case 31:
+		printPathBuffers(s,w);
+		break;
+		case 101:
+		case 112:
+		case 120:
+		case 121:
+		case 122:
+		case 124:
+		case 125:
+		printPropBuffers(s,w);
+		break;
+		case 102:
+		printHybridBuffers(s,w);
+		break;
+		case 100:
+		case 110:
+		case 111:
+		printDenseBuffers(s,w);
+		break;
+	}
+}
+
+// frees all buffers of s
+static void freeProvState(struct ProvState *s)
+{
+	int i,j;
+	char *spilldir;
+	
+	for(i=0;i<s->numnodes;i++) {
+		if (s->buffer!=NULL)
+			free(s->buffer[i]);
+		if (s->bufferpath!=NULL) {
+			for(j=0;j<s->bufsize[i];j++)
+				free(s->bufferpath[i][j].path);
+			free(s->bufferpath[i]);
+		}
+		if (s->propbuffer!=NULL)
+			free(s->propbuffer[i]);
+		if (s->oddbuffer!=NULL)
+			free(s->oddbuffer[i]);
+		if (s->densebuffer!=NULL)
+			free(s->densebuffer[i]);
+		if (s->ovec!=NULL)
+			ovFree(&s->ovec[i]);
+	}
+	free(s->ovec);
+	free(s->ovscratch);
+	free(s->buffer);
+	free(s->bufferpath);
+	free(s->propbuffer);
+	free(s->bufcapacity);
+	free(s->bufsize);
+	free(s->buffirst);
+	free(s->buflast);
+	free(s->sumbuffered);
+	free(s->oddbuffer);
+	free(s->oddbufcapacity);
+	free(s->oddbufsize);
+	free(s->evenstamp);
+	free(s->oddstamp);
+	free(s->dustmark);
+	free(s->lastbufshrink);
+	free(s->numbufshrinks);
+	free(s->newbuffer);
+	free(s->shrinkqty);
+	free(s->sketcherr);
+	free(s->oldest);
+	free(s->tlast);
+	free(s->mergebuffer);
+	free(s->densebuffer);
+	free(s->nonselectedqty);
+	free(s->selmap);
+	free(s->selectednodes);
+	free(s->map);
+	if (s->rollup!=NULL)
+		for(i=1;i<s->numlevels;i++)
+			free(s->rollup[i]);
+	free(s->rollup);
+	free(s->levelgroups);
+	free(s->levelpos);
+	free(s->items);
+	if (s->store!=NULL)
+		bsFree(s->store);
+	free(s->store);
+	spilldir = s->spilldir; // kept with the parameters of the model, freed by provDestroy
+	memset(s,0,sizeof(struct ProvState));
+	s->spilldir = spilldir;
+}
+
+// writes n items of a buffer to a checkpoint file, in the layout of their struct, but with zero padding bytes,
+// so that checkpoints of the same state are identical
+// itemsize is sizeof(struct BufItem), or sizeof(struct BufItemProp) for items of an origin and a quantity
+static void writeCheckpointItems(FILE *f, const void *items, size_t itemsize, int n)
+{
+	struct BufItem item;
+	struct BufItemProp propitem;
+	int j;
+	
+	memset(&item,0,sizeof(item));
+	memset(&propitem,0,sizeof(propitem));
+	for(j=0;j<n;j++)
+		if (itemsize==sizeof(struct BufItem)) {
+			item.origin = ((const struct BufItem *)items)[j].origin;
+			item.ts = ((const struct BufItem *)items)[j].ts;
+			item.qty = ((const struct BufItem *)items)[j].qty;
+			fwrite(&item,sizeof(item),1,f);
+		}
+		else {
+			propitem.origin = ((const struct BufItemProp *)items)[j].origin;
+			propitem.qty = ((const struct BufItemProp *)items)[j].qty;
+			fwrite(&propitem,sizeof(propitem),1,f);
+		}
+}
+
+// writes n buffers to a checkpoint file: the size of each buffer followed by its items
+static void writeCheckpointBuffers(FILE *f, void **buffer, int *bufsize, size_t itemsize, int n)
+{
+	int i;
+	
+	for(i=0;i<n;i++) {
+		fwrite(&bufsize[i],sizeof(int),1,f);
+		writeCheckpointItems(f,buffer[i],itemsize,bufsize[i]);
+	}
+}
+
+// reads n buffers written by writeCheckpointBuffers
+// if bufcapacity is NULL, buffers have fixed capacity maxsize, otherwise they are grown as needed
+static int readCheckpointBuffers(FILE *f, void **buffer, int *bufsize, int *bufcapacity, int maxsize, size_t itemsize, int n)
+{
+	int i;
+	
+	for(i=0;i<n;i++) {
+		if (fread(&bufsize[i],sizeof(int),1,f)!=1 || bufsize[i]<0)
+			return -1;
+		if (bufcapacity==NULL) {
+			if (bufsize[i]>maxsize)
+				return -1;
+		}
+		else if (bufcapacity[i] < bufsize[i]) {
+			bufcapacity[i] = bufsize[i];
+			buffer[i] = realloc(buffer[i], bufcapacity[i]*itemsize);
+		}
+		if (fread(buffer[i],itemsize,bufsize[i],f)!=bufsize[i])
+			return -1;
+	}
+	return 0;
+}
+
+// writes the full state of a provenance model to a binary checkpoint file
+// the run can be resumed later from the checkpoint with new interactions (see loadProvState)
+static int saveProvState(struct ProvState *s, const char *filename)
+{
+	FILE *f;
+	int i,j,pos;
+	int numnodes = s->numnodes;
+	struct ProvCheckpointHeader h;
+	struct OvItem *ovitems;
+	struct OvItem ovitem;
+
+	f = fopen(filename,"wb");
+	if (f==NULL) {
+		printf("ERROR: cannot open checkpoint file %s for writing\n",filename);
+		return -1;
+	}
+	
+	settleProvState(s);
+	memset(&h,0,sizeof(h));
+	memcpy(h.magic,CHKPT_MAGIC,4);
+	h.version = CHKPT_VERSION;
+	h.method = s->method;
+	h.numnodes = numnodes;
+	h.numprocessed = s->numprocessed;
+	h.lastts = s->lastts;
+	h.W = s->W;
+	h.T = s->T;
+	h.numepochs = s->numepochs;
+	h.numlevels = s->numlevels;
+	h.intqty = QTY_INTEGER;
+	h.budget = s->budget;
+	h.reducedsize = s->reducedsize;
+	h.numselected = s->numselected;
+	h.numgroups = s->numgroups;
+	h.numtransfers = s->numtransfers;
+	h.numrelays = s->numrelays;
+	h.dustabs = s->dustabs;
+	h.dustrel = s->dustrel;
+	h.numpruned = s->numpruned;
+	h.prunedqty = s->prunedqty;
+	fwrite(&h,sizeof(h),1,f);
+	
+	// model parameters
+	if (s->selectednodes!=NULL)
+		fwrite(s->selectednodes,sizeof(int),s->numselected,f);
+	if (s->map!=NULL)
+		fwrite(s->map,sizeof(int),numnodes,f);
+	if (s->method==112) {
+		fwrite(s->levelgroups,sizeof(int),s->numlevels,f);
+		for(i=1;i<s->numlevels;i++)
+			fwrite(s->rollup[i],sizeof(int),s->numgroups,f);
+	}
+	
+	if (s->sumbuffered!=NULL)
+		fwrite(s->sumbuffered,sizeof(qty_t),numnodes,f);
+	
+	switch(s->method)
+	{
+		case 1:
+		case 2:
+		case 3:
+		case 123:
+		writeCheckpointBuffers(f,(void **)s->buffer,s->bufsize,sizeof(struct BufItem),numnodes);
+		break;
+		
+		case 31:
+		writeCheckpointBuffers(f,(void **)s->buffer,s->bufsize,sizeof(struct BufItem),numnodes);
+		for(i=0;i<numnodes;i++)
+			for(j=0;j<s->bufsize[i];j++) {
+				fwrite(&s->bufferpath[i][j].pathlen,sizeof(int),1,f);
+				fwrite(s->bufferpath[i][j].path,sizeof(int),s->bufferpath[i][j].pathlen,f);
+			}
+		break;
+		
+		case 4:
+		// queue items are written in queue order, starting from buflast
+		for(i=0;i<numnodes;i++) {
+			if (s->store!=NULL)
+				settleProvVertex(s,i);
+			fwrite(&s->bufsize[i],sizeof(int),1,f);
+			pos = s->bufcapacity[i]-s->buflast[i]; // items up to the end of the array, then from its start
+			if (pos>s->bufsize[i])
+				pos = s->bufsize[i];
+			writeCheckpointItems(f,s->buffer[i]+s->buflast[i],sizeof(struct BufItem),pos);
+			writeCheckpointItems(f,s->buffer[i],sizeof(struct BufItem),s->bufsize[i]-pos);
+		}
+		break;
+		
+		case 101:
+		case 112:
+		case 120:
+		case 121:
+		case 124:
+		if (s->store!=NULL)
+			for(i=0;i<numnodes;i++) {
+				settleProvVertex(s,i);
+				writeCheckpointBuffers(f,(void **)s->propbuffer+i,s->bufsize+i,sizeof(struct BufItemProp),1);
+			}
+		else
+			writeCheckpointBuffers(f,(void **)s->propbuffer,s->bufsize,sizeof(struct BufItemProp),numnodes);
+		if (s->method==120)
+			writeCheckpointBuffers(f,(void **)s->oddbuffer,s->oddbufsize,sizeof(struct BufItemProp),numnodes);
+		if (s->method==124)
+			fwrite(s->tlast,sizeof(double),numnodes,f);
+		if (s->dustmark!=NULL)
+			fwrite(s->dustmark,sizeof(int),numnodes,f);
+		if (s->method==121) {
+			fwrite(s->lastbufshrink,sizeof(int),numnodes,f);
+			fwrite(s->numbufshrinks,sizeof(int),numnodes,f);
+		}
+		break;
+		
+		case 102:
+		// origin vectors are written sorted, in the format of writeCheckpointBuffers
+		memset(&ovitem,0,sizeof(ovitem));
+		for(i=0;i<numnodes;i++) {
+			j = ovSorted(&s->ovec[i],&s->ovscratch,&s->ovscratchcapacity,&ovitems);
+			fwrite(&j,sizeof(int),1,f);
+			for(pos=0;pos<j;pos++) {
+				ovitem.origin = ovitems[pos].origin;
+				ovitem.qty = ovitems[pos].qty;
+				fwrite(&ovitem,sizeof(ovitem),1,f);
+			}
+		}
+		break;
+		
+		case 122:
+		case 125:
+		writeCheckpointBuffers(f,(void **)s->propbuffer,s->bufsize,sizeof(struct BufItemProp),numnodes);
+		fwrite(s->sketcherr,sizeof(double),numnodes,f);
+		fwrite(s->numbufshrinks,sizeof(int),numnodes,f);
+		break;
+		
+		case 100:
+		case 111:
+		for(i=0;i<numnodes;i++)
+			fwrite(s->densebuffer[i],sizeof(qty_t),s->numgroups,f);
+		break;
+		
+		case 110:
+		fwrite(s->nonselectedqty,sizeof(qty_t),numnodes,f);
+		for(i=0;i<numnodes;i++)
+			fwrite(s->densebuffer[i],sizeof(qty_t),s->numselected,f);
+		break;
+	}
+	
+	if (ferror(f)) {
+		printf("ERROR: cannot write checkpoint file %s\n",filename);
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+	
+	return 0;
+}
+
+// restores the state of a provenance model from a checkpoint file written by saveProvState
+// s->method must be the model of the checkpoint; its parameters are taken from the checkpoint
+// s is allocated here (no initProvState needed), so its buffers must not be allocated before
+static int loadProvState(struct ProvState *s, const char *filename)
+{
+	FILE *f;
+	int i,j,cap;
+	int numnodes;
+	int err = 0;
+	struct ProvCheckpointHeader h;
+
+	f = fopen(filename,"rb");
+	if (f==NULL) {
+		printf("ERROR: cannot open checkpoint file %s\n",filename);
+		return -1;
+	}
+	
+	if (fread(&h,sizeof(h),1,f)!=1 || memcmp(h.magic,CHKPT_MAGIC,4) || h.version!=CHKPT_VERSION) {
+		printf("ERROR: %s is not a checkpoint file\n",filename);
+		fclose(f);
+		return -1;
+	}
+	if (h.method!=s->method) {
+		printf("ERROR: checkpoint %s was taken with method %d\n",filename,h.method);
+		fclose(f);
+		return -1;
+	}
+	if (h.intqty!=QTY_INTEGER) {
+		printf("ERROR: checkpoint %s was taken with %s quantities\n",filename,h.intqty ? "integer" : "floating-point");
+		fclose(f);
+		return -1;
+	}
+	if (h.W!=s->W || h.T!=s->T || h.numepochs!=s->numepochs || h.budget!=s->budget || h.reducedsize!=s->reducedsize || h.numselected!=s->numselected 
+		|| h.dustabs!=s->dustabs || h.dustrel!=s->dustrel || ((s->method==111 || s->method==112) && h.numgroups!=s->numgroups))
+		printf("WARNING: model parameters are taken from checkpoint %s\n",filename);
+	
+	numnodes = s->numnodes = h.numnodes;
+	s->W = h.W;
+	s->T = h.T;
+	s->numepochs = h.numepochs;
+	s->budget = h.budget;
+	s->reducedsize = h.reducedsize;
+	s->numselected = h.numselected;
+	s->numgroups = h.numgroups;
+	s->dustabs = h.dustabs;
+	s->dustrel = h.dustrel;
+	
+	// model parameters
+	if (s->method==110) {
+		free(s->selectednodes);
+		s->selectednodes = (int *)malloc(s->numselected*sizeof(int));
+		if (fread(s->selectednodes,sizeof(int),s->numselected,f)!=s->numselected)
+			err = 1;
+	}
+	if (s->method==100 || s->method==111 || s->method==112) {
+		free(s->map);
+		s->map = (int *)malloc(numnodes*sizeof(int));
+		if (fread(s->map,sizeof(int),numnodes,f)!=numnodes)
+			err = 1;
+		for(i=0;i<numnodes && !err;i++)
+			if (s->map[i]<0 || s->map[i]>=s->numgroups)
+				err = 1;
+	}
+	if (s->method==112 && !err) {
+		s->numlevels = h.numlevels;
+		if (s->numlevels<1)
+			err = 1;
+		else {
+			s->levelgroups = (int *)malloc(s->numlevels*sizeof(int));
+			s->rollup = (int **)calloc(s->numlevels,sizeof(int *));
+			if (fread(s->levelgroups,sizeof(int),s->numlevels,f)!=s->numlevels || s->levelgroups[0]!=s->numgroups)
+				err = 1;
+			for(i=1;i<s->numlevels && !err;i++) {
+				s->rollup[i] = (int *)malloc(s->numgroups*sizeof(int));
+				if (s->levelgroups[i]<1 || fread(s->rollup[i],sizeof(int),s->numgroups,f)!=s->numgroups)
+					err = 1;
+				for(j=0;j<s->numgroups && !err;j++)
+					if (s->rollup[i][j]<0 || s->rollup[i][j]>=s->levelgroups[i])
+						err = 1;
+			}
+		}
+	}
+	
+	if (err || initProvState(s)==-1) {
+		printf("ERROR: checkpoint file %s is corrupted\n",filename);
+		fclose(f);
+		return -1;
+	}
+	s->numprocessed = h.numprocessed;
+	s->lastts = h.lastts;
+	s->numtransfers = h.numtransfers;
+	s->numrelays = h.numrelays;
+	s->numpruned = h.numpruned;
+	s->prunedqty = h.prunedqty;
+	
+	if (s->sumbuffered!=NULL && fread(s->sumbuffered,sizeof(qty_t),numnodes,f)!=numnodes)
+		err = 1;
+	
+	switch(s->method)
+	{
+		case 1:
+		case 2:
+		case 3:
+		case 4:
+		// queue items were written in queue order, so the queue starts at position 0
+		// with a memory budget, the buffers are read one at a time, and spilled as they exceed it
+		if (s->store!=NULL)
+			for(i=0;i<numnodes && !err;i++) {
+				err |= readCheckpointBuffers(f,(void **)s->buffer+i,s->bufsize+i,s->bufcapacity+i,0,sizeof(struct BufItem),1);
+				s->buflast[i] = 0;
+				s->buffirst[i] = s->bufsize[i]%s->bufcapacity[i];
+				if (!err && spillnodes(s,i,-1)==-1)
+					err = 1;
+			}
+		else
+			err |= readCheckpointBuffers(f,(void **)s->buffer,s->bufsize,s->bufcapacity,0,sizeof(struct BufItem),numnodes);
+		if (s->method==4 && s->store==NULL)
+			for(i=0;i<numnodes && !err;i++) {
+				s->buflast[i] = 0;
+				s->buffirst[i] = s->bufsize[i]%s->bufcapacity[i];
+			}
+		break;
+		
+		case 31:
+		err |= readCheckpointBuffers(f,(void **)s->buffer,s->bufsize,s->bufcapacity,0,sizeof(struct BufItem),numnodes);
+		for(i=0;i<numnodes && !err;i++) {
+			s->bufferpath[i] = (struct BufItemPath *)realloc(s->bufferpath[i], s->bufcapacity[i]*sizeof(struct BufItemPath));
+			for(j=0;j<s->bufsize[i];j++) {
+				if (fread(&s->bufferpath[i][j].pathlen,sizeof(int),1,f)!=1 || s->bufferpath[i][j].pathlen<0) {
+					// paths of this buffer must be valid for freeProvState
+					for(;j<s->bufsize[i];j++)
+						s->bufferpath[i][j].path = NULL;
+					err = 1;
+					break;
+				}
+				s->bufferpath[i][j].pathcapacity = s->bufferpath[i][j].pathlen>3 ? s->bufferpath[i][j].pathlen : 3;
+				s->bufferpath[i][j].path = (int *)malloc(s->bufferpath[i][j].pathcapacity*sizeof(int));
+				if (fread(s->bufferpath[i][j].path,sizeof(int),s->bufferpath[i][j].pathlen,f)!=s->bufferpath[i][j].pathlen)
+					err = 1;
+			}
+		}
+		for(;i<numnodes;i++) // buffers not read are emptied, so that freeProvState does not free unset paths
+			s->bufsize[i] = 0;
+		break;
+		
+		case 101:
+		case 112:
+		case 120:
+		case 124:
+		if (s->store!=NULL)
+			for(i=0;i<numnodes && !err;i++) {
+				err |= readCheckpointBuffers(f,(void **)s->propbuffer+i,s->bufsize+i,s->bufcapacity+i,0,sizeof(struct BufItemProp),1);
+				if (!err && spillnodes(s,i,-1)==-1)
+					err = 1;
+			}
+		else
+			err |= readCheckpointBuffers(f,(void **)s->propbuffer,s->bufsize,s->bufcapacity,0,sizeof(struct BufItemProp),numnodes);
+		if (s->method==120) {
+			err |= readCheckpointBuffers(f,(void **)s->oddbuffer,s->oddbufsize,s->oddbufcapacity,0,sizeof(struct BufItemProp),numnodes);
+			// the checkpoint was taken after applying all window resets (see settleProvState)
+			j = s->numprocessed-1; // position of the last processed interaction
+			if (j>=0) {
+				s->evenreset = j-j%(2*s->W);
+				if (j>=s->W)
+					s->oddreset = j-(j-s->W)%(2*s->W);
+			}
+			for(i=0;i<numnodes;i++) {
+				s->evenstamp[i] = s->evenreset;
+				s->oddstamp[i] = s->oddreset;
+			}
+		}
+		if (s->method==124 && fread(s->tlast,sizeof(double),numnodes,f)!=numnodes)
+			err = 1;
+		if (s->dustmark!=NULL && fread(s->dustmark,sizeof(int),numnodes,f)!=numnodes)
+			err = 1;
+		break;
+		
+		case 102:
+		for(i=0;i<numnodes && !err;i++) {
+			if (fread(&cap,sizeof(int),1,f)!=1 || cap<0) {
+				err = 1;
+				break;
+			}
+			if (s->ovscratchcapacity<cap) {
+				s->ovscratchcapacity = cap;
+				s->ovscratch = (struct OvItem *)realloc(s->ovscratch,cap*sizeof(struct OvItem));
+			}
+			if (fread(s->ovscratch,sizeof(struct OvItem),cap,f)!=cap)
+				err = 1;
+			else
+				ovSetSorted(&s->ovec[i],s->ovscratch,cap);
+		}
+		break;
+		
+		case 123:
+		err |= readCheckpointBuffers(f,(void **)s->buffer,s->bufsize,s->bufcapacity,0,sizeof(struct BufItem),numnodes);
+		for(i=0;i<numnodes && !err;i++)
+			for(j=0;j<s->bufsize[i];j++)
+				if (s->buffer[i][j].origin!=-1 && s->buffer[i][j].ts<s->oldest[i])
+					s->oldest[i] = s->buffer[i][j].ts;
+		break;
+		
+		case 121:
+		cap = s->budget>s->reducedsize+2 ? s->budget : s->reducedsize+2;
+		err |= readCheckpointBuffers(f,(void **)s->propbuffer,s->bufsize,NULL,cap,sizeof(struct BufItemProp),numnodes);
+		if (fread(s->lastbufshrink,sizeof(int),numnodes,f)!=numnodes || fread(s->numbufshrinks,sizeof(int),numnodes,f)!=numnodes)
+			err = 1;
+		break;
+		
+		case 122:
+		case 125:
+		err |= readCheckpointBuffers(f,(void **)s->propbuffer,s->bufsize,NULL,s->budget+1,sizeof(struct BufItemProp),numnodes);
+		if (fread(s->sketcherr,sizeof(double),numnodes,f)!=numnodes || fread(s->numbufshrinks,sizeof(int),numnodes,f)!=numnodes)
+			err = 1;
+		break;
+		
+		case 100:
+		case 111:
+		for(i=0;i<numnodes;i++)
+			if (fread(s->densebuffer[i],sizeof(qty_t),s->numgroups,f)!=s->numgroups)
+				err = 1;
+		break;
+		
+		case 110:
+		if (fread(s->nonselectedqty,sizeof(qty_t),numnodes,f)!=numnodes)
+			err = 1;
+		for(i=0;i<numnodes;i++)
+			if (fread(s->densebuffer[i],sizeof(qty_t),s->numselected,f)!=s->numselected)
+				err = 1;
+		break;
+	}
+	fclose(f);
+	
+	if (err) {
+		printf("ERROR: checkpoint file %s is corrupted\n",filename);
+		freeProvState(s);
+		return -1;
+	}
+	
+	return 0;
+}
+
+// processes a batch of interactions like runProvState, but also saves a snapshot of the state
+// to directory dir every 'every' interactions and/or whenever the timestamp enters a new period of length dt
+// (every<=0 or dt<=0 disables the respective trigger)
+// each snapshot is a checkpoint file, listed in the time index dir/SNAP_INDEX
+// as <number of interactions processed> <timestamp of last interaction> <file name>
+// dir is created if needed; the index is started anew when s has processed no interactions yet
+static int runWithSnapshots(struct ProvState *s, struct Interaction *inter, int numinter, const char *dir, int every, double dt)
+{
+	int i;
+	int start,end;
+	double period = 0; // current period of length dt
+	char filename[64];
+	char path[4096];
+	FILE *idx;
+	
+	if (mkdir(dir,0777)==-1 && errno!=EEXIST) {
+		printf("ERROR: cannot create snapshot directory %s\n",dir);
+		return -1;
+	}
+	// a fresh run starts a new index; a run that continues one (after a checkpoint or a batch) adds to it
+	snprintf(path,sizeof(path),"%s/%s",dir,SNAP_INDEX);
+	idx = fopen(path,s->numprocessed>0 ? "a" : "w");
+	if (idx==NULL) {
+		printf("ERROR: cannot open snapshot index %s\n",path);
+		return -1;
+	}
+	
+	if (dt>0 && numinter>0)
+		period = floor((s->numprocessed>0 ? s->lastts : inter[0].ts)/dt);
+	
+	start = 0;
+	while (start<numinter)
+	{
+		end = numinter;
+		if (every>0 && end-start > every-s->numprocessed%every)
+			end = start+every-s->numprocessed%every;
+		if (dt>0) {
+			for(i=start; i<end && floor(inter[i].ts/dt)<=period; i++);
+			end = i;
+		}
+		if (end>start && runProvState(s, inter+start, end-start)==-1) {
+			fclose(idx);
+			return -1;
+		}
+		
+		if ((every>0 && end>start && s->numprocessed%every==0) || (dt>0 && end<numinter && floor(inter[end].ts/dt)>period)) {
+			snprintf(filename,sizeof(filename),"snap_%d.chk",s->numprocessed);
+			snprintf(path,sizeof(path),"%s/%s",dir,filename);
+			if (saveProvState(s, path)==-1) {
+				fclose(idx);
+				return -1;
+			}
+			fprintf(idx,"%d\t%.17g\t%s\n",s->numprocessed,s->lastts,filename);
+			if (dt>0 && end<numinter)
+				period = floor(inter[end].ts/dt);
+		}
+		start = end;
+	}
+	fclose(idx);
+	
+	return 0;
+}
+
+// parallel replay of a batch of interactions (models 0, 100, 111)
+// scalar model: a time segment of interactions changes the buffered quantity x of each vertex independently
+// of the other vertices, into max(x+add, least): relaying q maps x to max(x-q,0), receiving q to x+q, and a
+// self-loop to max(x,q); functions of this form are closed under composition, so the segments are summarized
+// in parallel and their summaries are applied in time order
+// dense group models: the transfers of each group depend on the others only through the buffered quantity of
+// the vertices, which every task replays in full, so slices of the groups are replayed in parallel
+// with integer quantities, the share of a group also depends on the quantity of the groups before it
+// (see propshare), so each slice keeps the quantity of each vertex in the groups before the slice; in the
+// proportional case its share is the one of the first group of a vector of two groups, which propshare
+// computes exactly as the sum of the shares of the groups it stands for
+
+// effect of a time segment on a vertex it touches (model 0)
+struct SegVertex {
+	int v;
+	qty_t add; // buffered quantity x becomes max(x+add, least)
+	qty_t least;
+};
+
+struct ParReplay {
+	struct ProvState *s;
+	struct Interaction *inter;
+	int numinter;
+	int numparts;
+	int *segstart; // segment k holds interactions segstart[k]..segstart[k+1]-1 (model 0)
+	struct SegVertex **touched; // vertices touched by each segment, in order of first interaction (model 0)
+	int *numtouched;
+	qty_t **below; // below[k][v] = quantity of vertex v in the groups before slice k (100, 111)
+	qty_t *sumbuffered; // buffered quantities after the batch (100, 111)
+};
+
+// summarizes segment t (model 0)
+static void segSummaryTask(void *arg, int t)
+{
+	struct ParReplay *r = (struct ParReplay *)arg;
+	struct Interaction *inter = r->inter;
+	struct SegVertex *tv;
+	int i,j,v,n = 0,cap = 16;
+	int *pos;
+	qty_t q;
+	
+	pos = (int *)calloc(r->s->numnodes,sizeof(int)); // 1 + position in tv, 0 if not touched yet
+	tv = (struct SegVertex *)malloc(cap*sizeof(struct SegVertex));
+	for(i=r->segstart[t];i<r->segstart[t+1];i++) {
+		for(j=0;j<2;j++) {
+			v = j ? inter[i].dest : inter[i].src;
+			if (pos[v]==0) {
+				if (n==cap) {
+					cap *= 2;
+					tv = (struct SegVertex *)realloc(tv,cap*sizeof(struct SegVertex));
+				}
+				tv[n].v = v;
+				tv[n].add = 0;
+				tv[n].least = 0;
+				pos[v] = ++n;
+			}
+		}
+		q = inter[i].qty;
+		if (inter[i].src==inter[i].dest) {
+			j = pos[inter[i].src]-1;
+			if (q>tv[j].least)
+				tv[j].least = q;
+			continue;
+		}
+		j = pos[inter[i].src]-1;
+		tv[j].add -= q;
+		tv[j].least = tv[j].least>q ? tv[j].least-q : 0;
+		j = pos[inter[i].dest]-1;
+		tv[j].add += q;
+		tv[j].least += q;
+	}
+	free(pos);
+	r->touched[t] = tv;
+	r->numtouched[t] = n;
+}
+
+// replays the batch on slice t of the groups, as ProvProportionalGroup (100, 111)
+static void groupSliceTask(void *arg, int t)
+{
+	struct ParReplay *r = (struct ParReplay *)arg;
+	struct ProvState *s = r->s;
+	struct Interaction *inter = r->inter;
+	qty_t **buffer = s->densebuffer;
+	qty_t *below = r->below[t];
+	qty_t *sumbuffered;
+	int g0 = (int)((long long)s->numgroups*t/r->numparts);
+	int g1 = (int)((long long)s->numgroups*(t+1)/r->numparts);
+	int i,j,src,dest,g;
+	qty_t qty,rest,sum;
+	
+	sumbuffered = (qty_t *)malloc(s->numnodes*sizeof(qty_t));
+	memcpy(sumbuffered,s->sumbuffered,s->numnodes*sizeof(qty_t));
+	for(i=0;i<r->numinter;i++)
+	{
+		src = inter[i].src;
+		dest = inter[i].dest;
+		sum = sumbuffered[src];
+		if (src==dest) {
+			// self-loop, as in ProvProportionalGroup
+			qty = inter[i].qty-sum;
+			if (qty>0) {
+				g = s->map[src];
+				if (g<g0)
+					below[src] += qty;
+				else if (g<g1)
+					buffer[src][g] += qty;
+				sumbuffered[src] = inter[i].qty;
+			}
+			continue;
+		}
+		if (inter[i].qty>=sum) {
+			for(j=g0;j<g1;j++) {
+				buffer[dest][j] += buffer[src][j];
+				buffer[src][j] = 0.0;
+			}
+			below[dest] += below[src];
+			below[src] = 0;
+			qty = inter[i].qty-sum;
+			if (qty>0) {
+				g = s->map[src];
+				if (g<g0)
+					below[dest] += qty;
+				else if (g<g1)
+					buffer[dest][g] += qty;
+			}
+			sumbuffered[src] = 0;
+			sumbuffered[dest] += inter[i].qty;
+		}
+		else {
+			rest = sum;
+			qty = propshare(inter[i].qty,below[src],&rest,sum);
+			below[dest] += qty;
+			below[src] -= qty;
+			for(j=g0;j<g1;j++)
+			{
+				qty = propshare(inter[i].qty,buffer[src][j],&rest,sum);
+				buffer[dest][j] += qty;
+				buffer[src][j] -= qty;
+			}
+			sumbuffered[src] -= inter[i].qty;
+			sumbuffered[dest] += inter[i].qty;
+		}
+	}
+	if (t==0)
+		r->sumbuffered = sumbuffered;
+	else
+		free(sumbuffered);
+}
+
+// processes a batch of interactions like runProvState, in numparts parts on numthreads threads:
+// time segments (0) or slices of the groups (100, 111)
+static int runParallel(struct ProvState *s, struct Interaction *inter, int numinter, int numparts, int numthreads)
+{
+	int j,k,v,g;
+	struct ParReplay r;
+	struct SegVertex *tv;
+	
+	if (s->method!=0 && s->method!=100 && s->method!=111) {
+		printf("ERROR: parallel replay supports models 0, 100 and 111 only\n");
+		return -1;
+	}
+	if (numparts>(s->method==0 ? numinter : s->numgroups))
+		numparts = s->method==0 ? numinter : s->numgroups;
+	if (numparts<=1)
+		return runProvState(s, inter, numinter);
+	
+	memset(&r,0,sizeof(r));
+	r.s = s;
+	r.inter = inter;
+	r.numinter = numinter;
+	r.numparts = numparts;
+	if (s->method==0) {
+		r.segstart = (int *)malloc((numparts+1)*sizeof(int));
+		for(k=0;k<=numparts;k++)
+			r.segstart[k] = (int)((long long)numinter*k/numparts);
+		r.touched = (struct SegVertex **)calloc(numparts,sizeof(struct SegVertex *));
+		r.numtouched = (int *)calloc(numparts,sizeof(int));
+		poolRun(numthreads, numparts, segSummaryTask, &r, NULL, 0);
+		for(k=0;k<numparts;k++) {
+			tv = r.touched[k];
+			for(j=0;j<r.numtouched[k];j++) {
+				v = tv[j].v;
+				s->sumbuffered[v] = s->sumbuffered[v]+tv[j].add>tv[j].least ? s->sumbuffered[v]+tv[j].add : tv[j].least;
+			}
+			free(tv);
+		}
+		free(r.touched);
+		free(r.numtouched);
+		free(r.segstart);
+	}
+	else {
+		// quantity of each vertex in the groups before each slice
+		r.below = (qty_t **)malloc(numparts*sizeof(qty_t *));
+		for(k=0;k<numparts;k++)
+			r.below[k] = (qty_t *)calloc(s->numnodes,sizeof(qty_t));
+		for(v=0;v<s->numnodes;v++) {
+			g = 0;
+			for(k=1;k<numparts;k++) {
+				r.below[k][v] = r.below[k-1][v];
+				for(;g<(int)((long long)s->numgroups*k/numparts);g++)
+					r.below[k][v] += s->densebuffer[v][g];
+			}
+		}
+		poolRun(numthreads, numparts, groupSliceTask, &r, NULL, 0);
+		free(s->sumbuffered);
+		s->sumbuffered = r.sumbuffered;
+		for(k=0;k<numparts;k++)
+			free(r.below[k]);
+		free(r.below);
+	}
+	s->numprocessed += numinter;
+	if (numinter>0)
+		s->lastts = inter[numinter-1].ts;
+	
+	return 0;
+}
+
+// parallel runs of the weakly connected components of a batch (see runPartitioned)
+struct PartReplay {
+	struct ProvState *s;
+	struct Interaction *parted; // interactions grouped by task (see partComponents)
+	int *index; // position in the batch of each interaction of parted
+	int *start;
+	struct ProvState *part; // engine of each task
+	int ret;
+};
+
+// processes task t on an engine that shares the buffers of s, with scratch space and counters of its own
+// the tasks touch disjoint sets of vertices, so they do not access the same buffers
+static void partTask(void *arg, int t)
+{
+	struct PartReplay *r = (struct PartReplay *)arg;
+	struct ProvState *s = r->s;
+	struct ProvState *e = &r->part[t];
+	int cap;
+	
+	*e = *s;
+	e->numtransfers = 0;
+	e->numrelays = 0;
+	e->numpruned = 0;
+	e->prunedqty = 0;
+	e->mergebuffer = NULL;
+	e->mergecapacity = 0;
+	e->ovscratch = NULL;
+	e->ovscratchcapacity = 0;
+	e->items = NULL;
+	e->itemcapacity = 0;
+	e->newbuffer = NULL;
+	e->newbufcapacity = 0;
+	e->shrinkqty = NULL;
+	if (s->method==121 || s->method==122 || s->method==125) {
+		cap = s->method!=121 ? s->budget+1 : (s->budget>s->reducedsize+2 ? s->budget : s->reducedsize+2);
+		e->newbuffer = (struct BufItemProp *)malloc((2*cap+1)*sizeof(struct BufItemProp));
+		e->shrinkqty = (qty_t *)malloc((2*cap+1)*sizeof(qty_t));
+	}
+	e->batchpos = r->index+r->start[t]; // buffer shrinks (121) are stamped with positions in the whole stream
+	if (runProvState(e, r->parted+r->start[t], r->start[t+1]-r->start[t])==-1)
+		r->ret = -1;
+	free(e->mergebuffer);
+	free(e->ovscratch);
+	free(e->items);
+	free(e->newbuffer);
+	free(e->shrinkqty);
+}
+
+// processes a batch of interactions like runProvState, running its weakly connected components in parallel
+// on numthreads threads; the result is the one of runProvState, as components never exchange quantity
+// the window-based model (120) resets all buffers every W interactions of the whole stream, so it is not supported
+static int runPartitioned(struct ProvState *s, struct Interaction *inter, int numinter, int numthreads)
+{
+	int t,numtasks,numcomp;
+	struct PartReplay r;
+	
+	if (s->method==120) {
+		printf("ERROR: the window-based model cannot run the components of the interactions in parallel\n");
+		return -1;
+	}
+	if (s->store!=NULL) {
+		printf("ERROR: the components of the interactions cannot run in parallel with a memory budget of the buffers\n");
+		return -1;
+	}
+	if (numinter==0)
+		return 0;
+	memset(&r,0,sizeof(r));
+	r.s = s;
+	numtasks = partComponents(inter, numinter, s->numnodes, numthreads, &r.parted, &r.index, &r.start, &numcomp);
+	printf("%d components in %d tasks, the largest with %d interactions\n",numcomp,numtasks,r.start[1]-r.start[0]);
+	fflush(stdout);
+	r.part = (struct ProvState *)malloc(numtasks*sizeof(struct ProvState));
+	poolRun(numthreads, numtasks, partTask, &r, NULL, 0);
+	for(t=0;t<numtasks;t++) {
+		s->numtransfers += r.part[t].numtransfers;
+		s->numrelays += r.part[t].numrelays;
+		s->numpruned += r.part[t].numpruned;
+		s->prunedqty += r.part[t].prunedqty;
+	}
+	free(r.part);
+	free(r.parted);
+	free(r.index);
+	free(r.start);
+	s->numprocessed += numinter;
+	s->lastts = inter[numinter-1].ts;
+	
+	return r.ret;
+}
+
+// writes the provenance of vertex v as of time T, i.e., after all interactions with timestamp <= T
+// the state is loaded from the latest snapshot of directory dir (see runWithSnapshots) taken at or before T,
+// and only the interactions of the graph after the snapshot are replayed
+// if no snapshot can be used (or dir is NULL), s is the starting state
+// interactions inter[0..numinter-1] must follow the s->numprocessed interactions of s
+static int queryProvAt(struct ProvState *s, struct OutWriter *w, struct Interaction *inter, int numinter, const char *dir, int v, double T)
+{
+	int k,start;
+	int base = s->numprocessed; // stream position of inter[0]
+	int np,best = base;
+	double ts;
+	char file[256];
+	char bestfile[256];
+	char path[4096];
+	char *line = NULL;
+	size_t len = 0;
+	FILE *idx;
+	struct ProvState params;
+	
+	if (v<0 || v>=s->numnodes) {
+		printf("ERROR: vertex %d does not exist\n",v);
+		return -1;
+	}
+	
+	if (dir!=NULL) {
+		snprintf(path,sizeof(path),"%s/%s",dir,SNAP_INDEX);
+		idx = fopen(path,"r");
+		if (idx==NULL) {
+			printf("ERROR: cannot open snapshot index %s\n",path);
+			return -1;
+		}
+		// latest snapshot covered by the graph whose interactions all have timestamp <= T
+		while (getline(&line,&len,idx) != -1)
+			if (sscanf(line,"%d\t%lf\t%255s",&np,&ts,file)==3 && np>best && np<=base+numinter && ts<=T) {
+				best = np;
+				strcpy(bestfile,file);
+			}
+		free(line);
+		fclose(idx);
+	}
+	
+	if (best>base) {
+		// replace s by the snapshot, keeping the model parameters
+		params = *s;
+		freeProvState(s);
+		s->method = params.method;
+		s->W = params.W;
+		s->T = params.T;
+		s->numepochs = params.numepochs;
+		s->budget = params.budget;
+		s->reducedsize = params.reducedsize;
+		s->numselected = params.numselected;
+		s->numgroups = params.numgroups;
+		s->dustabs = params.dustabs;
+		s->dustrel = params.dustrel;
+		s->memlimit = params.memlimit;
+		s->coldafter = params.coldafter;
+		s->quantum = params.quantum;
+		snprintf(path,sizeof(path),"%s/%s",dir,bestfile);
+		if (loadProvState(s, path)==-1)
+			return -1;
+		printf("starting from snapshot %s (%d interactions)\n",bestfile,s->numprocessed);
+	}
+	
+	start = s->numprocessed-base;
+	for(k=start; k<numinter && inter[k].ts<=T; k++);
+	if (runProvState(s, inter+start, k-start)==-1)
+		return -1;
+	printf("replayed %d interactions\n",k-start);
+	printf("provenance of vertex %d at time %.2f:\n",v,T);
+	fflush(stdout);
+	writeProvVertex(s,w,v);
+	outEnd(w);
+	
+	return 0;
+}
+
+
+// library interface (see provenance.h)
+
+// sets the levels of groups of s from p (112): levelgroups[l] is the number of groups of level l,
+// and rollup[l][g] the group of level l>0 that contains group g of level 0 (s->map)
+// groups of level 0 without vertices are rolled up to group 0
+static int initHierLevels(struct ProvState *s, const struct ProvParams *p)
+{
+	int i,l,g,c;
+	
+	s->numlevels = p->numlevels>1 ? p->numlevels : 1;
+	s->levelgroups = (int *)malloc(s->numlevels*sizeof(int));
+	s->rollup = (int **)calloc(s->numlevels,sizeof(int *));
+	s->levelgroups[0] = s->numgroups;
+	for(l=1;l<s->numlevels;l++) {
+		if (p->levelgroups==NULL || p->levelmap==NULL || p->levelmap[l]==NULL || p->levelgroups[l]<1) {
+			printf("ERROR: groups of level %d are missing\n",l);
+			return -1;
+		}
+		s->levelgroups[l] = p->levelgroups[l];
+		s->rollup[l] = (int *)malloc(s->numgroups*sizeof(int));
+		for(g=0;g<s->numgroups;g++)
+			s->rollup[l][g] = -1;
+		for(i=0;i<s->numnodes;i++) {
+			g = s->map[i];
+			c = p->levelmap[l][i];
+			if (c<0 || c>=s->levelgroups[l]) {
+				printf("ERROR: vertex %d is mapped to group %d of level %d, not in 0..%d\n",i,c,l,s->levelgroups[l]-1);
+				return -1;
+			}
+			if (s->rollup[l][g]==-1)
+				s->rollup[l][g] = c;
+			else if (s->rollup[l][g]!=c) {
+				printf("ERROR: groups of level %d do not contain the groups of level 0 (vertex %d)\n",l,i);
+				return -1;
+			}
+		}
+		for(g=0;g<s->numgroups;g++)
+			if (s->rollup[l][g]==-1)
+				s->rollup[l][g] = 0;
+	}
+	return 0;
+}
+
+struct ProvState *provCreate(int method, int numnodes, const struct ProvParams *p)
+{
+	int i;
+	struct ProvState *s;
+	
+	s = (struct ProvState *)calloc(1,sizeof(struct ProvState));
+	s->method = method;
+	s->numnodes = numnodes;
+	if (p!=NULL) {
+		s->W = p->W;
+		s->T = p->T;
+		s->numepochs = p->numepochs;
+		s->budget = p->budget;
+		s->reducedsize = p->reducedsize;
+		s->numselected = p->numselected;
+		s->numgroups = p->numgroups;
+		s->dustabs = p->dustabs;
+		s->dustrel = p->dustrel;
+		s->memlimit = p->memory;
+		if (p->spilldir!=NULL)
+			s->spilldir = strdup(p->spilldir);
+		s->coldafter = p->coldafter;
+		s->quantum = p->quantum;
+		if (method==110 && p->selectednodes!=NULL) {
+			s->selectednodes = (int *)malloc(s->numselected*sizeof(int));
+			memcpy(s->selectednodes,p->selectednodes,s->numselected*sizeof(int));
+		}
+		if ((method==100 || method==111 || method==112) && p->map!=NULL) {
+			s->map = (int *)malloc(numnodes*sizeof(int));
+			memcpy(s->map,p->map,numnodes*sizeof(int));
+		}
+	}
+	if ((method==110 && s->selectednodes==NULL) || ((method==100 || method==111 || method==112) && s->map==NULL)) {
+		printf("ERROR: parameters of provenance model %d are missing\n",method);
+		provDestroy(s);
+		return NULL;
+	}
+	if (s->map!=NULL)
+		for(i=0;i<numnodes;i++)
+			if (s->map[i]<0 || s->map[i]>=s->numgroups) {
+				printf("ERROR: vertex %d is mapped to group %d, not in 0..%d\n",i,s->map[i],s->numgroups-1);
+				provDestroy(s);
+				return NULL;
+			}
+	if (method==112 && initHierLevels(s,p)==-1) {
+		provDestroy(s);
+		return NULL;
+	}
+	if (initProvState(s)==-1) {
+		provDestroy(s);
+		return NULL;
+	}
+	return s;
+}
+
+struct ProvState *provRestore(int method, const struct ProvParams *p, const char *filename)
+{
+	struct ProvState *s;
+	
+	s = (struct ProvState *)calloc(1,sizeof(struct ProvState));
+	s->method = method;
+	if (p!=NULL) {
+		s->W = p->W;
+		s->T = p->T;
+		s->numepochs = p->numepochs;
+		s->budget = p->budget;
+		s->reducedsize = p->reducedsize;
+		s->numselected = p->numselected;
+		s->numgroups = p->numgroups;
+		s->dustabs = p->dustabs;
+		s->dustrel = p->dustrel;
+		s->memlimit = p->memory;
+		if (p->spilldir!=NULL)
+			s->spilldir = strdup(p->spilldir);
+		s->coldafter = p->coldafter;
+		s->quantum = p->quantum;
+	}
+	if (loadProvState(s, filename)==-1) {
+		provDestroy(s);
+		return NULL;
+	}
+	return s;
+}
+
+int provFeed(struct ProvState *s, const struct Interaction *inter, int numinter)
+{
+	return runProvState(s, (struct Interaction *)inter, numinter);
+}
+
+int provFeedParallel(struct ProvState *s, const struct Interaction *inter, int numinter, int numparts, int numthreads)
+{
+	return runParallel(s, (struct Interaction *)inter, numinter, numparts, numthreads);
+}
+
+int provFeedComponents(struct ProvState *s, const struct Interaction *inter, int numinter, int numthreads)
+{
+	return runPartitioned(s, (struct Interaction *)inter, numinter, numthreads);
+}
+
+int provFeedWithSnapshots(struct ProvState *s, const struct Interaction *inter, int numinter, const char *dir, int every, double dt)
+{
+	return runWithSnapshots(s, (struct Interaction *)inter, numinter, dir, every, dt);
+}
+
+int provQuery(struct ProvState *s, int v, struct BufItem **items)
+{
+	if (v<0 || v>=s->numnodes) {
+		*items = NULL;
+		return 0;
+	}
+	return getProvVertex(s, v, items);
+}
+
+int provQueryLevel(struct ProvState *s, int v, int level, struct BufItem **items)
+{
+	if (v<0 || v>=s->numnodes || level<0 || level>=(s->method==112 ? s->numlevels : 1)) {
+		*items = NULL;
+		return 0;
+	}
+	return getProvVertexLevel(s, v, level, items);
+}
+
+int provQueryAt(struct ProvState *s, struct OutWriter *w, const struct Interaction *inter, int numinter, const char *dir, int v, double T)
+{
+	return queryProvAt(s, w, (struct Interaction *)inter, numinter, dir, v, T);
+}
+
+int provSnapshot(struct ProvState *s, const char *filename)
+{
+	return saveProvState(s, filename);
+}
+
+void provPrint(struct ProvState *s, struct OutWriter *w)
+{
+	printProvState(s, w);
+}
+
+void provGetStats(struct ProvState *s, struct ProvStats *st)
+{
+	int i,j,n;
+	int cap;
+	long long memory = 0;
+	struct BufItem *items;
+	
+	memset(st,0,sizeof(struct ProvStats));
+	// with a store (4, 101), the resident and compressed buffers, before getProvVertex makes them resident
+	if (s->store!=NULL) {
+		for(i=0;i<s->numnodes;i++)
+			if (s->store->state[i]==BS_RESIDENT)
+				memory += nodebytes(s,i);
+		memory += s->store->packedbytes;
+	}
+	for(i=0;i<s->numnodes;i++) {
+		n = getProvVertex(s,i,&items);
+		for(j=0;j<n;j++)
+			if (items[j].qty!=0) {
+				st->numitems++;
+				st->sumqty += items[j].qty;
+			}
+		if (s->numbufshrinks!=NULL)
+			st->numshrinks += s->numbufshrinks[i];
+		
+		// buffers (see above for the ones with a store)
+		if (s->buffer!=NULL && s->store==NULL)
+			memory += s->bufcapacity[i]*sizeof(struct BufItem);
+		if (s->bufferpath!=NULL) {
+			memory += s->bufcapacity[i]*sizeof(struct BufItemPath);
+			for(j=0;j<s->bufsize[i];j++)
+				memory += s->bufferpath[i][j].pathcapacity*sizeof(int);
+		}
+		if (s->propbuffer!=NULL && s->bufcapacity!=NULL && s->store==NULL)
+			memory += s->bufcapacity[i]*sizeof(struct BufItemProp);
+		if (s->oddbuffer!=NULL)
+			memory += s->oddbufcapacity[i]*sizeof(struct BufItemProp);
+		if (s->densebuffer!=NULL)
+			memory += (s->method==110 ? s->numselected : s->numgroups)*sizeof(qty_t);
+		if (s->ovec!=NULL)
+			memory += ovMemory(&s->ovec[i])+sizeof(struct OriginVec);
+	}
+	if (s->method==121 || s->method==122 || s->method==125) {
+		cap = s->method!=121 ? s->budget+1 : (s->budget>s->reducedsize+2 ? s->budget : s->reducedsize+2);
+		memory += (long long)s->numnodes*cap*sizeof(struct BufItemProp) + (2*cap+1)*sizeof(struct BufItemProp);
+	}
+	// pointers and sizes of the per-vertex buffers
+	memory += (long long)s->numnodes*(sizeof(void *)+2*sizeof(int)+sizeof(qty_t));
+	st->memory = memory;
+	st->numpruned = s->numpruned;
+	st->prunedqty = s->prunedqty;
+}
+
+// compares the total quantity buffered at each vertex with the one of the model without provenance (0)
+// over inter, which must be all the interactions processed by s; prints the result and returns the number
+// of vertices whose totals differ (-1 on error)
+// with integer quantities (PROV_INTQTY) the totals must be equal, otherwise they may differ by rounding errors
+int provCheck(struct ProvState *s, const struct Interaction *inter, int numinter)
+{
+	int i,j,n;
+	int numdiff = 0;
+	qty_t sum, diff, maxdiff = 0;
+	double tolerance;
+	struct ProvState ref;
+	struct BufItem *items;
+	
+	if (numinter!=s->numprocessed) {
+		printf("ERROR: the conservation check needs all %d interactions processed by the model\n",s->numprocessed);
+		return -1;
+	}
+	memset(&ref,0,sizeof(ref));
+	ref.method = PROV_NOPROV;
+	ref.numnodes = s->numnodes;
+	if (initProvState(&ref)==-1)
+		return -1;
+	noProvFromMem(&ref,(struct Interaction *)inter,numinter);
+	for(i=0;i<s->numnodes;i++) {
+		n = getProvVertex(s,i,&items);
+		sum = 0;
+		for(j=0;j<n;j++)
+			sum += items[j].qty;
+		if (s->method==110)
+			sum += s->nonselectedqty[i];
+		diff = sum>ref.sumbuffered[i] ? sum-ref.sumbuffered[i] : ref.sumbuffered[i]-sum;
+		tolerance = QTY_INTEGER ? 0 : 0.000001*(1+fabs((double)ref.sumbuffered[i]));
+		if (diff>tolerance) {
+			numdiff++;
+			if (diff>maxdiff)
+				maxdiff = diff;
+		}
+	}
+	freeProvState(&ref);
+	if (numdiff)
+		printf("conservation check: %d vertices differ from the model without provenance, by up to %.2f\n",numdiff,(double)maxdiff);
+	else
+		printf("conservation check: all vertices agree with the model without provenance\n");
+	return numdiff;
+}
+
+int provTopOrigins(const struct Interaction *inter, int numinter, int numnodes, int *topk, int k, int contr)
+{
+	if (k>numnodes)
+		k = numnodes;
+	if (k<=0)
+		return 0;
+	noProvFromMem2((struct Interaction *)inter, numinter, numnodes, topk, k, contr);
+	qsort(topk,k,sizeof(int),cmpint);
+	return k;
+}
+
+int provGrow(struct ProvState *s, int numnodes)
+{
+	return growProvState(s, numnodes);
+}
+
+int provNumNodes(struct ProvState *s)
+{
+	return s->numnodes;
+}
+
+int provNumProcessed(struct ProvState *s)
+{
+	return s->numprocessed;
+}
+
+void provDestroy(struct ProvState *s)
+{
+	if (s==NULL)
+		return;
+	free(s->spilldir); // kept by freeProvState
+	freeProvState(s);
+	free(s);
+}
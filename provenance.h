@@ -0,0 +1,135 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*library interface of the provenance models*/
+/*an engine (struct ProvState) holds the buffers of one provenance model*/
+/*interactions are fed to it in batches, in time order*/
+
+#ifndef __PROVENANCE
+#define __PROVENANCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "minheap.h" // to obtain struct BufItem definition
+
+// provenance models
+#define PROV_NOPROV 0 // no provenance
+#define PROV_OLDEST_FIRST 1 // least recently born
+#define PROV_NEWEST_FIRST 2 // most recently born
+#define PROV_LIFO 3
+#define PROV_FIFO 4
+#define PROV_LIFO_PATHS 31 // LIFO with path tracking
+#define PROV_PROP_DENSE 100 // proportional (dense vectors)
+#define PROV_PROP 101 // proportional (sparse vectors)
+#define PROV_PROP_HYBRID 102 // proportional (hybrid sparse/dense vectors)
+#define PROV_PROP_SEL 110 // proportional (from selected vertices)
+#define PROV_PROP_GROUP 111 // proportional (from groups of vertices)
+#define PROV_PROP_HIER 112 // proportional (from a hierarchy of groups of vertices)
+#define PROV_PROP_WINDOW 120 // proportional (window-based)
+#define PROV_PROP_BUDGET 121 // proportional (budget-based)
+#define PROV_PROP_SKETCH 122 // proportional (heavy-hitter sketch)
+#define PROV_PROP_SLIDING 123 // proportional (sliding time window)
+#define PROV_PROP_DECAY 124 // proportional (exponential time decay)
+#define PROV_PROP_TOPK 125 // proportional (top-k origins per vertex)
+
+// the layout of struct Interaction and of the buffered items depends on the kind of quantities (see minheap.h), so with
+// integer quantities the functions that create an engine or take interactions without one have other names: a program
+// built with another kind of quantities than the library fails to link, instead of misreading them
+#ifdef PROV_INTQTY
+#define provCreate provCreateIntQty
+#define provRestore provRestoreIntQty
+#define provTopOrigins provTopOriginsIntQty
+#endif
+
+// struct for input interactions
+struct Interaction {
+	int src;
+	int dest;
+	double ts; //timestamp
+	qty_t qty; //quantity (see minheap.h)
+};
+
+// parameters of the provenance models; fields not used by a model are ignored
+// arrays are copied by provCreate
+struct ProvParams {
+	int W; // window size (120)
+	double T; // length of the time window (123), decay time constant (124)
+	int numepochs; // number of epochs per time window (123)
+	int budget; // buffer budget (121), number of counters of a sketch (122), number of origins per vertex (125)
+	int reducedsize; // size of a buffer after shrinking (121)
+	int numselected; // number of selected vertices (110)
+	int *selectednodes; // selected vertices (110)
+	int numgroups; // number of groups (100, 111), of the finest level (112)
+	int *map; // map[i] = group id whereto vertex i is mapped, for all numnodes vertices (100, 111), finest level (112)
+	int numlevels; // number of levels of groups, from the finest (level 0, map) to the coarsest (112)
+	int *levelgroups; // levelgroups[l] = number of groups of level l>0 (112)
+	int **levelmap; // levelmap[l][i] = group of vertex i at level l>0; each group of level 0 must be within one group (112)
+	double dustabs; // items with a smaller quantity are folded into origin -1 (101, 112, 120); 0: off
+	double dustrel; // same, for quantities smaller than this fraction of the quantity of the vertex (101, 112, 120); 0: off
+	long long memory; // bytes of resident buffers; the least recently used ones are spilled to a file (4, 101); 0: all resident
+	const char *spilldir; // directory of the spill file (NULL: current directory)
+	int coldafter; // buffers not used for this number of interactions are kept compressed (4, 101); 0: never
+	double quantum; // quantities of compressed buffers are rounded to multiples of it (lossy); 0: kept exactly
+};
+
+// statistics of the buffers of an engine
+struct ProvStats {
+	long long memory; // bytes allocated for the buffers
+	long long numitems; // number of non-zero buffered items
+	long long numshrinks; // number of buffer shrinks (121) or sketch reductions (122, 125)
+	double sumqty; // total buffered quantity
+	long long numpruned; // number of items folded into origin -1 as dust (101, 112, 120)
+	double prunedqty; // total quantity of these items
+};
+
+struct ProvState; // engine handle, opaque to the users of the library
+struct OutWriter; // see provout.h
+
+// creates an engine of model method for numnodes vertices; returns NULL on error
+PROV_API struct ProvState *provCreate(int method, int numnodes, const struct ProvParams *p);
+// creates an engine of model method from a checkpoint written by provSnapshot; returns NULL on error
+// parameters p (may be NULL) are only compared with the ones of the checkpoint
+PROV_API struct ProvState *provRestore(int method, const struct ProvParams *p, const char *filename);
+// processes a batch of interactions, which continues the ones processed so far
+PROV_API int provFeed(struct ProvState *s, const struct Interaction *inter, int numinter);
+// as provFeed, additionally writing snapshots to directory dir every every interactions
+// and/or whenever the timestamp enters a new period of length dt
+PROV_API int provFeedWithSnapshots(struct ProvState *s, const struct Interaction *inter, int numinter, const char *dir, int every, double dt);
+// as provFeed, replaying the batch in numparts parts on numthreads threads (models 0, 100 and 111)
+// model 0 splits the batch into time segments, whose summaries are composed in time order
+// (equal to provFeed with integer quantities, up to rounding errors otherwise);
+// models 100 and 111 split the groups into slices, and the result is equal to the one of provFeed
+PROV_API int provFeedParallel(struct ProvState *s, const struct Interaction *inter, int numinter, int numparts, int numthreads);
+// as provFeed, running the weakly connected components of the batch in parallel on numthreads threads
+// (all models but 120); the result is the one of provFeed
+PROV_API int provFeedComponents(struct ProvState *s, const struct Interaction *inter, int numinter, int numthreads);
+// sets *items to the buffered items of vertex v and returns their number
+// the items are owned by the engine and are valid until the next call
+// for models 100, 110 and 111 there is one item per group (origin = group id) or selected vertex (origin = vertex id)
+// for model 112 the origins are the groups of the finest level
+// for models 122 and 125 the ts field of an item is the error bound of its quantity,
+// for model 123 it is the start of the epoch when the quantity was born
+PROV_API int provQuery(struct ProvState *s, int v, struct BufItem **items);
+// as provQuery, with the origins rolled up to the groups of level level (112; level 0 for the other models)
+PROV_API int provQueryLevel(struct ProvState *s, int v, int level, struct BufItem **items);
+// writes the provenance of vertex v as of time T (see queryProvAt)
+PROV_API int provQueryAt(struct ProvState *s, struct OutWriter *w, const struct Interaction *inter, int numinter, const char *dir, int v, double T);
+// writes the state of the engine to a checkpoint file
+PROV_API int provSnapshot(struct ProvState *s, const char *filename);
+// prints statistics of the model and writes all buffers with writer w
+PROV_API void provPrint(struct ProvState *s, struct OutWriter *w);
+PROV_API void provGetStats(struct ProvState *s, struct ProvStats *st);
+// compares the total quantity buffered at each vertex with the one of the model without provenance,
+// over inter, all the interactions processed by s (exactly, with integer quantities); returns the number of mismatches
+PROV_API int provCheck(struct ProvState *s, const struct Interaction *inter, int numinter);
+// finds, with a pass of the model without provenance over inter, the k vertices with the largest contribution
+// as origins (contr=1) or the largest buffered quantity at the end (contr=0); topk must have room for k vertices
+// the vertices are stored in increasing order and their number (k, at most numnodes) is returned
+PROV_API int provTopOrigins(const struct Interaction *inter, int numinter, int numnodes, int *topk, int k, int contr);
+// adds vertices up to numnodes-1, with empty buffers, e.g. when the graph after a checkpoint has new vertices
+// (all models but 100, 111 and 112, whose groups do not cover the new vertices); returns 0 or -1
+PROV_API int provGrow(struct ProvState *s, int numnodes);
+PROV_API int provNumNodes(struct ProvState *s);
+PROV_API int provNumProcessed(struct ProvState *s);
+PROV_API void provDestroy(struct ProvState *s);
+
+#endif // __PROVENANCE
@@ -3,2273 +3,1257 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <limits.h>
 #include <time.h>
 #include <unistd.h>
-#include "minheap.h"
-#include "fifoqueue.h"
-
-// struct for input interactions
-struct Interaction {
-	int src;
-	int dest;
-	double ts; //timestamp
-	double qty; //quantity
-};
-
-// struct for buffered items (for proportional tracking - no timestamp needed)
-struct BufItemProp { 
-	int origin;
-	double qty; //quantity
-};
-
-// struct for paths of bufitems
-// used in how-provenance
-struct BufItemPath { 
-	int pathlen;
-	int pathcapacity;
-	int *path; //quantity
-};
-
-
+#include <getopt.h>
+#include <pthread.h>
+#include "provout.h"
+#include "provenance.h"
+#include "threadpool.h"
+#include "groupmap.h"
+#include "reorder.h"
+#include "graphio.h"
 
 // assume a graph input file of the form:
 // <number of nodes>
 // <source> <dest> <timestamp> <quantity>
 // ....
-// file should be sorted by timestamp
+// file should be sorted by timestamp (see provsort); it may also be a binary graph file (see graphio.h)
 // the algorithm reads the interactions line-by-line and updates the relevant buffers
 // --------------------
 // computes the flow at each node after processing all interactions in time order
 // interaction <source> <dest> <timestamp> <quantity> transfers <quantity> 
 // from <source> buffer to <dest> buffer
 // if buffer has insufficient quantity, then the source node 'bears' the difference
+// with --reorder/--lateness, interactions that arrive slightly out of order are sorted while reading,
+// and with --stream they are fed to the engine in batches while reading (graph file - is stdin)
 
+#define STREAM_BATCH 65536 // interactions fed to the engine at a time in streaming mode
 
-// read graph from file into memory
-int readGraph(FILE *f, struct Interaction **inter, int *numinter, int *numnodes)
+
+// appends interaction x to *inter (of size *capacity, doubled when full)
+void addInteraction(struct Interaction **inter, int *numinter, int *capacity, const struct Interaction *x)
 {
-    int i,j,k;
-    
-    char *line = NULL; // used for fileread
-	size_t len = 0; // used for fileread
-	ssize_t read; // used for fileread
-	const char delim[2] = "\t"; // used for fileread
-	char *token; // used for fileread
+	if (*numinter==*capacity) {
+		*capacity = *capacity>0 ? 2*(*capacity) : 1024;
+		*inter = (struct Interaction *)realloc(*inter,(*capacity)*sizeof(struct Interaction));
+	}
+	(*inter)[(*numinter)++] = *x;
+}
 
-	/* read first line */
-	/* first line should be <numnodes> */
-	read = getline(&line, &len, f);
-	if (read==-1)
-	{
-		printf("ERROR: first line is empty. Exiting...\n");
-		return -1;
-	};
-	token = strtok(line,delim);
-	(*numnodes) = atoi(token);
-	printf("numnodes=%d\n",*numnodes);
+// read graph from file into memory
+// without a reorder buffer (rb==NULL), the interactions must be sorted by timestamp;
+// otherwise they pass through rb, which puts them in time order and drops the ones that arrive too late
+int readGraph(struct GraphReader *gr, struct Interaction **inter, int *numinter, int *numnodes, struct ReorderBuffer *rb)
+{
+	int capacity, ret;
+	int numdisordered = 0; // interactions before the previous one
+	long long firstdisordered = 0;
+	struct Interaction x;
 	
-	/* second line should be <numinter> */
-	read = getline(&line, &len, f);
-	if (read==-1)
-	{
-		printf("ERROR: second line is empty. Exiting...\n");
-		return -1;
-	};
-	token = strtok(line,delim);
-	(*numinter) = atoi(token);
+	(*numnodes) = gr->numnodes;
+	(*numinter) = gr->numinter;
+	printf("numnodes=%d\n",*numnodes);
 	printf("numinter=%d\n",*numinter);
-	
-	*inter = (struct Interaction *)malloc((*numinter)*sizeof(struct Interaction));
+	capacity = *numinter>0 ? *numinter : 1024;
+	*inter = (struct Interaction *)malloc(capacity*sizeof(struct Interaction));
     *numinter = 0; //reset for re-counting
 		
 	// Read interactions from file
-	while ((read = getline(&line,&len,f)) != -1)	{
-		token = strtok(line,delim);
-		(*inter)[(*numinter)].src = atoi(token);
-		token = strtok(NULL,delim);
-		(*inter)[(*numinter)].dest = atoi(token);
-		token = strtok(NULL,delim);
-		(*inter)[(*numinter)].ts = atof(token);
-		token = strtok(NULL,delim);
-		(*inter)[(*numinter)].qty = atof(token);
-
-		(*numinter)++;
+	while ((ret = grNext(gr, &x))==0) {
+		if (rb==NULL) {
+			if (*numinter>0 && x.ts<(*inter)[*numinter-1].ts && numdisordered++==0)
+				firstdisordered = gr->lineno;
+			addInteraction(inter, numinter, &capacity, &x);
+			continue;
+		}
+		if (roPush(rb, &x)==-1)
+			ret = -1;
+		while (roPop(rb, &x, 0))
+			addInteraction(inter, numinter, &capacity, &x);
+		if (ret==-1)
+			break;
+	}
+	if (ret==-1)
+		return -1;
+	if (rb!=NULL) {
+		while (roPop(rb, &x, 1))
+			addInteraction(inter, numinter, &capacity, &x);
+		roReport(rb);
+	}
+	if (numdisordered>0) {
+		printf("ERROR: graph file is not sorted by timestamp: %d interactions are older than the previous one, the first at %s %lld\n",
+			numdisordered,gr->binary ? "interaction" : "line",firstdisordered);
+		printf("use --reorder <capacity> and/or --lateness <time> to sort them while reading, or sort the file with provsort\n");
+		return -1;
 	}
 
     return 0;
 }
 
-// interactions are read from memory
-int noProvFromMem(struct Interaction *inter, int numinter, int numnodes)
+// sets *n to the number written in the whole of arg and returns 1, or returns 0 if arg is not one (e.g. a file name)
+int readCount(const char *arg, int *n)
 {
-    int i,j;
-
-    double *buffer; // array of buffers, one for each node of the Graph
-    
-	double relayqty;
-		    
-    buffer = (double *)malloc(numnodes*sizeof(double));
-    for(i=0;i<numnodes;i++)
-        buffer[i]=0.0; // initially, all buffers are 0
-    
-	for(i=0;i<numinter;i++)
-	{
-		relayqty = buffer[inter[i].src]<inter[i].qty ? buffer[inter[i].src]:inter[i].qty; // min(buffer[src],qty)
-		buffer[inter[i].src] -= relayqty;
-		buffer[inter[i].dest] += inter[i].qty;
-		//for(j=0;j<numnodes;j++) printf("%d\t%f\n",j,buffer[j]);
-	}
-
-	int stop = 100<numnodes ? 100:numnodes;
-	/*
-	for(i=0;i<stop;i++)
-       printf("node %d buffer = %f\n",i,buffer[i]);
-       */
-       
-	//for(i=0;i<numnodes;i++)
-	//	printf("%d\t%f\n",i,buffer[i]);
-		
-	double sumqty =0.0;
-	for(i=0;i<numnodes;i++)
-       sumqty+=buffer[i];
-    printf("sumqty=%.2f\n",sumqty);
-
-	free(buffer);
+	char *end;
+	long x;
 	
-    return 0;
+	x = strtol(arg,&end,10);
+	if (end==arg || *end!='\0' || x<0 || x>INT_MAX)
+		return 0;
+	*n = (int)x;
+	return 1;
 }
 
-// comparison function for doubles (descending order)
-int cmpfunc (const void * a, const void * b)
+// sets *bytes to the positive number of megabytes (e.g. 0.5) written in the whole of arg and returns 1,
+// or returns 0 if arg is not one
+int readMegabytes(const char *arg, long long *bytes)
 {
-  if (*(double*)a < *(double*)b)
-    return 1;
-  else if (*(double*)a > *(double*)b)
-    return -1;
-  else
-    return 0;  
+	char *end;
+	double x;
+	
+	x = strtod(arg,&end);
+	if (end==arg || *end!='\0' || !(x>0) || !(x*1048576<LLONG_MAX) || (long long)(x*1048576)<1)
+		return 0;
+	*bytes = (long long)(x*1048576);
+	return 1;
 }
 
-// same as noProvFromMem, but 
-// records in array topk the k vertices with the largest contribution or buffer as origins 
-int noProvFromMem2(struct Interaction *inter, int numinter, int numnodes, int *topk, int k, int contr)
+// reads the selected vertices of model 110 (whitespace-separated vertex ids) from a text file
+int readSelection(const char *filename, int **nodes, int *num)
 {
-    int i,j;
-    int numelems, posel, p, tmp, swap; // for heap
-
-    double *buffer; // array of buffers, one for each node of the Graph
-    double *contributions; // contribution of each node (as origin)
-    
-    double *comp; // top-k based on comp: either contribution (if contr=1) or sumbuffered (if contr=0)
-    
-	double relayqty;
-		    
-    buffer = (double *)malloc(numnodes*sizeof(double));
-    contributions = (double *)malloc(numnodes*sizeof(double));
-    for(i=0;i<numnodes;i++) {
-        buffer[i]=0.0; // initially, all buffers are 0
-        contributions[i]=0.0; // initially, all contributions are 0
-    }
-    
-	for(i=0;i<numinter;i++)
-	{
-		relayqty = buffer[inter[i].src]<inter[i].qty ? buffer[inter[i].src]:inter[i].qty; // min(buffer[src],qty)
-		if (inter[i].qty>buffer[inter[i].src]) // vertex bears new qty
-			contributions[inter[i].src] += inter[i].qty-buffer[inter[i].src];
-		buffer[inter[i].src] -= relayqty;
-		buffer[inter[i].dest] += inter[i].qty;
+	FILE *f;
+	int v, capacity = 16;
+	
+	f = fopen(filename,"r");
+	if (f==NULL) {
+		printf("ERROR: cannot open selection file %s\n",filename);
+		return -1;
 	}
-		
-	double sumqty =0.0;
-	for(i=0;i<numnodes;i++)
-       sumqty+=buffer[i];
-    printf("sumqty in buffers=%.2f\n",sumqty);
-
-	sumqty =0.0;
-	for(i=0;i<numnodes;i++) {
-       sumqty+=contributions[i];
-       //printf("%d contribution:%.2f\n",i,contributions[i]);
-    }
-    printf("sumqty in contributions=%.2f\n",sumqty);    
-    
-    if (contr)
-    	comp = contributions;
-    else
-    	comp = buffer;
-
-	// now find top-k based on comp array
-    //initialize minheap
-    if (k>=numnodes) {
-    	//trivial case
-    	for(i=0;i<numnodes;i++)
-    		topk[i]=i;
-    }
-    else {    
-		//add first k elements
-		numelems = 0;		
-		for(i=0;i<k;i++) {
-			//enqueue vertex i
-			posel = numelems; //last position
-			topk[numelems++] = i;
-			//newitem = i;
-
-			while(posel >0)
-			{
-				p=parent(posel);
-				if (comp[i]<comp[topk[p]])
-				{
-			  		/* swap element with its parent */
-				  topk[posel] = topk[p];
-				  topk[p] = i;
-
-				  posel = parent(posel);
-				}
-				else break;
-			}
-		}
-		
-		//examine remaining elements
-		for(;i<numnodes;i++) {
-			if (comp[i]>comp[topk[0]]) // i must be added to heap
-			{
-				topk[0] = i; //place i at the top of the min-heap
-				//correct heap (movedown)
-				posel = 0;
-				while (posel*2+1 < k) /*there exists a left son*/
-				{
-					if (posel*2+2< k) /*there exists a right son*/
-					{
-						if(comp[topk[posel*2+1]]<comp[topk[posel*2+2]])
-							swap = posel*2+1;
-						else
-							swap = posel*2+2;
-					}
-					else
-						swap = posel*2+1;
-
-					if (comp[topk[posel]] > comp[topk[swap]]) /*larger than smallest son*/
-					{
-						/*swap elements*/	
-						tmp = topk[swap];
-						topk[swap] = topk[posel];
-						topk[posel] = tmp;
-			
-						posel = swap;
-					}
-					else break;
-				}
-			}
+	*num = 0;
+	*nodes = (int *)malloc(capacity*sizeof(int));
+	while (fscanf(f,"%d",&v)==1) {
+		if (*num==capacity) {
+			capacity *= 2;
+			*nodes = (int *)realloc(*nodes,capacity*sizeof(int));
 		}
+		(*nodes)[(*num)++] = v;
 	}
-	
-	free(buffer);
-	free(contributions);
-	
-    return 0;
+	fclose(f);
+	return 0;
 }
 
-// provenance oldest birth first model
-// Least Recently Born in paper
-int ProvOldestFirst(struct Interaction *inter, int numinter, int numnodes)
+// sets *map to a level of groups of model 112: the vertices themselves (vertex) or a group map file
+int readLevel(const char *arg, int numnodes, int **map, int *numgroups)
 {
-    int i,j,k;
-
-    struct BufItem **buffer; // array of buffers, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-    
-	double relayqty;
-	double residueqty;
-	int src;
-	int dest;
-	struct BufItem newentry;
+	int i;
 	
-	int numtransfers = 0;
-	int numrelays = 0;
-	
-	clock_t t,tnow;
-	double cumqty = 0.0; //cumulative quantity
-	
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-    buffer = (struct BufItem **)malloc(numnodes*sizeof(struct BufItem *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        bufcapacity[i]=3;
-        buffer[i] = (struct BufItem *)malloc(bufcapacity[i]*sizeof(struct BufItem));
-    }
-    
-    t = clock(); 
-	for(i=0;i<numinter;i++)
-	{
-		cumqty += inter[i].qty;
-		residueqty=inter[i].qty; // remaining quantity to be transferred
-		src = inter[i].src;
-		dest = inter[i].dest;
-		while (residueqty>0 && bufsize[src])
-		{
-			numtransfers++;
-			if (buffer[src][0].qty>residueqty) { // buffer[src][0] is quantity with oldest birth
-				newentry.origin = buffer[src][0].origin;
-				newentry.ts = buffer[src][0].ts;
-				newentry.qty = residueqty;
-				enqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
-				buffer[src][0].qty-=residueqty;
-				residueqty = 0;
-			}
-			else { //entire entry must be relayed from src to dest
-				numrelays++;
-				dequeue(&newentry,buffer[src],&bufsize[src]);
-				enqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
-				residueqty-=newentry.qty;
-			}
-		}
-		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
-		{	
-			numtransfers++;
-			newentry.origin = src;
-			newentry.ts = inter[i].ts;
-			newentry.qty = residueqty;
-			enqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
-		}
-	}
-	
-	int sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	int sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-    double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-    printf("sumqty=%.2f\n",sumqty);
-    printf("numtransfers=%d\n",numtransfers);
-    printf("numrelays=%d\n",numrelays);
-
-    for(i=0;i<numnodes;i++){
-		printf("Buffer of vertex %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(o=%d,ts=%.2f,qty=%.2f) ",buffer[i][j].origin,buffer[i][j].ts,buffer[i][j].qty);
-		printf("\n");
+	if (!strcmp(arg,"vertex")) {
+		*map = (int *)malloc(numnodes*sizeof(int));
+		for(i=0;i<numnodes;i++)
+			(*map)[i] = i;
+		*numgroups = numnodes;
+		return 0;
 	}
-	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	
-    return 0;
+	return gmLoad(arg, numnodes, map, numgroups);
 }
 
-// provenance newest birth first model
-// same as oldest first, but all timestamps are made negative
-// in order to prioritize newest ones (smallest negative ones)
-int ProvNewestFirst(struct Interaction *inter, int numinter, int numnodes)
+// frees the arrays of parameters p set by setupMethod
+void freeParams(struct ProvParams *p)
 {
-    int i,j,k;
-
-    struct BufItem **buffer; // array of buffers, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-    
-	double relayqty;
-	double residueqty;
-	int src;
-	int dest;
-	struct BufItem newentry;
-	
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-	clock_t t,tnow;
-	 
-    buffer = (struct BufItem **)malloc(numnodes*sizeof(struct BufItem *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        bufcapacity[i]=3;
-        buffer[i] = (struct BufItem *)malloc(bufcapacity[i]*sizeof(struct BufItem));
-    }
-    
-	t = clock();
-
-	for(i=0;i<numinter;i++)
-	{
-		residueqty=inter[i].qty; // remaining quantity to be transferred
-		src = inter[i].src;
-		dest = inter[i].dest;
-		while (residueqty>0 && bufsize[src])
-		{
-			if (buffer[src][0].qty>residueqty) { // buffer[src][0] is quantity with oldest birth
-				newentry.origin = buffer[src][0].origin;
-				newentry.ts = buffer[src][0].ts;
-				newentry.qty = residueqty;
-				enqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
-				buffer[src][0].qty-=residueqty;
-				residueqty = 0;
-			}
-			else { //entire entry must be relayed from src to dest
-				dequeue(&newentry,buffer[src],&bufsize[src]);
-				enqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
-				residueqty-=newentry.qty;
-			}
-		}
-		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
-		{
-			newentry.origin = src;
-			newentry.ts = -inter[i].ts;
-			newentry.qty = residueqty;
-			enqueue(newentry,&buffer[dest],&bufsize[dest],&bufcapacity[dest]);
-		}
-
-	}
-	
-	int sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	int sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-	double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-    printf("sumqty=%.2f\n",sumqty);
-
-    for(i=0;i<numnodes;i++){
-		printf("Buffer of vertex %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(o=%d,ts=%.2f,qty=%.2f) ",buffer[i][j].origin,buffer[i][j].ts,buffer[i][j].qty);
-		printf("\n");
-	}
+	int l;
 	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	
-    return 0;
+	free(p->selectednodes);
+	free(p->map);
+	if (p->levelmap!=NULL)
+		for(l=1;l<p->numlevels;l++)
+			free(p->levelmap[l]);
+	free(p->levelmap);
+	free(p->levelgroups);
 }
 
-// provenance LIFO model
-// last-in first out when propagating quantities
-// each node's buffer is managed as a stack 
-int ProvLIFO(struct Interaction *inter, int numinter, int numnodes)
+// sets the parameters p of model method from its arguments args[0..numargs-1]
+// inter (numinter interactions) is used by models whose parameters are derived from the interactions (110, 111);
+// it is NULL in streaming mode
+// *title is printed when the model starts, *name is reported with its execution time
+int setupMethod(int method, int numargs, char **args, const struct Interaction *inter, int numinter, int numnodes, struct ProvParams *p, char **title, char **name)
 {
-    int i,j,k;
-
-    struct BufItem **buffer; // array of buffers, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-    
-	double relayqty;
-	double residueqty;
-	int src;
-	int dest;
-	struct BufItem newentry;
+	int i;
 	
-	int numtransfers = 0;
+	memset(p,0,sizeof(struct ProvParams));
 	
-	clock_t t,tnow;
-
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-    buffer = (struct BufItem **)malloc(numnodes*sizeof(struct BufItem *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        bufcapacity[i]=3; //initial capacity per buffer
-        buffer[i] = (struct BufItem *)malloc(bufcapacity[i]*sizeof(struct BufItem));
-    }
-
-	t = clock();
-	    
-	for(i=0;i<numinter;i++)
+	switch(method)
 	{
-		residueqty=inter[i].qty; // remaining quantity to be transferred
-		src = inter[i].src;
-		dest = inter[i].dest;
-		if (src==dest) continue;
-		while (residueqty>0 && bufsize[src])
-		{
-			numtransfers++;
-			if (buffer[src][bufsize[src]-1].qty>residueqty) { // buffer[src][-1] is most recently added quantity (stack's top)
-				newentry.origin = buffer[src][bufsize[src]-1].origin;
-				newentry.ts = buffer[src][bufsize[src]-1].ts; //not used
-				newentry.qty = residueqty;
-				if (bufcapacity[dest] <= bufsize[dest]) {
-					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
-					bufcapacity[dest] *= 2;
-				}
-				buffer[dest][bufsize[dest]++] = newentry;
-				
-				buffer[src][bufsize[src]-1].qty-=residueqty;
-				residueqty = 0;
-			}
-			else { //entire entry must be relayed from src to dest
-				if (bufcapacity[dest] <= bufsize[dest]) {
-					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
-					bufcapacity[dest] *= 2;
-				}
-				buffer[dest][bufsize[dest]++] = buffer[src][bufsize[src]-1];
-				residueqty-=buffer[src][bufsize[src]-1].qty;
-				
-				bufsize[src]--; // implicitly removes top element (no need to implement this explicitly)
-			}
-		}
-		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
-		{	
-			numtransfers++;
-			newentry.origin = src;
-			newentry.ts = inter[i].ts; // not used
-			newentry.qty = residueqty;
+		case 0:
+		*title = "NoProvenance";
+		*name = "NoProvenance";
+		break;
+		
+		case 1:
+		*title = "ProvOldestFirst (least recently born)";
+		*name = "ProvOldestFirst (least recently born)";
+		break;
+		
+		case 2:
+		*title = "ProvNewestFirst (most recently born)";
+		*name = "ProvNewestFirst (most recently born)";
+		break;
+		
+		case 3:
+		*title = "ProvLIFO";
+		*name = "ProvLIFO";
+		break;
 			
-			if (bufcapacity[dest] <= bufsize[dest]) {
-				buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
-				bufcapacity[dest] *= 2;
-			}
-			buffer[dest][bufsize[dest]++] = newentry;
-		}
+		case 4:
+		*title = "ProvFIFO";
+		*name = "ProvFIFO";
+		break;
 		
-	}
-
-	int sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	int sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-    double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-    printf("sumqty=%.2f\n",sumqty);
-    printf("numtransfers=%d\n",numtransfers);
-
-
-    for(i=0;i<numnodes;i++){
-		printf("Buffer of vertex %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(o=%d,qty=%.2f) ",buffer[i][j].origin,buffer[i][j].qty);
-		printf("\n");
-	}
-
-
-    for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	
-    return 0;
-}
-
-// provenance LIFO model
-// last-in first out when propagating quantities
-// each node's buffer is managed as a stack
-// tracks paths of buffered quantities 
-int ProvLIFOPaths(struct Interaction *inter, int numinter, int numnodes)
-{
-    int i,j,k;
+		case 31:
+		*title = "ProvLIFOPaths";
+		*name = "ProvLIFOPaths";
+		break;
+		
+		case 100:
+		// use ProvProportionalGroup to simulate ProvPropDense
+		// if size of each group is one then each group is one vertex
+		//initialize groups
+		p->map = (int *)malloc(numnodes*sizeof(int));	
+		p->numgroups = numnodes;
+		//assignment by a simple hash function (should be replaced by something else)
+		for(i=0;i<numnodes;i++)
+			p->map[i] = i % p->numgroups;
+		*title = "ProvProportional";
+		*name = "ProvProportional";
+		break;
 
-    struct BufItem **buffer; // array of buffers, one for each node of the Graph
-    struct BufItemPath **bufferpath; // array of buffer paths, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-    
-	double relayqty;
-	double residueqty;
-	int src;
-	int dest;
-	struct BufItem newentry;
-	struct BufItemPath newpathentry;
-	
-	int numtransfers = 0;
-	
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-    buffer = (struct BufItem **)malloc(numnodes*sizeof(struct BufItem *));
-    bufferpath = (struct BufItemPath **)malloc(numnodes*sizeof(struct BufItemPath *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        bufcapacity[i]=3; //initial capacity per buffer
-        buffer[i] = (struct BufItem *)malloc(bufcapacity[i]*sizeof(struct BufItem));
-        bufferpath[i] = (struct BufItemPath *)malloc(bufcapacity[i]*sizeof(struct BufItemPath));
-    }
-    
-	for(i=0;i<numinter;i++)
-	{
-		residueqty=inter[i].qty; // remaining quantity to be transferred
-		src = inter[i].src;
-		dest = inter[i].dest;
-		if (src==dest) continue;
-		while (residueqty>0 && bufsize[src])
-		{
-			numtransfers++;
-			if (buffer[src][bufsize[src]-1].qty>residueqty) { // buffer[src][-1] is most recently added quantity (stack's top)
-				newentry.origin = buffer[src][bufsize[src]-1].origin;
-				newentry.ts = buffer[src][bufsize[src]-1].ts; //not used
-				newentry.qty = residueqty;
-				newpathentry.pathlen = bufferpath[src][bufsize[src]-1].pathlen+1;
-				newpathentry.pathcapacity = bufferpath[src][bufsize[src]-1].pathlen+1;
-				newpathentry.path = (int *)malloc(newpathentry.pathcapacity*sizeof(int));
-				for(j=0;j<bufferpath[src][bufsize[src]-1].pathlen;j++) // copy existing path from source
-					newpathentry.path[j] = bufferpath[src][bufsize[src]-1].path[j];
-				newpathentry.path[bufferpath[src][bufsize[src]-1].pathlen]=src; // add source node to path
-				if (bufcapacity[dest] <= bufsize[dest]) {
-					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
-					bufferpath[dest] = (struct BufItemPath *)realloc(bufferpath[dest], bufcapacity[dest]*2*sizeof(struct BufItemPath));
-					bufcapacity[dest] *= 2;
-				}
-				buffer[dest][bufsize[dest]] = newentry;
-				bufferpath[dest][bufsize[dest]++] = newpathentry;
-				buffer[src][bufsize[src]-1].qty-=residueqty;
-				residueqty = 0;
-			}
-			else { //entire entry must be relayed from src to dest
-				if (bufcapacity[dest] <= bufsize[dest]) {
-					buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
-					bufferpath[dest] = (struct BufItemPath *)realloc(bufferpath[dest], bufcapacity[dest]*2*sizeof(struct BufItemPath));
-					bufcapacity[dest] *= 2;
-				}
-				buffer[dest][bufsize[dest]] = buffer[src][bufsize[src]-1];
-				bufferpath[dest][bufsize[dest]] = bufferpath[src][bufsize[src]-1];
-				if (bufferpath[dest][bufsize[dest]].pathcapacity <=  bufferpath[dest][bufsize[dest]].pathlen) {
-					bufferpath[dest][bufsize[dest]].path = (int *)realloc(bufferpath[dest][bufsize[dest]].path,bufferpath[dest][bufsize[dest]].pathcapacity*2*sizeof(int));
-					bufferpath[dest][bufsize[dest]].pathcapacity *= 2;
-				}
-				bufferpath[dest][bufsize[dest]].path[bufferpath[dest][bufsize[dest]].pathlen++]=src;
-				bufsize[dest]++;
-				
-				residueqty-=buffer[src][bufsize[src]-1].qty;				
-				bufsize[src]--; // implicitly removes top element (no need to implement this explicitly - MEMORY LEAK)
+		case 101:
+		*title = "ProvProportional Sparse";
+		*name = "ProvProportional Sparse";
+		break;
+		
+		case 102:
+		*title = "ProvProportional Hybrid";
+		*name = "ProvProportional Hybrid";
+		break;
+		
+		case 110:
+		if (numargs != 1 && numargs != 2) {
+			printf("arguments: <graph file> <method> <numselected> [first|contrib|buffer] or <graph file> <method> <selection file>\n");
+    		return -1;
+		}
+		if (!readCount(args[0], &p->numselected)) {
+			// vertices listed in a file
+			if (numargs==2) {
+				printf("ERROR: %s is not a number of vertices\n",args[0]);
+				return -1;
 			}
+			if (readSelection(args[0], &p->selectednodes, &p->numselected)==-1)
+				return -1;
 		}
-		if (residueqty>0) // src did not have enough buffered quantity to relay; give birth to new flow item
-		{	
-			numtransfers++;
-			newentry.origin = src;
-			newentry.ts = inter[i].ts; // not used
-			newentry.qty = residueqty;
-			newpathentry.pathlen = 0; // new path (origin always defines first node of path)
-			newpathentry.pathcapacity = 3;
-			newpathentry.path = (int *)malloc(newpathentry.pathcapacity*sizeof(int));
-			if (bufcapacity[dest] <= bufsize[dest]) {
-				buffer[dest] = (struct BufItem *)realloc(buffer[dest], bufcapacity[dest]*2*sizeof(struct BufItem));
-				bufferpath[dest] = (struct BufItemPath *)realloc(bufferpath[dest], bufcapacity[dest]*2*sizeof(struct BufItemPath));
-				bufcapacity[dest] *= 2;
+		else {
+			// number of selected vertices
+			p->selectednodes = (int *)malloc(p->numselected*sizeof(int));
+			if (numargs==1 || !strcmp(args[1],"first")) {
+				for (i=0; i<p->numselected; i++) // first numselected vertices are selected
+					p->selectednodes[i] = i;
+			}
+			else if ((!strcmp(args[1],"contrib") || !strcmp(args[1],"buffer")) && inter==NULL) {
+				printf("ERROR: selection %s needs all interactions, so it cannot be used with --stream\n",args[1]);
+				return -1;
+			}
+			else if (!strcmp(args[1],"contrib") || !strcmp(args[1],"buffer")) {
+				// a pass without provenance finds the largest contributors or buffer holders
+				p->numselected = provTopOrigins(inter, numinter, numnodes, p->selectednodes, p->numselected, args[1][0]=='c');
+				printf("selected the %d vertices with the largest %s:",p->numselected,args[1][0]=='c' ? "contribution" : "buffered quantity");
+				for (i=0; i<p->numselected; i++)
+					printf(" %d",p->selectednodes[i]);
+				printf("\n");
+			}
+			else {
+				printf("ERROR: unknown selection %s (first, contrib or buffer)\n",args[1]);
+				return -1;
 			}
-			buffer[dest][bufsize[dest]] = newentry;
-			bufferpath[dest][bufsize[dest]++] = newpathentry;
 		}
+		*title = "ProvProportional Selective";
+		*name = "ProvProportionalSel";
+		break;
 		
-	}
-
-	int sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	int sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-    double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-    printf("sumqty=%.2f\n",sumqty);
-    printf("numtransfers=%d\n",numtransfers);
-
-
-	// print paths
-    for(i=0;i<numnodes;i++){
-		printf("Buffer of vertex %d:\n",i);
-		for(j=0;j<bufsize[i];j++) {
-			printf("(o=%d,qty=%.2f) ",buffer[i][j].origin,buffer[i][j].qty);
-			printf("path: %d->",buffer[i][j].origin);
-			for(k=0;k<bufferpath[i][j].pathlen;k++)
-				printf("%d->",bufferpath[i][j].path[k]);
-			printf("%d\n",i);
-		}
-		//printf("\n");
-	}
-
-
-	// count path info
-	int totalpathinfo = 0; //total length of all paths
-    for(i=0;i<numnodes;i++){
-		for(j=0;j<bufsize[i];j++) {
-			totalpathinfo += bufferpath[i][j].pathlen;
+		case 111:
+		if (numargs < 1 || numargs > 3 || (numargs > 1 && strcmp(args[0],"lp"))) {
+			printf("arguments: <graph file> <method> <numgroups> or <graph file> <method> <group map file>\n");
+			printf("        or <graph file> <method> lp [<max groups> [<rounds>]]\n");
+    		return -1;
 		}
-	}
-    printf("total number of path nodeids held=%d\n",totalpathinfo);	
-    
-    for(i=0;i<numnodes;i++) {
-		free(buffer[i]);
-		for(j=0;j<bufsize[i];j++)
-			free(bufferpath[i][j].path);
-		free(bufferpath[i]);
-	}
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	free(bufferpath);
-	
-    return 0;
-}
-
-
-// provenance FIFO model
-// first-in first out when propagating quantities
-// each node's buffer is managed as a FIFO queue 
-int ProvFIFO(struct Interaction *inter, int numinter, int numnodes)
-{
-    int i,j,k;
-
-    struct BufItem **buffer; // array of buffers, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-
-	int *buffirst; // position to 1st item in buffer[i], initially 0
-	int *buflast; // position to last item in buffer[i], initially 0
-    
-	double relayqty;
-	double residueqty;
-	int src;
-	int dest;
-	struct BufItem newentry;
-	
-	int numtransfers = 0;
-	
-	clock_t t,tnow;
-	
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-    buffer = (struct BufItem **)malloc(numnodes*sizeof(struct BufItem *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    buffirst = (int *)calloc(numnodes,sizeof(int));
-    buflast = (int *)calloc(numnodes,sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        bufcapacity[i]=3; //initial capacity per buffer
-        buffer[i] = (struct BufItem *)malloc(bufcapacity[i]*sizeof(struct BufItem));
-    }
-    
-    t = clock();
-	    
-	for(i=0;i<numinter;i++)
-	{
-		residueqty=inter[i].qty; // remaining quantity to be transferred
-		src = inter[i].src;
-		dest = inter[i].dest;
-		while (residueqty>0 && bufsize[src])
-		{
-			numtransfers++;
-			if (buffer[src][buflast[src]].qty>residueqty) { // buffer[src][buffirst[src]] is least recently added quantity (fifo queue first)
-				//printf("---------------\n");
-				//print_queue(buffer[src],bufsize[src],buffirst[src],buflast[src],bufcapacity[src]);
-				newentry.origin = buffer[src][buflast[src]].origin;
-				newentry.ts = buffer[src][buflast[src]].ts; //not used
-				newentry.qty = residueqty;
-				//printf("new: %d, %f, %f\n",newentry.origin,newentry.ts,newentry.qty);
-				fifoenqueue(newentry,&buffer[dest],&bufsize[dest],&buffirst[dest],&buflast[dest],&bufcapacity[dest]);
-				buffer[src][buflast[src]].qty-=residueqty;
-				residueqty = 0;
-			}
-			else { //entire entry must be relayed from src to dest
-				fifodequeue(&newentry,buffer[src],&bufsize[src],&buflast[src],bufcapacity[src]);
-				fifoenqueue(newentry,&buffer[dest],&bufsize[dest],&buffirst[dest],&buflast[dest],&bufcapacity[dest]);
-				residueqty-=newentry.qty;
-			}
+		if (!strcmp(args[0],"lp") && inter==NULL) {
+			printf("ERROR: label propagation needs all interactions, so it cannot be used with --stream\n");
+			return -1;
 		}
-		if (residueqty>0.0000001) // src did not have enough buffered quantity to relay; give birth to new flow item
-		{	
-			numtransfers++;
-			newentry.origin = src;
-			newentry.ts = inter[i].ts;
-			newentry.qty = residueqty;
-			fifoenqueue(newentry,&buffer[dest],&bufsize[dest],&buffirst[dest],&buflast[dest],&bufcapacity[dest]);
+		if (!strcmp(args[0],"lp")) {
+			// groups found by label propagation over the interaction graph
+			p->map = (int *)malloc(numnodes*sizeof(int));
+			p->numgroups = gmLabelPropagation(inter, numinter, numnodes, p->map, numargs>1 ? atoi(args[1]) : 0, numargs>2 ? atoi(args[2]) : GM_MAXITER);
 		}
-
-	}
-
-	int sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	int sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-    double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		sumqty+=sum_fifoelems(buffer[i], bufsize[i], buflast[i], bufcapacity[i]);
-    printf("sumqty=%.2f\n",sumqty);
-    printf("numtransfers=%d\n",numtransfers);
-
-    for(i=0;i<numnodes;i++){
-		printf("Buffer of vertex %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(o=%d,qty=%.2f) ",buffer[i][j].origin,buffer[i][j].qty);
-		printf("\n");
-	}
-    
-    for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	free(buffirst);
-	free(buflast);
-	
-    return 0;
-}
-
-
-// add new item to buffer
-// if item with same origin exists, update quantity
-// fix order of buffer items (based on origin) using an insertion-sort order
-int addnewitem(struct BufItemProp *buffer, int *bufsize, struct BufItemProp newentry)
-{
-	int low=0, hi = (*bufsize)-1;
-	int key = newentry.origin;
-	int pos;
-	
-	// binary search for newentry
-	while (low <= hi){
-      int middle = (low + hi)/2;
-      if (buffer[middle].origin == key) {
-      	buffer[middle].qty+=newentry.qty;
-      	return 0;
-      }
-      if (buffer[middle].origin < key)
-         low = middle + 1;
-      else
-         hi = middle - 1;
-   	}
-   	
-	// not found -> must be inserted
-	(*bufsize)++;
-	pos = (*bufsize)-2;
-	while (pos>=0 && buffer[pos].origin>key) {
-		buffer[pos+1]=buffer[pos];
-		pos--;
-	}
-	buffer[pos+1] = newentry;
-	
-	return 1;
-}
-
-// provenance proportional origin model
-// if transferred quantity is lower than buffered quantity 
-// then origins are picked proportionally
-// creation timestamps are ignored
-// Prov Sparse in paper
-int ProvProportional(struct Interaction *inter, int numinter, int numnodes)
-{
-    int i,j,k;
-
-    struct BufItemProp **buffer; // array of buffers, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-	double *sumbuffered; // total quantity buffered at node i  
-	double qty;
-
-	// for merging    
-	int a,b,newcap,numelem;
-	double transqty;
-	struct BufItemProp *newbuffer;
-
-	//double relayqty;
-	//double bufferedqty;
-	int src;
-	int dest;
-	struct BufItemProp newentry;
-	
-	int sumsize,sumcap;
-	
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-    buffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    sumbuffered = (double *)malloc(numnodes*sizeof( double)); 
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        sumbuffered[i]=0;
-        bufcapacity[i]=3;
-        buffer[i] = (struct BufItemProp *)malloc(bufcapacity[i]*sizeof(struct BufItemProp));
-    }
-
-	clock_t t,tnow;
-
-	t = clock();
-	    
-	for(i=0;i<numinter;i++)
-	{
-
-		if (inter[i].qty>=sumbuffered[inter[i].src]) {
-			// case 1: just transfer everything to dest
-			if (bufsize[inter[i].dest]==0) {
-				// first, check if enough capacity at destination node
-				if (bufcapacity[inter[i].dest] < bufsize[inter[i].src]+1) {
-					bufcapacity[inter[i].dest] = bufsize[inter[i].src]+1;
-					buffer[inter[i].dest] = (struct BufItemProp *)realloc(buffer[inter[i].dest], bufcapacity[inter[i].dest]*sizeof(struct BufItemProp));
-				}
-				//now copy all to dest
-				for(j=0;j<bufsize[inter[i].src];j++)
-					buffer[inter[i].dest][j] = buffer[inter[i].src][j];
-				bufsize[inter[i].dest] = bufsize[inter[i].src];
-			}
-			else
-			{
-				// merge buffer[inter[i].src] into buffer[inter[i].dest]
-				
-				// 1. calc. size of newbuffer
-				a = b = 0;
-				numelem = 0;
-				while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-					if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-						a++;
-					}
-					else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-						b++;
-					}
-					else {
-						a++; b++;
-					}
-					numelem++;						
-				}
-				if (a<bufsize[inter[i].src]) {
-					numelem+=bufsize[inter[i].src]-a;
-				}
-				else {
-					numelem+=bufsize[inter[i].dest]-b;
-				}
-				
-				// 2. do the merge-join
-				newcap = numelem+1;
-				//newcap = bufsize[inter[i].dest]+bufsize[inter[i].src]+1; 
-				newbuffer = (struct BufItemProp *)malloc(newcap*sizeof(struct BufItemProp));
-				numelem = 0;
-				a = b = 0;
-				while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-					if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = buffer[inter[i].src][a];
-						a++;
-					}
-					else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = buffer[inter[i].dest][b];
-						b++;
-					}
-					else {
-						newbuffer[numelem].origin = buffer[inter[i].dest][b].origin;
-						newbuffer[numelem++].qty = buffer[inter[i].src][a].qty+buffer[inter[i].dest][b].qty;
-						a++; b++;
-					}						
-				}
-				while (a<bufsize[inter[i].src]) {
-					newbuffer[numelem++] = buffer[inter[i].src][a];
-					a++;
-				}
-				while (b<bufsize[inter[i].dest]) {
-					newbuffer[numelem++] = buffer[inter[i].dest][b];
-					b++;
-				}
-				free(buffer[inter[i].dest]);
-				buffer[inter[i].dest] = newbuffer;
-				bufcapacity[inter[i].dest] = newcap;
-				bufsize[inter[i].dest] = numelem;
-			}	
-				
-			bufsize[inter[i].src]=0;
-			qty = inter[i].qty-sumbuffered[inter[i].src];
-			if (qty>0.00000001) {
-					// src did not have enough buffered quantity to relay; give birth to new flow item
-					newentry.origin = inter[i].src;
-					newentry.qty = qty;
-					//printf("newentry.qty=%.2f\n",newentry.qty);
-					if (bufsize[inter[i].dest]==0)
-						buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
-					else
-						addnewitem(buffer[inter[i].dest], &bufsize[inter[i].dest], newentry);
-					//buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
-			}
-			sumbuffered[inter[i].src] = 0;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+		else if (!readCount(args[0], &p->numgroups)) {
+			if (gmLoad(args[0], numnodes, &p->map, &p->numgroups)==-1)
+				return -1;
 		}
 		else {
-			// proportional case			
-
-			// 1. calc. size of newbuffer
-			a = b = 0;
-			numelem = 0;
-			while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-				if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-					a++;
-				}
-				else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-					b++;
-				}
-				else {
-					a++; b++;
-				}
-				numelem++;						
-			}
-			if (a<bufsize[inter[i].src]) {
-				numelem+=bufsize[inter[i].src]-a;
+			if (p->numgroups<1) {
+				printf("number of groups should be at least 1\n");
+				return -1;
 			}
-			else {
-				numelem+=bufsize[inter[i].dest]-b;
-			}
-			
-			// 2. do the merge-join
-			newcap = numelem+1;			
-			newbuffer = (struct BufItemProp *)malloc(newcap*sizeof(struct BufItemProp));
-			numelem = 0;
-			a = b = 0;
-			while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-				if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-					newbuffer[numelem].origin = buffer[inter[i].src][a].origin;
-					transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty;
-					buffer[inter[i].src][a].qty -= transqty;
-					a++;
-				}
-				else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-					newbuffer[numelem++] = buffer[inter[i].dest][b];
-					b++;
-				}
-				else {
-					newbuffer[numelem].origin = buffer[inter[i].dest][b].origin;
-					transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty+buffer[inter[i].dest][b].qty;
-					buffer[inter[i].src][a].qty -= transqty;
-					a++; b++;
-				}						
-			}
-			while (a<bufsize[inter[i].src]) {
-				newbuffer[numelem].origin = buffer[inter[i].src][a].origin;
-				transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-				newbuffer[numelem++].qty = transqty;
-				buffer[inter[i].src][a].qty -= transqty;
-				a++;
-			}
-			while (b<bufsize[inter[i].dest]) {
-				newbuffer[numelem++] = buffer[inter[i].dest][b];
-				b++;
-			}
-			
-				
-			free(buffer[inter[i].dest]);
-			buffer[inter[i].dest] = newbuffer;
-			bufcapacity[inter[i].dest] = newcap;
-			bufsize[inter[i].dest] = numelem;
-			
-
-			sumbuffered[inter[i].src] -= inter[i].qty;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+			//initialize groups
+			p->map = (int *)malloc(numnodes*sizeof(int));	
+			//assignment by a simple hash function 
+			for(i=0;i<numnodes;i++)
+				p->map[i] = i % p->numgroups;
 		}
-				
-	}
-
-       
-	sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-	double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-    printf("sumqty=%.2f\n",sumqty);
-    
-    
-	for(i=0;i<numnodes;i++) {
-		printf("Node %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(origin: %d, qty: %.2f) ",buffer[i][j].origin,buffer[i][j].qty);
-		printf("\n");
-	}
-	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	free(sumbuffered);
+		*title = "ProvProportional Grouping";
+		*name = "ProvProportionalGroup";
+		break;
 		
-    return 0;
-}
-
-// Sameas ProvProportional but
-// keeps a window of provenance info up to 2*W interactions back
-// next window is initiated every W interactions
-int ProvProportionalWindow(struct Interaction *inter, int numinter, int numnodes, int W)
-{
-    int i,j,k;
-
-    struct BufItemProp **buffer; // array of buffers, one for each node of the Graph
-    int *bufcapacity; // capacity of each buffer, initially 3
-    int *bufsize; // number of items in each buffer, initially 0
-	double *sumbuffered; // total quantity buffered at node i  
-	double qty;
-
-	// this is for odd windows
-    struct BufItemProp **oddbuffer; // array of buffers, one for each node of the Graph
-    int *oddbufcapacity; // capacity of each buffer, initially 3
-    int *oddbufsize; // number of items in each buffer, initially 0
-
-	// for merging    
-	int a,b,newcap,numelem;
-	double transqty;
-	struct BufItemProp *newbuffer;
-
-	//double relayqty;
-	//double bufferedqty;
-	int src;
-	int dest;
-	struct BufItemProp newentry;
-	
-	int sumsize,sumcap;
-	
-	int stop = 100<numnodes ? 100:numnodes;
-
-    sumbuffered = (double *)malloc(numnodes*sizeof(double)); 
-		    
-    buffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
-    bufcapacity = (int *)malloc(numnodes*sizeof(int));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        sumbuffered[i]=0;
-        bufcapacity[i]=3;
-        buffer[i] = (struct BufItemProp *)malloc(bufcapacity[i]*sizeof(struct BufItemProp));
-    }
-
-    oddbuffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
-    oddbufcapacity = (int *)malloc(numnodes*sizeof(int));
-    oddbufsize = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-        oddbufsize[i]=0;
-        oddbufcapacity[i]=3;
-        oddbuffer[i] = (struct BufItemProp *)malloc(oddbufcapacity[i]*sizeof(struct BufItemProp));
-    }
-
-	clock_t t,tnow;
-
-	t = clock();
-	    
-	for(i=0;i<numinter;i++)
-	{		
-		if(!(i%W)) {
-			if (!(i%(W*2))) {
-				//reset buffers
-				for(j=0;j<numnodes;j++) {
-					if (sumbuffered[j]>0) {
-						buffer[j][0].origin = -1;
-						buffer[j][0].qty = sumbuffered[j];
-						bufsize[j]=1;						
-					}
-				}
-			}
-			else
-			{
-				//reset oddbuffers
-				for(j=0;j<numnodes;j++) {
-					if (sumbuffered[j]>0) {
-						oddbuffer[j][0].origin = -1;
-						oddbuffer[j][0].qty = sumbuffered[j];
-						oddbufsize[j]=1;		
-					}
-				}
-			}
+		case 112:
+		if (numargs < 1) {
+			printf("arguments: <graph file> <method> <level> [<level> ...], from the finest to the coarsest level\n");
+			printf("           each level is vertex (every vertex is a group) or a group map file\n");
+    		return -1;
 		}
-
-		//printf("buffqty:%.2f\n",bufferedqty);
-		if (inter[i].qty>=sumbuffered[inter[i].src]) {
-			// case 1: just transfer everything to dest
-			if (bufsize[inter[i].dest]==0) {
-				// first, check if enough capacity at destination node
-				if (bufcapacity[inter[i].dest] < bufsize[inter[i].src]+1) {
-					bufcapacity[inter[i].dest] = bufsize[inter[i].src]+1;
-					buffer[inter[i].dest] = (struct BufItemProp *)realloc(buffer[inter[i].dest], bufcapacity[inter[i].dest]*sizeof(struct BufItemProp));
-				}
-				//now copy all to dest
-				for(j=0;j<bufsize[inter[i].src];j++)
-					buffer[inter[i].dest][j] = buffer[inter[i].src][j];
-				bufsize[inter[i].dest] = bufsize[inter[i].src];
-			}
-			else
-			{
-				// merge buffer[inter[i].src] into buffer[inter[i].dest]
-				
-				// 1. calc. size of newbuffer
-				a = b = 0;
-				numelem = 0;
-				while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-					if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-						a++;
-					}
-					else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-						b++;
-					}
-					else {
-						a++; b++;
-					}
-					numelem++;						
-				}
-				if (a<bufsize[inter[i].src]) {
-					numelem+=bufsize[inter[i].src]-a;
-				}
-				else {
-					numelem+=bufsize[inter[i].dest]-b;
-				}
-				
-				// 2. do the merge-join
-				newcap = numelem+1;
-				//newcap = bufsize[inter[i].dest]+bufsize[inter[i].src]+1; 
-				newbuffer = (struct BufItemProp *)malloc(newcap*sizeof(struct BufItemProp));
-				numelem = 0;
-				a = b = 0;
-				while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-					if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = buffer[inter[i].src][a];
-						a++;
-					}
-					else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = buffer[inter[i].dest][b];
-						b++;
-					}
-					else {
-						newbuffer[numelem].origin = buffer[inter[i].dest][b].origin;
-						newbuffer[numelem++].qty = buffer[inter[i].src][a].qty+buffer[inter[i].dest][b].qty;
-						a++; b++;
-					}						
-				}
-				while (a<bufsize[inter[i].src]) {
-					newbuffer[numelem++] = buffer[inter[i].src][a];
-					a++;
-				}
-				while (b<bufsize[inter[i].dest]) {
-					newbuffer[numelem++] = buffer[inter[i].dest][b];
-					b++;
-				}
-				free(buffer[inter[i].dest]);
-				buffer[inter[i].dest] = newbuffer;
-				bufcapacity[inter[i].dest] = newcap;
-				bufsize[inter[i].dest] = numelem;
-			}	
-			
-			// repeat for oddbuffers
-			
-			if (oddbufsize[inter[i].dest]==0) {
-				// first, check if enough capacity at destination node
-				if (oddbufcapacity[inter[i].dest] < oddbufsize[inter[i].src]+1) {
-					oddbufcapacity[inter[i].dest] = oddbufsize[inter[i].src]+1;
-					oddbuffer[inter[i].dest] = (struct BufItemProp *)realloc(oddbuffer[inter[i].dest], oddbufcapacity[inter[i].dest]*sizeof(struct BufItemProp));
-				}
-				//now copy all to dest
-				for(j=0;j<oddbufsize[inter[i].src];j++)
-					oddbuffer[inter[i].dest][j] = oddbuffer[inter[i].src][j];
-				oddbufsize[inter[i].dest] = oddbufsize[inter[i].src];
-			}
-			else
-			{
-				// merge buffer[inter[i].src] into buffer[inter[i].dest]
-				
-				// 1. calc. size of newbuffer
-				a = b = 0;
-				numelem = 0;
-				while (a<oddbufsize[inter[i].src] && b<oddbufsize[inter[i].dest]) {
-					if (oddbuffer[inter[i].src][a].origin<oddbuffer[inter[i].dest][b].origin) {
-						a++;
-					}
-					else if (oddbuffer[inter[i].src][a].origin>oddbuffer[inter[i].dest][b].origin) {
-						b++;
-					}
-					else {
-						a++; b++;
-					}
-					numelem++;						
-				}
-				if (a<oddbufsize[inter[i].src]) {
-					numelem+=oddbufsize[inter[i].src]-a;
-				}
-				else {
-					numelem+=oddbufsize[inter[i].dest]-b;
-				}
-				
-				// 2. do the merge-join
-				newcap = numelem+1;
-				//newcap = bufsize[inter[i].dest]+bufsize[inter[i].src]+1; 
-				newbuffer = (struct BufItemProp *)malloc(newcap*sizeof(struct BufItemProp));
-				numelem = 0;
-				a = b = 0;
-				while (a<oddbufsize[inter[i].src] && b<oddbufsize[inter[i].dest]) {
-					if (oddbuffer[inter[i].src][a].origin<oddbuffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = oddbuffer[inter[i].src][a];
-						a++;
-					}
-					else if (oddbuffer[inter[i].src][a].origin>oddbuffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = oddbuffer[inter[i].dest][b];
-						b++;
-					}
-					else {
-						newbuffer[numelem].origin = oddbuffer[inter[i].dest][b].origin;
-						newbuffer[numelem++].qty = oddbuffer[inter[i].src][a].qty+oddbuffer[inter[i].dest][b].qty;
-						a++; b++;
-					}						
-				}
-				while (a<oddbufsize[inter[i].src]) {
-					newbuffer[numelem++] = oddbuffer[inter[i].src][a];
-					a++;
-				}
-				while (b<oddbufsize[inter[i].dest]) {
-					newbuffer[numelem++] = oddbuffer[inter[i].dest][b];
-					b++;
-				}
-				free(oddbuffer[inter[i].dest]);
-				oddbuffer[inter[i].dest] = newbuffer;
-				oddbufcapacity[inter[i].dest] = newcap;
-				oddbufsize[inter[i].dest] = numelem;
-			}
-				
-			bufsize[inter[i].src]=0;
-			oddbufsize[inter[i].src]=0;
-			qty = inter[i].qty-sumbuffered[inter[i].src];
-			if (qty>0.00000001) {
-					// src did not have enough buffered quantity to relay; give birth to new flow item
-					newentry.origin = inter[i].src;
-					newentry.qty = qty;
-					if (bufsize[inter[i].dest]==0)
-						buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
-					else
-						addnewitem(buffer[inter[i].dest], &bufsize[inter[i].dest], newentry);
+		p->numlevels = numargs;
+		p->levelgroups = (int *)calloc(numargs,sizeof(int));
+		p->levelmap = (int **)calloc(numargs,sizeof(int *));
+		if (readLevel(args[0], numnodes, &p->map, &p->numgroups)==-1)
+			return -1;
+		for(i=1;i<numargs;i++)
+			if (readLevel(args[i], numnodes, &p->levelmap[i], &p->levelgroups[i])==-1)
+				return -1;
+		*title = "ProvProportional Hierarchical Grouping";
+		*name = "ProvProportionalHier";
+		break;
 	
-					// src did not have enough buffered quantity to relay; give birth to new flow item
-					if (oddbufsize[inter[i].dest]==0)
-						oddbuffer[inter[i].dest][oddbufsize[inter[i].dest]++] = newentry;
-					else
-						addnewitem(oddbuffer[inter[i].dest], &oddbufsize[inter[i].dest], newentry);
-			}
-
-			sumbuffered[inter[i].src] = 0;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+		case 120:
+		if (numargs != 1) {
+			printf("arguments: <graph file> <method> <W>\n");
+    		return -1;
 		}
-		else {
-			// proportional case			
-
-			// 1. calc. size of newbuffer
-			a = b = 0;
-			numelem = 0;
-			while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-				if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-					a++;
-				}
-				else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-					b++;
-				}
-				else {
-					a++; b++;
-				}
-				numelem++;						
-			}
-			if (a<bufsize[inter[i].src]) {
-				numelem+=bufsize[inter[i].src]-a;
-			}
-			else {
-				numelem+=bufsize[inter[i].dest]-b;
-			}
-			
-			// 2. do the merge-join
-			newcap = numelem+1;			
-			//newcap = bufsize[inter[i].dest]+bufsize[inter[i].src]; 
-			newbuffer = (struct BufItemProp *)malloc(newcap*sizeof(struct BufItemProp));
-			numelem = 0;
-			a = b = 0;
-			while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-				if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-					newbuffer[numelem].origin = buffer[inter[i].src][a].origin;
-					transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty;
-					buffer[inter[i].src][a].qty -= transqty;
-					a++;
-				}
-				else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-					newbuffer[numelem++] = buffer[inter[i].dest][b];
-					b++;
-				}
-				else {
-					newbuffer[numelem].origin = buffer[inter[i].dest][b].origin;
-					transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty+buffer[inter[i].dest][b].qty;
-					buffer[inter[i].src][a].qty -= transqty;
-					a++; b++;
-				}						
-			}
-			while (a<bufsize[inter[i].src]) {
-				newbuffer[numelem].origin = buffer[inter[i].src][a].origin;
-				transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-				newbuffer[numelem++].qty = transqty;
-				buffer[inter[i].src][a].qty -= transqty;
-				a++;
-			}
-			while (b<bufsize[inter[i].dest]) {
-				newbuffer[numelem++] = buffer[inter[i].dest][b];
-				b++;
-			}
-			
-				
-			free(buffer[inter[i].dest]);
-			buffer[inter[i].dest] = newbuffer;
-			bufcapacity[inter[i].dest] = newcap;
-			bufsize[inter[i].dest] = numelem;
-			
-
-			// proportional case	
-			// repeat for odd buffers		
-
-			// 1. calc. size of newbuffer
-			a = b = 0;
-			numelem = 0;
-			while (a<oddbufsize[inter[i].src] && b<oddbufsize[inter[i].dest]) {
-				if (oddbuffer[inter[i].src][a].origin<oddbuffer[inter[i].dest][b].origin) {
-					a++;
-				}
-				else if (oddbuffer[inter[i].src][a].origin>oddbuffer[inter[i].dest][b].origin) {
-					b++;
-				}
-				else {
-					a++; b++;
-				}
-				numelem++;						
-			}
-			if (a<oddbufsize[inter[i].src]) {
-				numelem+=oddbufsize[inter[i].src]-a;
-			}
-			else {
-				numelem+=oddbufsize[inter[i].dest]-b;
-			}
-
-			
-			// 2. do the merge-join
-			newcap = numelem+1;			
-			newbuffer = (struct BufItemProp *)malloc(newcap*sizeof(struct BufItemProp));
-			numelem = 0;
-			a = b = 0;
-			while (a<oddbufsize[inter[i].src] && b<oddbufsize[inter[i].dest]) {
-				if (oddbuffer[inter[i].src][a].origin<oddbuffer[inter[i].dest][b].origin) {
-					newbuffer[numelem].origin = oddbuffer[inter[i].src][a].origin;
-					transqty = inter[i].qty*oddbuffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty;
-					oddbuffer[inter[i].src][a].qty -= transqty;
-					a++;
-				}
-				else if (oddbuffer[inter[i].src][a].origin>oddbuffer[inter[i].dest][b].origin) {
-					newbuffer[numelem++] = oddbuffer[inter[i].dest][b];
-					b++;
-				}
-				else {
-					newbuffer[numelem].origin = oddbuffer[inter[i].dest][b].origin;
-					transqty = inter[i].qty*oddbuffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty+oddbuffer[inter[i].dest][b].qty;
-					oddbuffer[inter[i].src][a].qty -= transqty;
-					a++; b++;
-				}						
-			}
-			while (a<oddbufsize[inter[i].src]) {
-				newbuffer[numelem].origin = oddbuffer[inter[i].src][a].origin;
-				transqty = inter[i].qty*oddbuffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-				newbuffer[numelem++].qty = transqty;
-				oddbuffer[inter[i].src][a].qty -= transqty;
-				a++;
-			}
-			while (b<oddbufsize[inter[i].dest]) {
-				newbuffer[numelem++] = oddbuffer[inter[i].dest][b];
-				b++;
-			}
-			
-			free(oddbuffer[inter[i].dest]);
-			oddbuffer[inter[i].dest] = newbuffer;
-			oddbufcapacity[inter[i].dest] = newcap;
-			oddbufsize[inter[i].dest] = numelem;
-
-
-			sumbuffered[inter[i].src] -= inter[i].qty;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+		if (!readCount(args[0], &p->W) || p->W<1) {
+			printf("ERROR: window size should be at least 1\n");
+			return -1;
 		}
+		*title = "ProvProportional Window";
+		*name = "ProvProportionalWindow";
+		break;
 
+		case 121:
+		if (numargs != 2) {
+			printf("arguments: <graph file> <method> <budget> <reduction>\n");
+    		return -1;
+		}
+		p->budget = atoi(args[0]); 
+		p->reducedsize = atoi(args[1]); 
+		if (p->reducedsize >= p->budget) {
+			printf("reduction should be smaller than budget\n");
+			return -1;
+		}
+		*title = "ProvProportional Budget";
+		*name = "ProvProportionalBudget";
+		break;
 		
-	}
-       
-	sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-	sumcap =0;
-	for(i=0;i<numnodes;i++)
-       sumcap+=bufcapacity[i];
-    printf("sumcapacity=%d\n",sumcap);
-    
-	double sumqty =0;
-	for(i=0;i<numnodes;i++)
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-    printf("sumqty=%.2f\n",sumqty);
-    
-	for(i=0;i<numnodes;i++) {
-		printf("Node %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(origin: %d, qty: %.2f) ",buffer[i][j].origin,buffer[i][j].qty);
-		printf("\n");
-	}
-	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(bufcapacity);
-	free(buffer);
-	free(sumbuffered);
+		case 122:
+		if (numargs != 1) {
+			printf("arguments: <graph file> <method> <sketch size>\n");
+    		return -1;
+		}
+		p->budget = atoi(args[0]); 
+		*title = "ProvProportional Sketch";
+		*name = "ProvProportionalSketch";
+		break;
 		
+		case 125:
+		if (numargs != 1) {
+			printf("arguments: <graph file> <method> <k>\n");
+    		return -1;
+		}
+		p->budget = atoi(args[0]); 
+		*title = "ProvProportional Top-k";
+		*name = "ProvProportionalTopK";
+		break;
+		
+		case 123:
+		if (numargs != 1 && numargs != 2) {
+			printf("arguments: <graph file> <method> <time window> [<epochs per window>]\n");
+    		return -1;
+		}
+		p->T = atof(args[0]); 
+		p->numepochs = numargs==2 ? atoi(args[1]) : 8;
+		*title = "ProvProportional Sliding Window";
+		*name = "ProvProportionalSlidingWindow";
+		break;
+		
+		case 124:
+		if (numargs != 1) {
+			printf("arguments: <graph file> <method> <decay time constant>\n");
+    		return -1;
+		}
+		p->T = atof(args[0]); 
+		*title = "ProvProportional Decay";
+		*name = "ProvProportionalDecay";
+		break;
+		
+		default:
+		printf("Invalid method. Choices are:\n");
+		printf("0: no provenance\n");
+		printf("1: least recently born\n");
+		printf("2: most recently born\n");
+		printf("3: LIFO\n");
+		printf("4: FIFO\n");
+		printf("31: LIFO with path tracking\n");
+		printf("100: proportional (dense vectors)\n");
+		printf("101: proportional (sparse vectors)\n");
+		printf("102: proportional (hybrid vectors)\n");
+		printf("110: proportional (from selected vertices)\n");
+		printf("111: proportional (from groups of vertices)\n");
+		printf("112: proportional (hierarchy of groups of vertices)\n");
+		printf("120: proportional (window-based)\n");
+		printf("121: proportional (budget-based)\n");
+		printf("122: proportional (heavy-hitter sketch)\n");
+		printf("123: proportional (sliding time window)\n");
+		printf("124: proportional (exponential time decay)\n");
+		printf("125: proportional (top-k origins per vertex)\n");
+    	return -1;
+    }
+    
     return 0;
 }
 
-int cmpbyqtydesc(const void *i1, const void *i2)
+// output options of the command line
+struct OutOptions {
+	char *file; // file the buffers are written to (default: standard output)
+	char *vertexfile; // list of the vertices to be written
+	int mode;
+	int topn;
+	int nonempty;
+};
+
+// opens writer w on file (standard output if NULL), with output options o
+int openOutput(struct OutWriter *w, struct OutOptions *o, const char *file, int numnodes)
 {
-	struct BufItemProp *a = (struct BufItemProp *)i1;
-    struct BufItemProp *b = (struct BufItemProp *)i2;
-    
-	if (a->qty < b->qty)
-		return 1;
-	else if (a->qty > b->qty)
+	FILE *f = stdout;
+	
+	if (file!=NULL) {
+		f = fopen(file,o->mode==OUT_BINARY ? "wb" : "w");
+		if (f==NULL) {
+			printf("ERROR: cannot open output file %s\n",file);
+			return -1;
+		}
+	}
+	provOutInit(w, f, o->mode);
+	w->topn = o->topn;
+	w->nonempty = o->nonempty;
+	if (o->vertexfile!=NULL && provOutLoadFilter(w, o->vertexfile, numnodes)==-1)
 		return -1;
-	else
-		return 0;  
+	return 0;
 }
 
-int cmpbyorigin (const void *i1, const void *i2) {
-	struct BufItemProp *a = (struct BufItemProp *)i1;
-    struct BufItemProp *b = (struct BufItemProp *)i2;
-    
-    return(a->origin - b->origin);
+void closeOutput(struct OutWriter *w)
+{
+	if (w->f!=stdout)
+		fclose(w->f);
+	provOutFree(w);
 }
 
-// shrink a sparse proportional buffer to keep only the top-reducedsize elements 
-// puts total deleted qty in -1 (artificial) vertex
-int shrinkbuffer(struct BufItemProp *buffer, int bufsize, int reducedsize)
+// a model run of a multi-method pass (see runMethods)
+struct MethodRun {
+	int method;
+	char *title;
+	char *name;
+	struct ProvState *state;
+	const struct Interaction *inter; // shared by all runs, read-only
+	int numinter;
+	int ret;
+	double cputime; // processing time of the thread of the run
+	double walltime;
+};
+
+void *runMethodThread(void *arg)
 {
-	int i,j;
-	double residueqty;
-	qsort(buffer, bufsize, sizeof(struct BufItemProp), cmpbyqtydesc);
-	residueqty = 0.0;
-	for (i=reducedsize; i<bufsize; i++)
-		residueqty += buffer[i].qty;
-	for (i=0; i<reducedsize; i++)
-		if (buffer[i].origin == -1)
-			break;
-	if (i<reducedsize) // broken => found
-		buffer[i].qty += residueqty;
-	else {
-		buffer[reducedsize].origin = -1;
-		buffer[reducedsize++].qty = residueqty;
-	}
-	qsort(buffer, reducedsize, sizeof(struct BufItemProp), cmpbyorigin);
-	return reducedsize;
+	struct MethodRun *r = (struct MethodRun *)arg;
+	struct timespec c0,c1,w0,w1;
+	
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&c0);
+	clock_gettime(CLOCK_MONOTONIC,&w0);
+	r->ret = provFeed(r->state, r->inter, r->numinter);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&c1);
+	clock_gettime(CLOCK_MONOTONIC,&w1);
+	r->cputime = poolElapsed(&c0,&c1);
+	r->walltime = poolElapsed(&w0,&w1);
+	return NULL;
 }
 
-// shrink a sparse proportional buffer to keep only the top-reducedsize elements 
-// puts total deleted qty in selfid vertex
-int shrinkbufferselfid(struct BufItemProp *buffer, int bufsize, int selfid, int reducedsize)
+// compares the provenance of engines a and b at each vertex, origin by origin (exactly, with integer quantities),
+// e.g. of models 101 and 102, which compute the same provenance; returns the number of vertices that differ
+int checkSame(struct ProvState *a, struct ProvState *b, int numnodes)
 {
-	int i,j;
-	double residueqty;
-	qsort(buffer, bufsize, sizeof(struct BufItemProp), cmpbyqtydesc);
-	residueqty = 0.0;
-	for (i=reducedsize; i<bufsize; i++)
-		residueqty += buffer[i].qty;
-	for (i=0; i<reducedsize; i++)
-		if (buffer[i].origin == selfid)
-			break;
-	if (i<reducedsize) // broken => found
-		buffer[i].qty += residueqty;
-	else {
-		buffer[reducedsize].origin = selfid;
-		buffer[reducedsize++].qty = residueqty;
+	int v,j,na,nb;
+	int numdiff = 0;
+	int capacity = 0;
+	struct BufItem *ia = NULL, *ib, *items;
+	qty_t diff, scale;
+	
+	for(v=0;v<numnodes;v++) {
+		// the items of a are only valid until the next query, so they are copied
+		na = provQuery(a,v,&items);
+		if (na>capacity) {
+			capacity = na;
+			ia = (struct BufItem *)realloc(ia,capacity*sizeof(struct BufItem));
+		}
+		memcpy(ia,items,na*sizeof(struct BufItem));
+		nb = provQuery(b,v,&ib);
+		if (na!=nb) {
+			numdiff++;
+			continue;
+		}
+		for(j=0;j<na;j++) {
+			diff = ia[j].qty>ib[j].qty ? ia[j].qty-ib[j].qty : ib[j].qty-ia[j].qty;
+			scale = ia[j].qty>0 ? ia[j].qty : -ia[j].qty;
+			if (ia[j].origin!=ib[j].origin || (QTY_INTEGER ? diff>0 : diff>0.000001*(1+scale)))
+				break;
+		}
+		if (j<na)
+			numdiff++;
 	}
-	qsort(buffer, reducedsize, sizeof(struct BufItemProp), cmpbyorigin);
-	return reducedsize;
+	free(ia);
+	if (numdiff)
+		printf("same provenance check: %d vertices differ\n",numdiff);
+	else
+		printf("same provenance check: all vertices agree\n");
+	return numdiff;
 }
 
-// same as ProvProportional, but takes as input a budget B for the buffer vector of each node
-// if the budget is reached then (budget-reduced) of the buffer entries with the smallest quantities are
-// assumed to originate from the vertex itself, in order to make room 
-int ProvProportionalBudget(struct Interaction *inter, int numinter, int numnodes, int budget, int reducedsize)
+// runs the models of list (comma-separated, method arguments separated by ':', e.g. 4,101,121:8:4)
+// over the same interactions, each model on its own thread
+// the buffers of the k-th model are written to <o->file>.<k> (standard output if no file is given)
+// if check is set, the conservation of the quantities of each model is checked (see provCheck),
+// and the provenance of models 101 and 102, if the list has both, is compared (see checkSame)
+// dustabs and dustrel are the dust thresholds of the models that prune dust (101, 112, 120; see struct ProvParams),
+// of which the list must have one if they are set
+int runMethods(char *list, struct Interaction *inter, int numinter, int numnodes, struct OutOptions *o, int check, double dustabs, double dustrel)
 {
-    int i,j,k;
-
-    struct BufItemProp **buffer; // array of buffers, one for each node of the Graph
-    int *bufsize; // number of items in each buffer, initially 0
-	double *sumbuffered; // total quantity buffered at node i  
-	double qty;
-
-	int *lastbufshrink; // marks last time each provenance info is shrunk at each node   
-	int *numbufshrinks; // marks number of times provenance info is shrunk at each node   
-
-	// for merging    
-	int a,b,newcap,numelem;
-	double transqty;
-	struct BufItemProp *newbuffer;
-
-	//double relayqty;
-	//double bufferedqty;
-	int src;
-	int dest;
-	struct BufItemProp newentry;
+	int i,k;
+	int prunes = 0; // set if a model of the list prunes dust
+	int nummethods = 1;
+	int numargs;
+	char *args[8];
+	char *spec,*tok,*save1,*save2;
+	char file[4096];
+	struct ProvParams params;
+	struct MethodRun *runs;
+	pthread_t *threads;
+	struct OutWriter out;
+	struct timespec w0,w1;
 	
-	int sumsize,sumcap;
+	for(i=0;list[i];i++)
+		if (list[i]==',')
+			nummethods++;
+	runs = (struct MethodRun *)calloc(nummethods,sizeof(struct MethodRun));
+	threads = (pthread_t *)malloc(nummethods*sizeof(pthread_t));
 	
-	int stop = 100<numnodes ? 100:numnodes;
-		    
-    buffer = (struct BufItemProp **)malloc(numnodes*sizeof(struct BufItemProp *));
-    bufsize = (int *)malloc(numnodes*sizeof(int));
-    lastbufshrink = (int *)calloc(numnodes,sizeof(int)); // reset to 0 for all nodes
-    numbufshrinks = (int *)calloc(numnodes,sizeof(int)); // reset to 0 for all nodes
-    sumbuffered = (double *)malloc(numnodes*sizeof(double)); 
-    for(i=0;i<numnodes;i++) {
-        bufsize[i]=0;
-        sumbuffered[i]=0;
-        buffer[i] = (struct BufItemProp *)malloc(budget*sizeof(struct BufItemProp));
-    }
-
-	newbuffer = (struct BufItemProp *)malloc((2*budget+1)*sizeof(struct BufItemProp));
-
-	clock_t t,tnow;
-
-	t = clock();
-	    
-	for(i=0;i<numinter;i++)
-	{
-		if (inter[i].qty>=sumbuffered[inter[i].src]) {
-			// case 1: just transfer everything to dest
-			if (bufsize[inter[i].dest]==0) {
-				if (bufsize[inter[i].src]+1 > budget) {
-					// copy to new buffer
-					for(j=0;j<bufsize[inter[i].src];j++)
-						newbuffer[j] = buffer[inter[i].src][j];
-					
-					// shrink newbuffer by keeping top-reducedsize quantities and put total residue to inter[i].dest 
-					numelem = shrinkbuffer(newbuffer,bufsize[inter[i].src],reducedsize);
-					lastbufshrink[inter[i].dest]=i; // mark time of buffer shrinking (i.e., info loss)
-					numbufshrinks[inter[i].dest]++; 
-					
-					for(j=0;j<numelem;j++)
-						buffer[inter[i].dest][j] = newbuffer[j];
-					bufsize[inter[i].dest] = numelem;
-				}
-				else {
-					//just copy all to dest
-					for(j=0;j<bufsize[inter[i].src];j++)
-						buffer[inter[i].dest][j] = buffer[inter[i].src][j];
-					bufsize[inter[i].dest] = bufsize[inter[i].src];
-				}
-			}
-			else
-			{
-				// merge buffer[inter[i].src] into buffer[inter[i].dest]
-				numelem = 0;
-				a = b = 0;
-				while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-					if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = buffer[inter[i].src][a];
-						a++;
-					}
-					else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-						newbuffer[numelem++] = buffer[inter[i].dest][b];
-						b++;
-					}
-					else {
-						newbuffer[numelem].origin = buffer[inter[i].dest][b].origin;
-						newbuffer[numelem++].qty = buffer[inter[i].src][a].qty+buffer[inter[i].dest][b].qty;
-						a++; b++;
-					}						
-				}
-				while (a<bufsize[inter[i].src]) {
-					newbuffer[numelem++] = buffer[inter[i].src][a];
-					a++;
-				}
-				while (b<bufsize[inter[i].dest]) {
-					newbuffer[numelem++] = buffer[inter[i].dest][b];
-					b++;
-				}
-				
-				if (numelem>budget-1)
-				{
-					numelem = shrinkbuffer(newbuffer,numelem,reducedsize);
-					lastbufshrink[inter[i].dest]=i; // mark time of buffer shrinking (i.e., info loss)
-					numbufshrinks[inter[i].dest]++; 	
-				}
-				
-				for(j=0;j<numelem;j++)
-					buffer[inter[i].dest][j] = newbuffer[j];
-				bufsize[inter[i].dest] = numelem;
-			}	
-				
-			bufsize[inter[i].src]=0;
-			qty = inter[i].qty-sumbuffered[inter[i].src];
-			if (qty>0.00000001) {
-					// src did not have enough buffered quantity to relay; give birth to new flow item
-					newentry.origin = inter[i].src;
-					newentry.qty = qty;
-					if (bufsize[inter[i].dest]==0)
-						buffer[inter[i].dest][bufsize[inter[i].dest]++] = newentry;
-					else
-						addnewitem(buffer[inter[i].dest], &bufsize[inter[i].dest], newentry);
-			}
-			sumbuffered[inter[i].src] = 0;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+	nummethods = 0;
+	for(spec=strtok_r(list,",",&save1); spec!=NULL; spec=strtok_r(NULL,",",&save1)) {
+		tok = strtok_r(spec,":",&save2);
+		runs[nummethods].method = atoi(tok);
+		numargs = 0;
+		while ((tok = strtok_r(NULL,":",&save2))!=NULL && numargs<8)
+			args[numargs++] = tok;
+		if (setupMethod(runs[nummethods].method, numargs, args, inter, numinter, numnodes, &params, &runs[nummethods].title, &runs[nummethods].name)==-1)
+			return -1;
+		if (runs[nummethods].method==101 || runs[nummethods].method==112 || runs[nummethods].method==120) {
+			params.dustabs = dustabs;
+			params.dustrel = dustrel;
+			prunes = 1;
 		}
-		else {
-			// proportional case			
-			// merge into dest buffer
-			numelem = 0;
-			a = b = 0;
-			while (a<bufsize[inter[i].src] && b<bufsize[inter[i].dest]) {
-				if (buffer[inter[i].src][a].origin<buffer[inter[i].dest][b].origin) {
-					newbuffer[numelem].origin = buffer[inter[i].src][a].origin;
-					transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty;
-					buffer[inter[i].src][a].qty -= transqty;
-					a++;
-				}
-				else if (buffer[inter[i].src][a].origin>buffer[inter[i].dest][b].origin) {
-					newbuffer[numelem++] = buffer[inter[i].dest][b];
-					b++;
-				}
-				else {
-					newbuffer[numelem].origin = buffer[inter[i].dest][b].origin;
-					transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-					newbuffer[numelem++].qty = transqty+buffer[inter[i].dest][b].qty;
-					buffer[inter[i].src][a].qty -= transqty;
-					a++; b++;
-				}						
-			}
-			//printf("a=%d,b=%d\n",a,b);
-			while (a<bufsize[inter[i].src]) {
-				newbuffer[numelem].origin = buffer[inter[i].src][a].origin;
-				transqty = inter[i].qty*buffer[inter[i].src][a].qty/sumbuffered[inter[i].src];
-				newbuffer[numelem++].qty = transqty;
-				buffer[inter[i].src][a].qty -= transqty;
-				a++;
-			}
-			while (b<bufsize[inter[i].dest]) {
-				newbuffer[numelem++] = buffer[inter[i].dest][b];
-				b++;
-			}
-			
-			if (numelem>budget)
-			{
-				// shrink newbuffer by keeping top-reducedsize quantities and put total residue to inter[i].dest 
-				numelem = shrinkbuffer(newbuffer,numelem,reducedsize);
-				lastbufshrink[inter[i].dest]=i; // mark time of buffer shrinking (i.e., info loss)
-				numbufshrinks[inter[i].dest]++; 
-			}
-			
-			for(j=0;j<numelem;j++)
-				buffer[inter[i].dest][j] = newbuffer[j];
-			bufsize[inter[i].dest] = numelem;
-			
-			sumbuffered[inter[i].src] -= inter[i].qty;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+		runs[nummethods].state = provCreate(runs[nummethods].method, numnodes, &params);
+		freeParams(&params);
+		if (runs[nummethods].state==NULL)
+			return -1;
+		runs[nummethods].inter = inter;
+		runs[nummethods].numinter = numinter;
+		nummethods++;
+	}
+	if ((dustabs>0 || dustrel>0) && !prunes) {
+		printf("ERROR: --dust and --dust-rel need one of methods 101, 112 and 120\n");
+		return -1;
+	}
+	
+	clock_gettime(CLOCK_MONOTONIC,&w0);
+	for(k=0;k<nummethods;k++)
+		if (pthread_create(&threads[k],NULL,runMethodThread,&runs[k])) {
+			printf("ERROR: cannot create thread\n");
+			return -1;
+		}
+	for(k=0;k<nummethods;k++)
+		pthread_join(threads[k],NULL);
+	clock_gettime(CLOCK_MONOTONIC,&w1);
+	
+	for(k=0;k<nummethods;k++) {
+		printf("\n%s model starts\n",runs[k].title);
+		if (runs[k].ret==-1)
+			return -1;
+		if (o->file!=NULL)
+			snprintf(file,sizeof(file),"%s.%d",o->file,k);
+		if (openOutput(&out, o, o->file!=NULL ? file : NULL, numnodes)==-1)
+			return -1;
+		provPrint(runs[k].state, &out);
+		closeOutput(&out);
+		printf("%s: Total time of execution: %f seconds (wall clock %f seconds)\n", runs[k].name, runs[k].cputime, runs[k].walltime);
+		if (check && provCheck(runs[k].state, inter, numinter)==-1)
+			return -1;
+		// 101 and 102 are kept for checkSame
+		if (!check || (runs[k].method!=101 && runs[k].method!=102)) {
+			provDestroy(runs[k].state);
+			runs[k].state = NULL;
 		}
-		
 	}
-
-
-	sumsize =0;
-	for(i=0;i<numnodes;i++)
-       sumsize+=bufsize[i];
-    printf("sumsize=%d\n",sumsize);
-
-    int nonemptybufs = 0;
-    int totshrinking = 0;
-    int numshrunk = 0;
-	double sumqty =0;
-	for(i=0;i<numnodes;i++) {
-		for(j=0;j<bufsize[i];j++)
-       		sumqty+=buffer[i][j].qty;
-       	if(bufsize[i]>0) {
-       		nonemptybufs++;
-       		totshrinking += numbufshrinks[i];
-       		if (numbufshrinks[i]) numshrunk++;
-       	}
-    }
-    printf("sumqty=%.2f\n",sumqty);
-    printf("number of non-empty buffers=%d\n",nonemptybufs);
-    printf("number of nodes whose buffer was shrunk at least once=%d\n",numshrunk);
-    printf("average number of shrinks at non-empty buffers=%.2f\n",(double)totshrinking/nonemptybufs);
-    
-	for(i=0;i<numnodes;i++) {
-		printf("Node %d: ",i);
-		for(j=0;j<bufsize[i];j++)
-			printf("(origin: %d, qty: %.2f) ",buffer[i][j].origin,buffer[i][j].qty);
-		printf("\n");
+	if (check) {
+		for(i=0;i<nummethods && runs[i].method!=101;i++);
+		for(k=0;k<nummethods && runs[k].method!=102;k++);
+		if (i<nummethods && k<nummethods) {
+			printf("\n%s and %s models\n",runs[i].title,runs[k].title);
+			checkSame(runs[i].state, runs[k].state, numnodes);
+		}
 	}
+	for(k=0;k<nummethods;k++)
+		if (runs[k].state!=NULL)
+			provDestroy(runs[k].state);
+	printf("\n%d models: Total time of execution (wall clock): %f seconds\n", nummethods, poolElapsed(&w0,&w1));
 	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(bufsize);
-	free(buffer);
-	free(sumbuffered);
-	free(newbuffer);
-	free(lastbufshrink);
-	free(numbufshrinks);
-    return 0;
+	free(runs);
+	free(threads);
+	return 0;
 }
 
+// a configuration of a parameter sweep (see runSweep)
+struct SweepRun {
+	int method;
+	struct ProvParams params;
+	int ret;
+	double cputime; // processing time
+	struct ProvStats stats; // statistics of the buffers after processing all interactions
+	double accuracy; // see sweepAccuracy
+};
 
-// provenance proportional origin model
-// Proportional Dense model
-// works for selected origins only
-// to use for all vertices, select all of them in array
-// if transferred quantity is lower than buffered quantity 
-// then origins are picked proportionally
-// creation timestamps are ignored
-int ProvProportionalSel(struct Interaction *inter, int numinter, int numnodes, int *selectednodes, int numselected)
-{
-    int i,j,k;
+// data shared by the tasks of a sweep
+struct Sweep {
+	const struct Interaction *inter; // read-only
+	int numinter;
+	int numnodes;
+	struct SweepRun *runs;
+	// exact provenance (101): the items of vertex v are exact[exactstart[v]..exactstart[v+1]-1]
+	long long *exactstart;
+	struct BufItem *exact;
+	double exactqty; // total buffered quantity
+};
 
-    double **buffer; // array of buffers, one for each node of the Graph
-	double *nonselectedqty; // quantity originating from non-selected nodes  
-	double *sumbuffered; // total quantity buffered at node i  
-	int *map; // map[i] is position of node i in selectednodes (-1 if it is not there)
+// parses a comma-separated list of integers into *vals and returns its length
+int parseList(const char *list, int **vals)
+{
+	int n = 1;
+	const char *c;
 	
-	double qty; 
-	    
-	int stop = 100<numnodes ? 100:numnodes;
+	for(c=list;*c;c++)
+		if (*c==',')
+			n++;
+	*vals = (int *)malloc(n*sizeof(int));
+	n = 0;
+	for(c=list; c!=NULL; c=strchr(c,',')) {
+		if (*c==',')
+			c++;
+		(*vals)[n++] = atoi(c);
+	}
+	return n;
+}
 
-    buffer = (double **)malloc(numnodes*sizeof( double *)); 
-    sumbuffered = (double *)malloc(numnodes*sizeof( double)); 
-    nonselectedqty = (double *)malloc(numnodes*sizeof(double));
-    
-    map = (int *)malloc(numnodes*sizeof(int));
-    for(i=0;i<numnodes;i++) {
-    	map[i]=-1;
-		// each buffer has exactly numselected entries plus one quantity originating from non-selected nodes   
-        buffer[i] = (double *)malloc((numselected)*sizeof(double));
-        for(j=0;j<numselected;j++)
-        	buffer[i][j] = 0.0;
-        sumbuffered[i]=0.0;
-        nonselectedqty[i] = 0.0;
-    }
-    
-    // map each node-id to a position in selectednodes or to -1 if it does not exist there
-	for(i=0; i<numselected; i++)
-    	map[selectednodes[i]]=i;    
-        	
-	for(i=0;i<numinter;i++)
-	{
-		if (inter[i].qty>=sumbuffered[inter[i].src]) {
-			// case 1: just transfer everything to dest
-			for(j=0;j<numselected;j++) {
-				buffer[inter[i].dest][j] += buffer[inter[i].src][j];
-				buffer[inter[i].src][j] = 0.0;
-			}
-			nonselectedqty[inter[i].dest] += nonselectedqty[inter[i].src];
-			nonselectedqty[inter[i].src] = 0.0;
-			qty = inter[i].qty-sumbuffered[inter[i].src];
-			if (qty>0) {
-				if (map[inter[i].src]!=-1) // inter[i].src in selected
-					buffer[inter[i].dest][map[inter[i].src]] += qty;
-				else
-					nonselectedqty[inter[i].dest] += qty;
-			}
-			sumbuffered[inter[i].src] = 0;
-			sumbuffered[inter[i].dest] += inter[i].qty;
-		}
-		else { //inter[i].qty < sumbuffered[inter[i].src]
-			for(j=0;j<numselected;j++)
-			{
-				qty = inter[i].qty*buffer[inter[i].src][j]/sumbuffered[inter[i].src];
-				buffer[inter[i].dest][j] += qty;
-				buffer[inter[i].src][j] -= qty;
+// fraction of the buffered quantity that engine s attributes to the right origin, according to the exact provenance
+double sweepAccuracy(struct Sweep *sw, struct ProvState *s)
+{
+	int v,j,n;
+	long long k;
+	double matched = 0;
+	double *qty; // exact provenance of the current vertex, by origin
+	struct BufItem *items;
+	
+	if (sw->exactqty<=0)
+		return 1.0;
+	qty = (double *)calloc(sw->numnodes,sizeof(double));
+	for(v=0;v<sw->numnodes;v++) {
+		for(k=sw->exactstart[v];k<sw->exactstart[v+1];k++)
+			if (sw->exact[k].origin>=0)
+				qty[sw->exact[k].origin] = sw->exact[k].qty;
+		n = provQuery(s,v,&items);
+		for(j=0;j<n;j++)
+			if (items[j].origin>=0 && items[j].origin<sw->numnodes && items[j].qty>0) { // items of origin -1 are unattributed
+				if (items[j].qty<qty[items[j].origin]) {
+					matched += items[j].qty;
+					qty[items[j].origin] -= items[j].qty;
+				}
+				else {
+					matched += qty[items[j].origin];
+					qty[items[j].origin] = 0;
+				}
 			}
-			qty = inter[i].qty*nonselectedqty[inter[i].src]/sumbuffered[inter[i].src];
-			nonselectedqty[inter[i].dest] += qty;
-			nonselectedqty[inter[i].src] -= qty;
-			
-			sumbuffered[inter[i].src] -= inter[i].qty;
-			sumbuffered[inter[i].dest] += inter[i].qty;
-		}
+		for(k=sw->exactstart[v];k<sw->exactstart[v+1];k++)
+			if (sw->exact[k].origin>=0)
+				qty[sw->exact[k].origin] = 0;
 	}
+	free(qty);
+	return matched/sw->exactqty;
+}
 
-	// correctness check to compare with noProv and see whether the final total quantities 
-	// at the buffers are the same
-	       
-	double sumqty =0;
-	for(i=0;i<numnodes;i++) {
-		for(j=0;j<numselected;j++)
-       		sumqty+=buffer[i][j];
-       	sumqty+=nonselectedqty[i];
-    }   	
-    printf("sumqty=%.2f\n",sumqty);
-
-	for(i=0;i<numnodes;i++) {
-		printf("Node %d: ",i);
-		for(j=0;j<numselected;j++)
-			printf("%.2f ",buffer[i][j]);
-		printf("\n");
-	}
-	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(buffer);
-	free(sumbuffered);
-	free(nonselectedqty);
-	free(map);
+void sweepTask(void *arg, int t)
+{
+	struct Sweep *sw = (struct Sweep *)arg;
+	struct SweepRun *r = &sw->runs[t];
+	struct ProvState *s;
+	struct timespec c0,c1;
 	
-    return 0;
+	s = provCreate(r->method, sw->numnodes, &r->params);
+	if (s==NULL) {
+		r->ret = -1;
+		return;
+	}
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&c0);
+	r->ret = provFeed(s, sw->inter, sw->numinter);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID,&c1);
+	r->cputime = poolElapsed(&c0,&c1);
+	provGetStats(s, &r->stats);
+	r->accuracy = sweepAccuracy(sw, s);
+	provDestroy(s);
 }
 
-
-// provenance proportional origin model
-// if transferred quantity is lower than buffered quantity 
-// then origins are picked proportionally
-// creation timestamps are ignored
-// assumes that vertices are partitioned to groups (clusters?)
-// measures provenance from each group 
-// map[i] = group id whereto vertex i is mapped
-int ProvProportionalGroup(struct Interaction *inter, int numinter, int numnodes, int *map, int numgroups)
+// runs ProvProportionalWindow for all window sizes of wlist and ProvProportionalBudget for all
+// pairs of budgets (blist) and reductions (rlist) with reduction < budget, over the same interactions
+// configurations run on a pool of numthreads threads; if maxmemory>0, configurations start only while the
+// estimated memory of the running ones stays within maxmemory bytes
+// prints a table with the runtime, memory, shrinks and accuracy of each configuration, compared to
+// the exact provenance of ProvProportional (101)
+int runSweep(struct Interaction *inter, int numinter, int numnodes, char *wlist, char *blist, char *rlist, int numthreads, long long maxmemory)
 {
-    int i,j,k;
-
-    double **buffer; // array of buffers, one for each group
-	double *sumbuffered; // total quantity buffered at node i  
+	int i,j,k,n;
+	int numw = 0, numb = 0, numr = 0;
+	int *w = NULL, *b = NULL, *r = NULL;
+	int numruns;
+	long long *cost;
+	struct Sweep sw;
+	struct SweepRun exactrun;
+	struct ProvState *s;
+	struct BufItem *items;
+	struct timespec t0,t1;
 	
-	double qty; 
-	    
-	int stop = 100<numnodes ? 100:numnodes;
-
-	//buffer[i][j] is the buffered qty at node i originating from group j	
-    buffer = (double **)malloc(numnodes*sizeof( double *)); 
-    //sumbuffered[i] is total qty buffered at node i
-    sumbuffered = (double *)malloc(numnodes*sizeof( double)); 
-    //nonselectedqty = (double *)malloc(numnodes*sizeof(double));
-    
-    for(i=0;i<numnodes;i++) {
-		// each buffer has exactly numgroups entries    
-        buffer[i] = (double *)malloc((numgroups)*sizeof(double));
-        for(j=0;j<numgroups;j++)
-        	buffer[i][j] = 0.0;
-        sumbuffered[i]=0.0;
-    }
-
-	for(i=0;i<numinter;i++)
-	{
-		if (inter[i].qty>=sumbuffered[inter[i].src]) {
-			// case 1: just transfer everything to dest
-			for(j=0;j<numgroups;j++) {
-				buffer[inter[i].dest][j] += buffer[inter[i].src][j];
-				buffer[inter[i].src][j] = 0.0;
-			}
-			qty = inter[i].qty-sumbuffered[inter[i].src];
-			if (qty>0)
-				buffer[inter[i].dest][map[inter[i].src]] += qty;
-			sumbuffered[inter[i].src] = 0;
-			sumbuffered[inter[i].dest] += inter[i].qty;
-		}
-		else { //inter[i].qty < sumbuffered[inter[i].src]
-			//proportional transfer case
-			for(j=0;j<numgroups;j++)
-			{
-				qty = inter[i].qty*buffer[inter[i].src][j]/sumbuffered[inter[i].src];
-				buffer[inter[i].dest][j] += qty;
-				buffer[inter[i].src][j] -= qty;
-			}
-			
-			sumbuffered[inter[i].src] -= inter[i].qty;
-			sumbuffered[inter[i].dest] += inter[i].qty;
+	if (wlist!=NULL)
+		numw = parseList(wlist,&w);
+	if (blist!=NULL || rlist!=NULL) {
+		if (blist==NULL || rlist==NULL) {
+			printf("ERROR: a budget sweep needs both --sweep-budget and --sweep-reduction\n");
+			return -1;
 		}
+		numb = parseList(blist,&b);
+		numr = parseList(rlist,&r);
 	}
-       
-	double sumqty =0;
-	for(i=0;i<numnodes;i++) {
-		for(j=0;j<numgroups;j++)
-       		sumqty+=buffer[i][j];
-    }   	
-    printf("sumqty=%.2f\n",sumqty);
 	
+	memset(&sw,0,sizeof(sw));
+	sw.inter = inter;
+	sw.numinter = numinter;
+	sw.numnodes = numnodes;
+	sw.runs = (struct SweepRun *)calloc(numw+numb*numr,sizeof(struct SweepRun));
+	cost = (long long *)calloc(numw+numb*numr,sizeof(long long));
 	
+	// exact provenance, kept for the accuracy of the configurations
+	memset(&exactrun,0,sizeof(exactrun));
+	exactrun.method = 101;
+	s = provCreate(101, numnodes, &exactrun.params);
+	clock_gettime(CLOCK_MONOTONIC,&t0);
+	if (s==NULL || provFeed(s, inter, numinter)==-1)
+		return -1;
+	clock_gettime(CLOCK_MONOTONIC,&t1);
+	exactrun.cputime = poolElapsed(&t0,&t1);
+	exactrun.accuracy = 1.0;
+	provGetStats(s, &exactrun.stats);
+	sw.exactstart = (long long *)malloc((numnodes+1)*sizeof(long long));
+	sw.exact = (struct BufItem *)malloc((exactrun.stats.numitems+1)*sizeof(struct BufItem));
+	sw.exactstart[0] = 0;
 	for(i=0;i<numnodes;i++) {
-		if (sumbuffered[i]>0) {
-			printf("%d: ",i);
-			for(j=0;j<numgroups;j++)
-				printf("%.2f ",buffer[i][j]);
-			printf("\n");
-		}
+		n = provQuery(s,i,&items);
+		sw.exactstart[i+1] = sw.exactstart[i];
+		for(j=0;j<n;j++)
+			if (items[j].qty!=0)
+				sw.exact[sw.exactstart[i+1]++] = items[j];
 	}
+	sw.exactqty = exactrun.stats.sumqty;
+	provDestroy(s);
 	
-	for(i=0;i<numnodes;i++)
-		free(buffer[i]);
-	free(buffer);
-	free(sumbuffered);
+	// configurations, with an estimate of their memory
+	numruns = 0;
+	for(i=0;i<numw;i++) {
+		sw.runs[numruns].method = 120;
+		sw.runs[numruns].params.W = w[i];
+		cost[numruns++] = 2*exactrun.stats.memory; // two window buffers, at most as large as the exact ones
+	}
+	for(i=0;i<numb;i++)
+		for(j=0;j<numr;j++)
+			if (r[j]<b[i]) {
+				sw.runs[numruns].method = 121;
+				sw.runs[numruns].params.budget = b[i];
+				sw.runs[numruns].params.reducedsize = r[j];
+				k = b[i]>r[j]+2 ? b[i] : r[j]+2;
+				cost[numruns++] = (long long)numnodes*k*2*sizeof(double); // items of (padded) origin and qty
+			}
 	
-    return 0;
+	printf("\nparameter sweep: %d configurations on %d threads\n",numruns,numthreads);
+	clock_gettime(CLOCK_MONOTONIC,&t0);
+	poolRun(numthreads, numruns, sweepTask, &sw, maxmemory>0 ? cost : NULL, maxmemory);
+	clock_gettime(CLOCK_MONOTONIC,&t1);
+	
+	printf("method\tW\tbudget\treduction\ttime(s)\tmemory(MB)\titems\tshrinks\taccuracy\n");
+	printf("101\t-\t-\t-\t%.3f\t%.2f\t%lld\t%lld\t%.4f\n",exactrun.cputime,exactrun.stats.memory/1048576.0,
+		exactrun.stats.numitems,exactrun.stats.numshrinks,exactrun.accuracy);
+	for(i=0;i<numruns;i++) {
+		if (sw.runs[i].ret==-1) {
+			printf("%d\tERROR\n",sw.runs[i].method);
+			continue;
+		}
+		if (sw.runs[i].method==120)
+			printf("120\t%d\t-\t-",sw.runs[i].params.W);
+		else
+			printf("121\t-\t%d\t%d",sw.runs[i].params.budget,sw.runs[i].params.reducedsize);
+		printf("\t%.3f\t%.2f\t%lld\t%lld\t%.4f\n",sw.runs[i].cputime,sw.runs[i].stats.memory/1048576.0,
+			sw.runs[i].stats.numitems,sw.runs[i].stats.numshrinks,sw.runs[i].accuracy);
+	}
+	printf("parameter sweep: Total time of execution (wall clock): %f seconds\n",poolElapsed(&t0,&t1));
+	
+	free(w);
+	free(b);
+	free(r);
+	free(cost);
+	free(sw.runs);
+	free(sw.exactstart);
+	free(sw.exact);
+	return 0;
 }
 
 int main(int argc, char **argv)
 {
-	int i,j,k;
-	int W; // window size
-	int budget, reduction; // for budgetProvProp
+	int opt;
+	int sweep; // set for a parameter sweep
 	FILE *f; // graph input file
 
     struct Interaction *inter = NULL;
 	int numnodes=0;
 	int numinter=0;
 	
-	int *selected = NULL;
-	int numselected;
+	struct ProvParams params; // parameters of the provenance model
+	struct ProvState *state; // engine of the provenance model
+	char *title; // name of the model printed when it starts
+	char *name; // name of the model reported with the execution time
+	char *savefile = NULL; // checkpoint written after processing the interactions
+	char *restorefile = NULL; // checkpoint the run is resumed from
+	char *snapdir = NULL; // directory of periodic snapshots
+	int snapevery = 0; // snapshot every snapevery interactions
+	double snapdt = 0; // snapshot whenever the timestamp enters a new period of length snapdt
+	int queryvertex = -1; // vertex of a point-in-time query
+	double querytime = 0; // time of a point-in-time query
+	int check = 0; // set to check the conservation of the quantities (see provCheck)
+	double dustabs = 0, dustrel = 0; // dust thresholds of models 101 and 120 (0: no pruning)
+	char *methodlist = NULL; // models run in a single pass (see runMethods)
+	char *sweepW = NULL; // window sizes of a parameter sweep (see runSweep)
+	char *sweepbudget = NULL; // budgets of a parameter sweep
+	char *sweepreduction = NULL; // reductions of a parameter sweep
+	int numthreads = poolNumCPUs(); // threads of a parameter sweep or a parallel replay
+	int numparts = 0; // parts of a parallel replay (see provFeedParallel; 0: sequential)
+	int components = 0; // set to run the connected components of the graph in parallel (see provFeedComponents)
+	long long maxmemory = 0; // memory bound of a parameter sweep (bytes, 0: no bound)
+	int reordercap = 0; // capacity of the reorder buffer (0: none, or 1 in streaming mode)
+	double lateness = RO_NOLATENESS; // delay after which the reorder buffer releases an interaction
+	int stream = 0; // set to feed the engine while reading the graph file
+	long long buffermemory = 0; // memory budget of the buffers of models 4 and 101 (bytes, 0: no budget)
+	char *spilldir = NULL; // directory of the spill file of the buffers
+	int coldafter = 0; // buffers of models 4 and 101 not used for this number of interactions are compressed (0: none)
+	double quantum = 0; // quantities of the compressed buffers are rounded to multiples of it (0: exact)
+	struct ReorderBuffer rb; // reorder buffer of the interactions read
+	struct Interaction *batch; // interactions of the next batch in streaming mode
+	int numbatch; // number of these interactions
+	struct GraphReader gr; // reader of the graph file
+	int ret;
+	struct OutOptions outopts = {NULL, NULL, OUT_TEXT, 0, 0};
+	struct OutWriter out; // output stage of the buffers
 	
     clock_t t;
     double time_taken;
     
-	int numgroups; // number of groups whereto vertices are assigned
-    int *map; //maps vertex-ids to groups (group-ids should be from 0 to numgroups-1)
+    static struct option longopts[] = {
+    	{"save", required_argument, NULL, 's'},
+    	{"restore", required_argument, NULL, 'r'},
+    	{"snapshot-dir", required_argument, NULL, 'd'},
+    	{"snapshot-every", required_argument, NULL, 'n'},
+    	{"snapshot-dt", required_argument, NULL, 'T'},
+    	{"query", required_argument, NULL, 'q'},
+    	{"at", required_argument, NULL, 't'},
+    	{"output", required_argument, NULL, 'o'},
+    	{"format", required_argument, NULL, 'f'},
+    	{"top", required_argument, NULL, 'N'},
+    	{"nonempty", no_argument, NULL, 'E'},
+    	{"vertices", required_argument, NULL, 'V'},
+    	{"methods", required_argument, NULL, 'm'},
+    	{"sweep-W", required_argument, NULL, 'w'},
+    	{"sweep-budget", required_argument, NULL, 'b'},
+    	{"sweep-reduction", required_argument, NULL, 'R'},
+    	{"threads", required_argument, NULL, 'j'},
+    	{"max-memory", required_argument, NULL, 'M'},
+    	{"check", no_argument, NULL, 'C'},
+    	{"dust", required_argument, NULL, 'D'},
+    	{"dust-rel", required_argument, NULL, 'F'},
+    	{"parallel", required_argument, NULL, 'P'},
+    	{"components", no_argument, NULL, 'K'},
+    	{"reorder", required_argument, NULL, 'O'},
+    	{"lateness", required_argument, NULL, 'L'},
+    	{"stream", no_argument, NULL, 'S'},
+    	{"buffer-memory", required_argument, NULL, 'B'},
+    	{"spill-dir", required_argument, NULL, 'G'},
+    	{"compress-after", required_argument, NULL, 'A'},
+    	{"compress-quantum", required_argument, NULL, 'Q'},
+    	{NULL, 0, NULL, 0}
+    };
     
-    if (argc < 3) {
+    while ((opt = getopt_long(argc, argv, "s:r:d:n:T:q:t:o:f:N:EV:m:w:b:R:j:M:CD:F:P:KO:L:SB:G:A:Q:", longopts, NULL)) != -1) {
+    	switch(opt) {
+    		case 's':
+    		savefile = optarg;
+    		break;
+    		case 'r':
+    		restorefile = optarg;
+    		break;
+    		case 'd':
+    		snapdir = optarg;
+    		break;
+    		case 'n':
+    		snapevery = atoi(optarg);
+    		break;
+    		case 'T':
+    		snapdt = atof(optarg);
+    		break;
+    		case 'q':
+    		queryvertex = atoi(optarg);
+    		break;
+    		case 't':
+    		querytime = atof(optarg);
+    		break;
+    		case 'o':
+    		outopts.file = optarg;
+    		break;
+    		case 'f':
+    		if (!strcmp(optarg,"text"))
+    			outopts.mode = OUT_TEXT;
+    		else if (!strcmp(optarg,"binary"))
+    			outopts.mode = OUT_BINARY;
+    		else if (!strcmp(optarg,"stats"))
+    			outopts.mode = OUT_STATS;
+    		else {
+    			printf("ERROR: unknown output format %s (text, binary or stats)\n",optarg);
+    			return -1;
+    		}
+    		break;
+    		case 'N':
+    		outopts.topn = atoi(optarg);
+    		break;
+    		case 'E':
+    		outopts.nonempty = 1;
+    		break;
+    		case 'V':
+    		outopts.vertexfile = optarg;
+    		break;
+    		case 'm':
+    		methodlist = optarg;
+    		break;
+    		case 'w':
+    		sweepW = optarg;
+    		break;
+    		case 'b':
+    		sweepbudget = optarg;
+    		break;
+    		case 'R':
+    		sweepreduction = optarg;
+    		break;
+    		case 'j':
+    		numthreads = atoi(optarg);
+    		break;
+    		case 'M':
+    		if (!readMegabytes(optarg, &maxmemory)) {
+    			printf("ERROR: --max-memory should be a positive number of megabytes, not %s\n",optarg);
+    			return -1;
+    		}
+    		break;
+    		case 'C':
+    		check = 1;
+    		break;
+    		case 'D':
+    		dustabs = atof(optarg);
+    		break;
+    		case 'F':
+    		dustrel = atof(optarg);
+    		break;
+    		case 'P':
+    		numparts = atoi(optarg);
+    		break;
+    		case 'K':
+    		components = 1;
+    		break;
+    		case 'O':
+    		reordercap = atoi(optarg);
+    		break;
+    		case 'L':
+    		lateness = atof(optarg);
+    		break;
+    		case 'S':
+    		stream = 1;
+    		break;
+    		case 'B':
+    		if (!readMegabytes(optarg, &buffermemory)) {
+    			printf("ERROR: --buffer-memory should be a positive number of megabytes, not %s\n",optarg);
+    			return -1;
+    		}
+    		break;
+    		case 'G':
+    		spilldir = optarg;
+    		break;
+    		case 'A':
+    		coldafter = atoi(optarg);
+    		break;
+    		case 'Q':
+    		quantum = atof(optarg);
+    		break;
+    		default:
+    		printf("arguments: [options] <graph file> <method> (method arguments)\n");
+    		printf("options:\n");
+    		printf("  --save <checkpoint file>, --restore <checkpoint file>\n");
+    		printf("  --snapshot-dir <dir> with --snapshot-every <interactions> and/or --snapshot-dt <time period>\n");
+    		printf("  --query <vertex> --at <time> [--snapshot-dir <dir>]\n");
+    		printf("  --output <file>, --format text|binary|stats, --top <n>, --nonempty, --vertices <vertex list file>\n");
+    		printf("  --methods <method>[:<arguments>],... runs several methods in a single pass (no <method> argument)\n");
+    		printf("  --sweep-W <W>,... and/or --sweep-budget <budget>,... --sweep-reduction <reduction>,...\n");
+    		printf("      compares the configurations to method 101 (no <method> argument), with --threads <n> --max-memory <MB>\n");
+    		printf("  --check compares the total quantity at each vertex with the model without provenance\n");
+    		printf("      (and, with --methods, the provenance of 101 and 102, if both are run)\n");
+    		printf("  --parallel <n> [--threads <n>] replays the graph in n parts in parallel: time segments (0) or slices of the groups (100, 111)\n");
+    		printf("  --components [--threads <n>] runs the connected components of the graph in parallel (all methods but 120)\n");
+    		printf("  --reorder <capacity> and/or --lateness <time> sort interactions that arrive out of order while reading,\n");
+    		printf("      dropping the ones older than an interaction already released\n");
+    		printf("  --stream feeds the engine while reading the graph file (- for stdin); out-of-order interactions are dropped without --reorder\n");
+    		printf("  --dust <qty> and/or --dust-rel <fraction of the quantity of a vertex> fold smaller items into origin -1 (101, 112, 120)\n");
+    		printf("  --buffer-memory <MB> [--spill-dir <dir>] keeps the buffers within a memory budget,\n");
+    		printf("      spilling the least recently used ones to a file (4, 101)\n");
+    		printf("  --compress-after <interactions> [--compress-quantum <qty>] compresses the buffers not used for that many\n");
+    		printf("      interactions, rounding their quantities to multiples of qty if given (4, 101)\n");
+    		return -1;
+    	}
+    }
+    if ((snapevery>0 || snapdt>0) && snapdir==NULL) {
+    	printf("ERROR: snapshots need a --snapshot-dir\n");
+    	return -1;
+    }
+    sweep = (sweepW!=NULL || sweepbudget!=NULL || sweepreduction!=NULL);
+    if ((methodlist!=NULL || sweep) && (savefile!=NULL || restorefile!=NULL || snapdir!=NULL || queryvertex>=0)) {
+    	printf("ERROR: --methods and sweeps cannot be combined with checkpoints, snapshots or queries\n");
+    	return -1;
+    }
+    if ((numparts>0 || components) && (methodlist!=NULL || sweep || snapdir!=NULL || queryvertex>=0)) {
+    	printf("ERROR: --parallel and --components cannot be combined with --methods, sweeps, snapshots or queries\n");
+    	return -1;
+    }
+    if (numparts>0 && components) {
+    	printf("ERROR: --parallel and --components cannot be combined\n");
+    	return -1;
+    }
+    if (stream && (methodlist!=NULL || sweep || numparts>0 || components || queryvertex>=0 || check)) {
+    	printf("ERROR: --stream does not keep the interactions, so it cannot be combined with --methods, sweeps, --parallel, --components, queries or --check\n");
+    	return -1;
+    }
+    if (reordercap<0 || (lateness<0 && lateness!=RO_NOLATENESS)) {
+    	printf("ERROR: the capacity of the reorder buffer and the lateness cannot be negative\n");
+    	return -1;
+    }
+    if (reordercap==0 && (lateness>=0 || stream))
+    	reordercap = lateness>=0 ? RO_CAPACITY : 1;
+    if (reordercap>0)
+    	roInit(&rb, reordercap, lateness);
+    if (coldafter<0 || quantum<0) {
+    	printf("ERROR: --compress-after and --compress-quantum cannot be negative\n");
+    	return -1;
+    }
+    if ((buffermemory>0 || coldafter>0) && (methodlist!=NULL || sweep || numparts>0 || components)) {
+    	printf("ERROR: --buffer-memory and --compress-after cannot be combined with --methods, sweeps, --parallel or --components\n");
+    	return -1;
+    }
+    if (quantum>0 && coldafter==0) {
+    	printf("ERROR: --compress-quantum needs --compress-after\n");
+    	return -1;
+    }
+    if (check && (restorefile!=NULL || queryvertex>=0 || sweep)) {
+    	printf("ERROR: --check needs all interactions of a run, so it cannot be combined with --restore, queries or sweeps\n");
+    	return -1;
+    }
+    // skip options, so that argv[1] is the graph file
+    argc -= optind-1;
+    argv += optind-1;
+    
+    if (argc < 3 && !((methodlist!=NULL || sweep) && argc==2)) {
     	//printf("arguments: <graph file> <k for topk origin provenance OR numgroups> <Window size (for sliding prov.)> <budget for BudgetProv> <reduction for BudgetProv>\n");
     	printf("arguments: <graph file> <method> (method arguments)\n");
     	return -1;
     }
     
-    f = fopen(argv[1],"r");
-
-	if ((readGraph(f, &inter, &numinter, &numnodes)))
-	{
-		printf("something went wrong while reading graph file\n");
+    f = strcmp(argv[1],"-") ? fopen(argv[1],"r") : stdin;
+    if (f==NULL) {
+    	printf("ERROR: cannot open graph file %s\n",argv[1]);
     	return -1;
     }
+
+	if (grOpen(&gr, f)==-1)
+		return -1;
+	if (stream) {
+		// only the header is read here; the interactions are read while the engine runs
+		numnodes = gr.numnodes;
+		printf("numnodes=%d\n",numnodes);
+		printf("numinter=%d\n",gr.numinter);
+		numinter = 0;
+	}
+	else {
+		if ((readGraph(&gr, &inter, &numinter, &numnodes, reordercap>0 ? &rb : NULL)))
+		{
+			printf("something went wrong while reading graph file\n");
+			return -1;
+		}
+		grClose(&gr);
+		if (f!=stdin)
+			fclose(f);
+	}
+    
+    if (methodlist!=NULL) {
+    	if (runMethods(methodlist, inter, numinter, numnodes, &outopts, check, dustabs, dustrel)==-1)
+    		return -1;
+    	free(inter);
+    	return 0;
+    }
+    if (sweep) {
+    	if (runSweep(inter, numinter, numnodes, sweepW, sweepbudget, sweepreduction, numthreads, maxmemory)==-1)
+    		return -1;
+    	free(inter);
+    	return 0;
+    }
     
     int method = atoi(argv[2]);
     
-    switch(method)
-    {
-    	case 0:
-    	printf("\nNoProvenance model starts\n"); 
-		t = clock(); 
-		if (noProvFromMem(inter, numinter, numnodes)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("NoProvenance: Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 1:
-		printf("\nProvOldestFirst (least recently born) model starts\n"); 
-		t = clock(); 
-		if (ProvOldestFirst(inter, numinter, numnodes)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvOldestFirst (least recently born): Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 2:
-		printf("\nProvNewestFirst (most recently born) model starts\n"); 
-		t = clock(); 
-		if (ProvNewestFirst(inter, numinter, numnodes)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvNewestFirst (most recently born): Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 3:
-		printf("\nProvLIFO model starts\n"); 
-		t = clock(); 
-		if (ProvLIFO(inter, numinter, numnodes)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvLIFO: Total time of execution: %f seconds\n", time_taken);
-		break;
-			
-		case 4:
-		printf("\nProvFIFO model starts\n"); 
-		t = clock(); 
-		if (ProvFIFO(inter, numinter, numnodes)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvFIFO: Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 31:
-		printf("\nProvLIFOPaths model starts\n"); 
-		t = clock(); 
-		if (ProvLIFOPaths(inter, numinter, numnodes)==-1)
+    if (setupMethod(method, argc-3, argv+3, inter, numinter, numnodes, &params, &title, &name)==-1)
+    	return -1;
+    params.dustabs = dustabs;
+    params.dustrel = dustrel;
+    params.memory = buffermemory;
+    params.spilldir = spilldir;
+    params.coldafter = coldafter;
+    params.quantum = quantum;
+    printf("\n%s model starts\n", title);
+    
+	t = clock(); 
+	if (restorefile!=NULL) {
+		// resume from checkpoint; the interactions of the graph file follow the checkpointed ones
+		state = provRestore(method, &params, restorefile);
+		if (state==NULL)
 			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvLIFOPaths: Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 100:
-		// use ProvProportionalGroup to simulate ProvPropDense
-		// if size of each group is one then each group is one vertex
-		printf("\nProvProportional model starts\n");
-		//initialize groups
-		map = (int *)malloc(numnodes*sizeof(int));	
-		numgroups = numnodes;
-		//assignment by a simple hash function (should be replaced by something else)
-		for(i=0;i<numnodes;i++)
-			map[i] = i % numgroups;
-		t = clock(); 
-		if (ProvProportionalGroup(inter, numinter, numnodes, map, numgroups)==-1)
+		if (numnodes > provNumNodes(state)) {
+			// vertices that appeared after the checkpoint start with empty buffers
+			printf("graph has %d vertices, checkpoint %s has %d\n",numnodes,restorefile,provNumNodes(state));
+			if (provGrow(state, numnodes)==-1)
+				return -1;
+		}
+		printf("resuming after %d interactions\n",provNumProcessed(state));
+	}
+	else {
+		state = provCreate(method, numnodes, &params);
+		if (state==NULL)
 			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvProportional: Total time of execution: %f seconds\n", time_taken);
-		free(map);
-		break;
-
-		case 101:
-		printf("\nProvProportional Sparse model starts\n"); 
-		t = clock(); 
-		if (ProvProportional(inter, numinter, numnodes)==-1)
+	}
+	freeParams(&params);
+	
+	if (openOutput(&out, &outopts, outopts.file, provNumNodes(state))==-1)
+		return -1;
+	
+	if (queryvertex>=0) {
+		// point-in-time query: only the buffer of the queried vertex is printed
+		if (provQueryAt(state, &out, inter, numinter, snapdir, queryvertex, querytime)==-1)
 			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvProportional Sparse: Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 110:
-		if (argc != 4) {
-			printf("arguments: <graph file> <method> <numselected>\n");
-    		return -1;
+	}
+	else {
+		if (stream) {
+			// batches of the interactions released by the reorder buffer
+			batch = (struct Interaction *)malloc(STREAM_BATCH*sizeof(struct Interaction));
+			numbatch = 0;
+			do {
+				ret = grNext(&gr, &batch[numbatch]);
+				if (ret==0 && roPush(&rb, &batch[numbatch])==-1)
+					return -1;
+				while (ret!=-1 && roPop(&rb, &batch[numbatch], ret==1)) {
+					if (++numbatch<STREAM_BATCH)
+						continue;
+					if ((snapevery>0 || snapdt>0) ? provFeedWithSnapshots(state, batch, numbatch, snapdir, snapevery, snapdt)==-1
+						: provFeed(state, batch, numbatch)==-1)
+						return -1;
+					numinter += numbatch;
+					numbatch = 0;
+				}
+			} while (ret==0);
+			if (ret==-1)
+				return -1;
+			if (numbatch>0 && ((snapevery>0 || snapdt>0) ? provFeedWithSnapshots(state, batch, numbatch, snapdir, snapevery, snapdt)==-1
+				: provFeed(state, batch, numbatch)==-1))
+				return -1;
+			numinter += numbatch;
+			free(batch);
+			grClose(&gr);
+			if (f!=stdin)
+				fclose(f);
+			roReport(&rb);
+			printf("streamed %d interactions\n",numinter);
 		}
-		numselected = atoi(argv[3]); // number of selected vertices
-		selected = (int *)malloc(numselected*sizeof(int));
-		for (i=0; i<numselected; i++) // first numselected vertices are selected
-			selected[i] = i;
-		printf("\nProvProportional Selective model starts\n"); 
-		t = clock(); 
-		if (ProvProportionalSel(inter, numinter, numnodes, selected, numselected)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvProportionalSel: Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		case 111:
-		printf("\nProvProportional Grouping model starts\n"); 
-		if (argc != 4) {
-			printf("arguments: <graph file> <method> <numgroups>\n");
-    		return -1;
+		else if (snapevery>0 || snapdt>0) {
+			if (provFeedWithSnapshots(state, inter, numinter, snapdir, snapevery, snapdt)==-1)
+				return -1;
 		}
-		numgroups = atoi(argv[3]); 
-		//initialize groups
-		map = (int *)malloc(numgroups*sizeof(int));	
-		//assignment by a simple hash function 
-		for(i=0;i<numnodes;i++)
-			map[i] = i % numgroups;
-		t = clock(); 
-		if (ProvProportionalGroup(inter, numinter, numnodes, map, numgroups)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvProportionalGroup: Total time of execution: %f seconds\n", time_taken);
-		free(map);
-		break;
-	
-		case 120:
-		if (argc != 4) {
-			printf("arguments: <graph file> <method> <W>\n");
-    		return -1;
+		else if (components) {
+			if (provFeedComponents(state, inter, numinter, numthreads)==-1)
+				return -1;
 		}
-		W = atoi(argv[3]); 
-		printf("\nProvProportional Window model starts\n"); 
-		t = clock(); 
-		if (ProvProportionalWindow(inter, numinter, numnodes,W)==-1)
-			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvProportionalWindow: Total time of execution: %f seconds\n", time_taken);
-		break;
-
-		case 121:
-		if (argc != 5) {
-			printf("arguments: <graph file> <method> <budget> <reduction>\n");
-    		return -1;
+		else if (numparts>0) {
+			if (provFeedParallel(state, inter, numinter, numparts, numthreads)==-1)
+				return -1;
 		}
-		budget = atoi(argv[3]); 
-		reduction = atoi(argv[4]); 
-		printf("\nProvProportional Budget model starts\n"); 
-		t = clock(); 
-		if (ProvProportionalBudget(inter, numinter, numnodes, budget, reduction)==-1)
+		else if (provFeed(state, inter, numinter)==-1)
 			return -1;
-		t = clock() - t;
-		time_taken = ((double)t)/CLOCKS_PER_SEC;
-		printf("ProvProportionalBudget: Total time of execution: %f seconds\n", time_taken);
-		break;
-		
-		default:
-		printf("Invalid method. Choices are:\n");
-		printf("0: no provenance\n");
-		printf("1: least recently born\n");
-		printf("2: most recently born\n");
-		printf("3: LIFO\n");
-		printf("4: FIFO\n");
-		printf("31: LIFO with path tracking\n");
-		printf("100: proportional (dense vectors)\n");
-		printf("101: proportional (sparse vectors)\n");
-		printf("110: proportional (from selected vertices)\n");
-		printf("111: proportional (from groups of vertices)\n");
-		printf("120: proportional (window-based)\n");
-		printf("121: proportional (budget-based)\n");
-    	return -1;
-    }
-    
+		provPrint(state, &out);
+	}
+	closeOutput(&out);
+	t = clock() - t;
+	time_taken = ((double)t)/CLOCKS_PER_SEC;
+	printf("%s: Total time of execution: %f seconds\n", name, time_taken);
+	if (check && provCheck(state, inter, numinter)==-1)
+		return -1;
+	
+	if (savefile!=NULL && provSnapshot(state, savefile)==-1)
+		return -1;
+	provDestroy(state);
 
 	if (inter!=NULL) 
 		free(inter);
-
-	if (selected!=NULL) 
-		free(selected);
+	if (reordercap>0)
+		roFree(&rb);
 
 	return 0;
 }
@@ -0,0 +1,330 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*output stage for the buffers of the provenance models*/
+/*used by provenance_tin.c*/
+/*text, binary or statistics-only output, optionally filtered*/
+/*everything is formatted into a large buffer, which is written with fwrite*/
+#include <string.h>
+#include <math.h>
+#include "provout.h"
+
+/*initializes writer w for output file f*/
+void provOutInit(struct OutWriter *w, FILE *f, int mode)
+{
+	memset(w,0,sizeof(struct OutWriter));
+	w->f = f;
+	w->mode = mode;
+	w->buf = (char *)malloc(OUT_BUFSIZE);
+}
+
+/*reads the vertices to be written (whitespace-separated vertex ids) from a text file*/
+int provOutLoadFilter(struct OutWriter *w, const char *filename, int numnodes)
+{
+	FILE *f;
+	int v;
+
+	f = fopen(filename,"r");
+	if (f==NULL) {
+		printf("ERROR: cannot open vertex list %s\n",filename);
+		return -1;
+	}
+	free(w->filter);
+	w->filter = (char *)calloc(numnodes,sizeof(char));
+	w->filtersize = numnodes;
+	while (fscanf(f,"%d",&v)==1)
+		if (v>=0 && v<numnodes)
+			w->filter[v] = 1;
+	fclose(f);
+	return 0;
+}
+
+/*returns 1 if vertex v with n buffered items is not to be written*/
+int outSkip(struct OutWriter *w, int v, int n)
+{
+	if (w->filter!=NULL && (v>=w->filtersize || !w->filter[v]))
+		return 1;
+	if (w->nonempty && n==0)
+		return 1;
+	return 0;
+}
+
+/*writes the contents of the output buffer to the file*/
+void outFlush(struct OutWriter *w)
+{
+	if (w->buflen) {
+		fwrite(w->buf,1,w->buflen,w->f);
+		w->buflen = 0;
+	}
+}
+
+/*makes room for n more bytes in the output buffer*/
+static void outReserve(struct OutWriter *w, int n)
+{
+	if (w->buflen+n > OUT_BUFSIZE)
+		outFlush(w);
+}
+
+void outText(struct OutWriter *w, const char *str)
+{
+	int len = strlen(str);
+
+	if (len > OUT_BUFSIZE/2) {
+		outFlush(w);
+		fwrite(str,1,len,w->f);
+		return;
+	}
+	outReserve(w,len);
+	memcpy(w->buf+w->buflen,str,len);
+	w->buflen += len;
+}
+
+void outInt(struct OutWriter *w, long long x)
+{
+	char digits[20];
+	int n = 0;
+	unsigned long long u;
+
+	outReserve(w,21);
+	if (x<0) {
+		w->buf[w->buflen++] = '-';
+		u = -(unsigned long long)x;
+	}
+	else
+		u = x;
+	do {
+		digits[n++] = '0'+u%10;
+		u /= 10;
+	} while (u);
+	while (n)
+		w->buf[w->buflen++] = digits[--n];
+}
+
+/*writes x with two decimals, exactly as printf("%.2f",x)*/
+void outQty(struct OutWriter *w, double x)
+{
+	double scaled, c;
+	long long cents;
+	char digits[24];
+	int n = 0;
+
+	outReserve(w,64);
+	scaled = fabs(x)*100.0;
+	c = nearbyint(scaled);
+	// values close to a rounding tie (or too large) are left to printf
+	if (!(scaled < 1e15) || fabs(fabs(scaled-c)-0.5) < 1e-6) {
+		w->buflen += snprintf(w->buf+w->buflen,64,"%.2f",x);
+		return;
+	}
+	if (signbit(x))
+		w->buf[w->buflen++] = '-';
+	cents = (long long)c;
+	digits[n++] = '0'+cents%10;
+	cents /= 10;
+	digits[n++] = '0'+cents%10;
+	cents /= 10;
+	digits[n++] = '.';
+	do {
+		digits[n++] = '0'+cents%10;
+		cents /= 10;
+	} while (cents);
+	while (n)
+		w->buf[w->buflen++] = digits[--n];
+}
+
+/*writes a buffered quantity: with two decimals, or in full with integer quantities (PROV_INTQTY)*/
+void outAmount(struct OutWriter *w, qty_t x)
+{
+#ifdef PROV_INTQTY
+	outInt(w,x);
+#else
+	outQty(w,x);
+#endif
+}
+
+/*appends raw bytes to the output buffer*/
+static void outBytes(struct OutWriter *w, const void *data, int n)
+{
+	outReserve(w,n);
+	memcpy(w->buf+w->buflen,data,n);
+	w->buflen += n;
+}
+
+static int cmpitembyqtydesc(const void *i1, const void *i2)
+{
+	struct BufItem *a = (struct BufItem *)i1;
+	struct BufItem *b = (struct BufItem *)i2;
+
+	if (a->qty < b->qty)
+		return 1;
+	else if (a->qty > b->qty)
+		return -1;
+	else
+		return a->origin - b->origin;
+}
+
+/*writes the n buffered items of vertex v*/
+/*for the dense styles, items[j] is the entry of origin (selected vertex or group) j*/
+/*binary record: int vertex, int number of items, then per item int origin, (double ts,) double qty*/
+/*(integer quantities are written as doubles too, exactly up to 2^53)*/
+/*the timestamp is written only for OUTSTYLE_TS and OUTSTYLE_SKETCH (where it is the error bound of qty)*/
+void outVertex(struct OutWriter *w, int v, struct BufItem *items, int n, int style)
+{
+	int j, numitems;
+	int dense = (style==OUTSTYLE_DENSE || style==OUTSTYLE_GROUP);
+	int hasts;
+	qty_t sumqty = 0;
+	double qty;
+
+	// number of items, not counting zero entries of dense buffers
+	numitems = n;
+	if (dense)
+		for(j=0;j<n;j++)
+			if (items[j].qty==0)
+				numitems--;
+	if (outSkip(w,v,numitems))
+		return;
+
+	// top-n origins, in decreasing order of quantity
+	if (w->topn>0 || (dense && w->mode==OUT_BINARY)) {
+		if (w->itemcapacity<numitems) {
+			w->itemcapacity = numitems;
+			w->items = (struct BufItem *)realloc(w->items,w->itemcapacity*sizeof(struct BufItem));
+		}
+		numitems = 0;
+		for(j=0;j<n;j++)
+			if (!dense || items[j].qty!=0)
+				w->items[numitems++] = items[j];
+		if (w->topn>0) {
+			qsort(w->items,numitems,sizeof(struct BufItem),cmpitembyqtydesc);
+			if (numitems>w->topn)
+				numitems = w->topn;
+		}
+		items = w->items;
+		n = numitems;
+		if (dense && style==OUTSTYLE_DENSE)
+			style = OUTSTYLE_NODE;
+		dense = 0;
+	}
+
+	w->numvertices++;
+	w->numitems += numitems;
+	for(j=0;j<n;j++)
+		sumqty += items[j].qty;
+	w->sumqty += sumqty;
+
+	if (w->mode==OUT_STATS)
+		return;
+
+	if (w->mode==OUT_BINARY) {
+		hasts = (style==OUTSTYLE_TS || style==OUTSTYLE_SKETCH);
+		if (!w->started) {
+			outBytes(w,OUT_MAGIC,4);
+			j = OUT_VERSION;
+			outBytes(w,&j,sizeof(int));
+			outBytes(w,&hasts,sizeof(int));
+			w->started = 1;
+		}
+		outBytes(w,&v,sizeof(int));
+		outBytes(w,&n,sizeof(int));
+		for(j=0;j<n;j++) {
+			outBytes(w,&items[j].origin,sizeof(int));
+			if (hasts)
+				outBytes(w,&items[j].ts,sizeof(double));
+			qty = items[j].qty;
+			outBytes(w,&qty,sizeof(double));
+		}
+		return;
+	}
+
+	switch(style)
+	{
+		case OUTSTYLE_SCALAR:
+		outText(w,"Buffer of vertex ");
+		outInt(w,v);
+		outText(w,": ");
+		outAmount(w,sumqty);
+		break;
+
+		case OUTSTYLE_TS:
+		case OUTSTYLE_BUF:
+		outText(w,"Buffer of vertex ");
+		outInt(w,v);
+		outText(w,": ");
+		for(j=0;j<n;j++) {
+			outText(w,"(o=");
+			outInt(w,items[j].origin);
+			if (style==OUTSTYLE_TS) {
+				outText(w,",ts=");
+				outQty(w,items[j].ts);
+			}
+			outText(w,",qty=");
+			outAmount(w,items[j].qty);
+			outText(w,") ");
+		}
+		break;
+
+		case OUTSTYLE_NODE:
+		case OUTSTYLE_DENSE:
+		case OUTSTYLE_GROUP:
+		case OUTSTYLE_SKETCH:
+		if (style==OUTSTYLE_GROUP) {
+			outInt(w,v);
+			outText(w,": ");
+		}
+		else {
+			outText(w,"Node ");
+			outInt(w,v);
+			outText(w,": ");
+		}
+		for(j=0;j<n;j++) {
+			if (dense) {
+				outAmount(w,items[j].qty);
+				outText(w," ");
+			}
+			else {
+				outText(w,"(origin: ");
+				outInt(w,items[j].origin);
+				outText(w,", qty: ");
+				outAmount(w,items[j].qty);
+				if (style==OUTSTYLE_SKETCH) {
+					outText(w,", err: ");
+					outQty(w,items[j].ts);
+				}
+				outText(w,") ");
+			}
+		}
+		break;
+	}
+	outText(w,"\n");
+}
+
+/*completes the output; in statistics mode, the statistics of the written buffers are printed*/
+void outEnd(struct OutWriter *w)
+{
+	int j,hasts = 0;
+
+	if (w->mode==OUT_BINARY && !w->started) {
+		outBytes(w,OUT_MAGIC,4);
+		j = OUT_VERSION;
+		outBytes(w,&j,sizeof(int));
+		outBytes(w,&hasts,sizeof(int));
+		w->started = 1;
+	}
+	outFlush(w);
+	if (w->mode==OUT_STATS) {
+		fprintf(w->f,"output vertices=%lld\n",w->numvertices);
+		fprintf(w->f,"output items=%lld\n",w->numitems);
+		fprintf(w->f,"output sumqty=%.2f\n",w->sumqty);
+	}
+	fflush(w->f);
+}
+
+void provOutFree(struct OutWriter *w)
+{
+	free(w->buf);
+	free(w->items);
+	free(w->filter);
+	w->buf = NULL;
+	w->items = NULL;
+	w->filter = NULL;
+}
@@ -0,0 +1,62 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __PROVOUT
+#define __PROVOUT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "minheap.h" // to obtain struct BufItem definition
+
+#define OUT_BUFSIZE (1<<20) // size of the output buffer
+
+// output modes
+#define OUT_TEXT 0 // text, in the format of each model
+#define OUT_BINARY 1 // binary records (see outVertex)
+#define OUT_STATS 2 // statistics only, no buffers
+
+// text formats of buffered items (one per model family)
+#define OUTSTYLE_SCALAR 0 // Buffer of vertex <v>: <qty>
+#define OUTSTYLE_TS 1 // Buffer of vertex <v>: (o=<origin>,ts=<ts>,qty=<qty>) ...
+#define OUTSTYLE_BUF 2 // Buffer of vertex <v>: (o=<origin>,qty=<qty>) ...
+#define OUTSTYLE_NODE 3 // Node <v>: (origin: <origin>, qty: <qty>) ...
+#define OUTSTYLE_DENSE 4 // Node <v>: <qty of entry 0> <qty of entry 1> ...
+#define OUTSTYLE_GROUP 5 // <v>: <qty of entry 0> <qty of entry 1> ...
+#define OUTSTYLE_SKETCH 6 // Node <v>: (origin: <origin>, qty: <qty>, err: <error bound>) ... (error bound in the ts field)
+
+#define OUT_MAGIC "PTBO" // first bytes of a binary output file
+#define OUT_VERSION 1
+
+// buffered writer for the provenance buffers of the vertices
+struct OutWriter {
+	FILE *f; // output file
+	int mode; // OUT_TEXT, OUT_BINARY or OUT_STATS
+	int nonempty; // if set, vertices with empty buffers are skipped
+	int topn; // if >0, only the topn origins with the largest quantity are written per vertex
+	char *filter; // if not NULL, only vertices v with filter[v]!=0 are written
+	int filtersize; // number of entries in filter
+	int started; // set once the binary header is written
+
+	char *buf; // output buffer
+	int buflen; // number of bytes in buf
+
+	struct BufItem *items; // scratch space for top-n selection
+	int itemcapacity;
+
+	long long numvertices; // number of vertices written
+	long long numitems; // number of buffered items written
+	double sumqty; // total quantity written
+};
+
+PROV_API void provOutInit(struct OutWriter *w, FILE *f, int mode);
+PROV_API int provOutLoadFilter(struct OutWriter *w, const char *filename, int numnodes);
+int outSkip(struct OutWriter *w, int v, int n);
+void outFlush(struct OutWriter *w);
+void outText(struct OutWriter *w, const char *str);
+void outInt(struct OutWriter *w, long long x);
+void outQty(struct OutWriter *w, double x);
+void outAmount(struct OutWriter *w, qty_t x);
+void outVertex(struct OutWriter *w, int v, struct BufItem *items, int n, int style);
+void outEnd(struct OutWriter *w);
+PROV_API void provOutFree(struct OutWriter *w);
+
+#endif // __PROVOUT
@@ -0,0 +1,92 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include "extsort.h"
+#include "threadpool.h"
+
+// sorts a graph file by timestamp, so that it can be given to provenance_tin
+// the file may be larger than the memory: sorted runs of it are written next to the output
+// (or to --tmpdir) and merged; text and binary graph files (see graphio.h) are read and written
+
+int main(int argc, char **argv)
+{
+	int opt;
+	long long memory = (long long)EXS_MEMORY*1048576; // memory budget (bytes)
+	int numthreads = poolNumCPUs(); // threads sorting the runs
+	int binary = -1; // form of the output (-1: as the input)
+	char *tmpdir = NULL; // directory of the runs
+	char *slash;
+	int ret;
+	struct timespec t0,t1;
+	
+	static struct option longopts[] = {
+		{"memory", required_argument, NULL, 'M'},
+		{"threads", required_argument, NULL, 'j'},
+		{"format", required_argument, NULL, 'f'},
+		{"tmpdir", required_argument, NULL, 'd'},
+		{NULL, 0, NULL, 0}
+	};
+	
+	while ((opt = getopt_long(argc, argv, "M:j:f:d:", longopts, NULL)) != -1) {
+		switch(opt) {
+			case 'M':
+			memory = atoll(optarg)*1048576;
+			break;
+			case 'j':
+			numthreads = atoi(optarg);
+			break;
+			case 'f':
+			if (!strcmp(optarg,"text"))
+				binary = 0;
+			else if (!strcmp(optarg,"binary"))
+				binary = 1;
+			else {
+				printf("ERROR: unknown graph format %s (text or binary)\n",optarg);
+				return -1;
+			}
+			break;
+			case 'd':
+			tmpdir = optarg;
+			break;
+			default:
+			printf("arguments: [options] <graph file (- for stdin)> <sorted graph file>\n");
+			printf("options:\n");
+			printf("  --memory <MB> (default %d), --threads <n>, --format text|binary (default: as the input), --tmpdir <dir of the runs>\n",EXS_MEMORY);
+			return -1;
+		}
+	}
+	if (argc-optind != 2) {
+		printf("arguments: [options] <graph file (- for stdin)> <sorted graph file>\n");
+		return -1;
+	}
+	if (memory<=0) {
+		printf("ERROR: the memory budget should be positive\n");
+		return -1;
+	}
+	if (tmpdir==NULL) {
+		// runs are written to the directory of the output
+		tmpdir = strdup(argv[optind+1]);
+		slash = strrchr(tmpdir,'/');
+		if (slash==NULL)
+			strcpy(tmpdir,".");
+		else if (slash==tmpdir)
+			slash[1] = '\0';
+		else
+			*slash = '\0';
+	}
+	else
+		tmpdir = strdup(tmpdir);
+	
+	clock_gettime(CLOCK_MONOTONIC,&t0);
+	ret = exsSort(argv[optind], argv[optind+1], binary, memory, numthreads, tmpdir);
+	clock_gettime(CLOCK_MONOTONIC,&t1);
+	free(tmpdir);
+	if (ret==-1)
+		return -1;
+	printf("provsort: Total time of execution (wall clock): %f seconds\n",poolElapsed(&t0,&t1));
+	return 0;
+}
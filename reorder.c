@@ -0,0 +1,112 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*bounded reorder buffer for interactions that arrive slightly out of time order*/
+/*used by provenance_tin.c to feed the engines in time order*/
+/*the heap grows by doubling, up to the capacity of the buffer*/
+#include <string.h>
+#include "reorder.h"
+
+void roInit(struct ReorderBuffer *rb, int capacity, double lateness)
+{
+	memset(rb,0,sizeof(struct ReorderBuffer));
+	rb->capacity = capacity>0 ? capacity : 1;
+	rb->lateness = lateness;
+}
+
+// returns 1 if item a is to be released before item b
+static inline int roBefore(const struct RoItem *a, const struct RoItem *b)
+{
+	if (a->x.ts!=b->x.ts)
+		return a->x.ts<b->x.ts;
+	return a->seq<b->seq;
+}
+
+int roPush(struct ReorderBuffer *rb, const struct Interaction *x)
+{
+	struct RoItem it, tmp;
+	int pos, p;
+
+	rb->numarrived++;
+	// disorder is counted over all arrivals, including the ones dropped below
+	if (rb->numarrived>1 && x->ts<rb->maxts) {
+		rb->numdisordered++;
+		if (rb->maxts-x->ts>rb->maxdelay)
+			rb->maxdelay = rb->maxts-x->ts;
+	}
+	if (rb->numarrived==1 || x->ts>rb->maxts)
+		rb->maxts = x->ts;
+	if (rb->released && x->ts<rb->watermark) {
+		rb->numlate++;
+		if (rb->numlate<=RO_MAXREPORTS)
+			printf("dropped late interaction %d: %d->%d at %.2f, below the watermark %.2f\n",
+				(int)(rb->numarrived-1),x->src,x->dest,x->ts,rb->watermark);
+		return 1;
+	}
+
+	if (rb->numitems==rb->capacity) {
+		printf("ERROR: reorder buffer is full\n"); // the due interactions were not taken with roPop
+		return -1;
+	}
+	if (rb->numitems==rb->allocated) {
+		rb->allocated = rb->allocated>0 ? 2*rb->allocated : 16;
+		if (rb->allocated>rb->capacity)
+			rb->allocated = rb->capacity;
+		rb->heap = (struct RoItem *)realloc(rb->heap,rb->allocated*sizeof(struct RoItem));
+	}
+	it.x = *x;
+	it.seq = rb->numarrived;
+	pos = rb->numitems++;
+	rb->heap[pos] = it;
+	while (pos>0) {
+		p = (pos-1)/2;
+		if (!roBefore(&rb->heap[pos],&rb->heap[p]))
+			break;
+		tmp = rb->heap[p];
+		rb->heap[p] = rb->heap[pos];
+		rb->heap[pos] = tmp;
+		pos = p;
+	}
+	return 0;
+}
+
+int roPop(struct ReorderBuffer *rb, struct Interaction *x, int flush)
+{
+	struct RoItem tmp;
+	int pos, c;
+
+	if (rb->numitems==0)
+		return 0;
+	if (!flush && rb->numitems<rb->capacity
+		&& (rb->lateness<0 || rb->heap[0].x.ts > rb->maxts-rb->lateness))
+		return 0;
+	*x = rb->heap[0].x;
+	rb->watermark = x->ts;
+	rb->released = 1;
+	rb->numreleased++;
+	rb->heap[0] = rb->heap[--rb->numitems];
+	pos = 0;
+	while ((c = 2*pos+1) < rb->numitems) {
+		if (c+1<rb->numitems && roBefore(&rb->heap[c+1],&rb->heap[c]))
+			c++;
+		if (!roBefore(&rb->heap[c],&rb->heap[pos]))
+			break;
+		tmp = rb->heap[c];
+		rb->heap[c] = rb->heap[pos];
+		rb->heap[pos] = tmp;
+		pos = c;
+	}
+	return 1;
+}
+
+void roReport(struct ReorderBuffer *rb)
+{
+	printf("reorder buffer: %lld interactions arrived, %lld out of order (up to %.2f late), %lld dropped as too late\n",
+		rb->numarrived,rb->numdisordered,rb->maxdelay,rb->numlate);
+}
+
+void roFree(struct ReorderBuffer *rb)
+{
+	free(rb->heap);
+	rb->heap = NULL;
+	rb->numitems = 0;
+}
@@ -0,0 +1,50 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __REORDER
+#define __REORDER
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "provenance.h" // to obtain struct Interaction definition
+
+#define RO_CAPACITY 1048576 // default capacity of a reorder buffer
+#define RO_NOLATENESS -1 // lateness of a buffer that releases interactions only when it is full
+#define RO_MAXREPORTS 10 // dropped interactions printed one by one
+
+// interaction waiting in a reorder buffer; seq is its arrival number, so that equal timestamps keep their order
+struct RoItem {
+	struct Interaction x;
+	long long seq;
+};
+
+// bounded reorder buffer: a min-heap on (ts, arrival) of at most capacity interactions
+// an interaction is released once the largest timestamp seen is at least lateness after its own, or
+// when the buffer is full; the watermark is the timestamp of the last released interaction, and an interaction
+// that arrives below it cannot be placed in order any more, so it is dropped as too late
+struct ReorderBuffer {
+	struct RoItem *heap;
+	int numitems;
+	int capacity;
+	int allocated; // allocated size of the heap
+	double lateness; // RO_NOLATENESS: released only when the buffer is full (or flushed)
+	double maxts; // largest timestamp seen
+	double watermark; // timestamp of the last released interaction
+	int released; // set once an interaction has been released
+	long long numarrived;
+	long long numreleased;
+	long long numdisordered; // interactions that arrived after one with a larger timestamp
+	long long numlate; // interactions dropped as too late
+	double maxdelay; // largest delay behind maxts of an interaction (dropped or not)
+};
+
+void roInit(struct ReorderBuffer *rb, int capacity, double lateness);
+// adds interaction x; returns 0, 1 if x is older than the watermark and is dropped, or -1 if the buffer is full
+// (the interactions due after each call must be taken with roPop, so that the buffer is never full at a call)
+int roPush(struct ReorderBuffer *rb, const struct Interaction *x);
+// moves the next interaction to *x if it is due (or, with flush set, if there is any); returns 1 if it did
+int roPop(struct ReorderBuffer *rb, struct Interaction *x, int flush);
+// prints the statistics of the buffer
+void roReport(struct ReorderBuffer *rb);
+void roFree(struct ReorderBuffer *rb);
+
+#endif // __REORDER
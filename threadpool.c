@@ -0,0 +1,106 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+/*fixed-size pool of threads running independent tasks*/
+/*used by provenance_tin.c for parameter sweeps, and by provenance.c for the parallel replay of a trace*/
+/*and for running the components of a trace in parallel*/
+/*the total cost (e.g., memory) of the running tasks can be bounded*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "threadpool.h"
+
+struct ThreadPool {
+	pthread_mutex_t lock;
+	pthread_cond_t done; // signaled whenever a task completes
+	int numtasks;
+	int next; // next task to start
+	int numrunning; // number of running tasks
+	long long runcost; // total cost of the running tasks
+	const long long *cost;
+	long long maxcost;
+	void (*task)(void *arg, int t);
+	void *arg;
+};
+
+static void *poolWorker(void *p)
+{
+	struct ThreadPool *pool = (struct ThreadPool *)p;
+	int t;
+	long long c;
+	
+	pthread_mutex_lock(&pool->lock);
+	while (pool->next<pool->numtasks) {
+		t = pool->next;
+		c = pool->cost!=NULL ? pool->cost[t] : 0;
+		if (pool->numrunning>0 && pool->runcost+c>pool->maxcost && pool->cost!=NULL) {
+			// wait until enough running tasks complete
+			pthread_cond_wait(&pool->done,&pool->lock);
+			continue;
+		}
+		pool->next++;
+		pool->numrunning++;
+		pool->runcost += c;
+		pthread_mutex_unlock(&pool->lock);
+		
+		pool->task(pool->arg,t);
+		
+		pthread_mutex_lock(&pool->lock);
+		pool->numrunning--;
+		pool->runcost -= c;
+		pthread_cond_broadcast(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+int poolRun(int numthreads, int numtasks, void (*task)(void *arg, int t), void *arg, const long long *cost, long long maxcost)
+{
+	int i;
+	pthread_t *threads;
+	struct ThreadPool pool;
+	
+	if (numthreads<1)
+		numthreads = 1;
+	if (numthreads>numtasks)
+		numthreads = numtasks;
+	
+	pthread_mutex_init(&pool.lock,NULL);
+	pthread_cond_init(&pool.done,NULL);
+	pool.numtasks = numtasks;
+	pool.next = 0;
+	pool.numrunning = 0;
+	pool.runcost = 0;
+	pool.cost = cost;
+	pool.maxcost = maxcost;
+	pool.task = task;
+	pool.arg = arg;
+	
+	threads = (pthread_t *)malloc(numthreads*sizeof(pthread_t));
+	for(i=0;i<numthreads;i++)
+		if (pthread_create(&threads[i],NULL,poolWorker,&pool)) {
+			printf("WARNING: cannot create thread, using %d threads\n",i);
+			break;
+		}
+	numthreads = i;
+	if (numthreads==0) // no thread could be created, run the tasks here
+		poolWorker(&pool);
+	for(i=0;i<numthreads;i++)
+		pthread_join(threads[i],NULL);
+	
+	free(threads);
+	pthread_mutex_destroy(&pool.lock);
+	pthread_cond_destroy(&pool.done);
+	return 0;
+}
+
+int poolNumCPUs()
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n>0 ? (int)n : 1;
+}
+
+double poolElapsed(struct timespec *t0, struct timespec *t1)
+{
+	return (t1->tv_sec-t0->tv_sec) + (t1->tv_nsec-t0->tv_nsec)/1e9;
+}
@@ -0,0 +1,17 @@
+/*Chrysanthi Kosyfaki, University of Ioannina, PhD Candidate */
+
+#ifndef __THREADPOOL
+#define __THREADPOOL
+
+#include <time.h>
+
+// runs task(arg,t) for t=0..numtasks-1 on numthreads threads; tasks are started in increasing order of t
+// if cost is not NULL, task t starts only when the total cost of the running tasks plus cost[t] is at most maxcost
+// (a task whose cost exceeds maxcost runs alone)
+int poolRun(int numthreads, int numtasks, void (*task)(void *arg, int t), void *arg, const long long *cost, long long maxcost);
+// number of available processors
+int poolNumCPUs();
+// seconds from t0 to t1
+double poolElapsed(struct timespec *t0, struct timespec *t1);
+
+#endif // __THREADPOOL